@@ -0,0 +1,49 @@
+// A FETCH stage which has fetched enough documents starts fetching them in batches, in RecordId
+// order. Check that documents still come back in index order, and that filters and limits still
+// apply, when the index order is unrelated to the order the documents were inserted in.
+// The deletes in the middle of the query must not race with results buffered by mongoS.
+// @tags: [
+//   assumes_unsharded_collection,
+//   requires_getmore,
+// ]
+
+(function() {
+"use strict";
+
+const coll = db.fetch_batch;
+coll.drop();
+assert.commandWorked(coll.createIndex({a: 1}));
+
+const nDocs = 5000;
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < nDocs; i++) {
+    // 'a' visits every value below nDocs, in an order unrelated to insertion order.
+    bulk.insert({_id: i, a: (i * 7919) % nDocs, b: i % 3});
+}
+assert.commandWorked(bulk.execute());
+
+function assertSameResults(query, limit) {
+    const expected = coll.find(query).hint({$natural: 1}).toArray().sort((x, y) => x.a - y.a);
+    let cursor = coll.find(query).sort({a: 1}).hint({a: 1});
+    if (limit) {
+        cursor = cursor.limit(limit);
+    }
+    assert.eq(limit ? expected.slice(0, limit) : expected, cursor.toArray());
+}
+
+assertSameResults({a: {$gte: 0}});
+assertSameResults({a: {$gte: 100}, b: 1});
+assertSameResults({a: {$gte: 0}}, 2500);
+assertSameResults({a: {$lt: 3000}, b: {$ne: 2}}, 1500);
+
+// Documents deleted after the query has started are not returned.
+const cursor = coll.find({a: {$gte: 0}}).sort({a: 1}).hint({a: 1}).batchSize(1200);
+const firstBatch = [];
+for (let i = 0; i < 1200; i++) {
+    firstBatch.push(cursor.next());
+}
+assert.commandWorked(coll.deleteMany({a: {$gte: 4000}}));
+const rest = cursor.toArray();
+assert.eq(1200 + 2800, firstBatch.length + rest.length);
+rest.forEach(doc => assert.lt(doc.a, 4000));
+})();
@@ -0,0 +1,80 @@
+// When both the sort pattern and the residual filter of a limited sort can be answered from the
+// index keys, the planner should sort the index keys and fetch only the documents which survive
+// the limit.
+
+// The limit is applied again on mongoS, and the number of documents examined is summed across
+// shards, so this test doesn't make sense on a sharded collection.
+// @tags: [
+//   assumes_unsharded_collection,
+//   sbe_incompatible,
+// ]
+
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");
+
+const coll = db.sort_limit_fetch_after_sort;
+
+coll.drop();
+const testIndex = {
+    a: 1,
+    b: 1,
+    c: 1
+};
+assert.commandWorked(coll.createIndex(testIndex));
+
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 5000; i++) {
+    // Make 'c' an array so that the index is multikey, while 'a' and 'b' are not.
+    bulk.insert({a: i % 10, b: i, c: [i % 3, i % 5], d: "x".repeat(100)});
+}
+assert.commandWorked(bulk.execute());
+
+function assertSameResults(query, sort, limit) {
+    const expected = coll.find(query).sort(sort).limit(limit).hint({$natural: 1}).toArray();
+    const actual = coll.find(query).sort(sort).limit(limit).hint(testIndex).toArray();
+    assert.eq(expected, actual);
+}
+
+// The predicate on 'b' cannot be used to build bounds, so the whole index is scanned. The filter
+// and sort only refer to 'b', so only the ten documents returned need to be fetched.
+let explainResult = coll.find({b: {$gte: 1000}})
+                        .sort({b: -1})
+                        .limit(10)
+                        .hint(testIndex)
+                        .explain("executionStats");
+assert.eq(explainResult.executionStats.nReturned, 10);
+assert.eq(explainResult.executionStats.totalDocsExamined, 10);
+assertSameResults({b: {$gte: 1000}}, {b: -1}, 10);
+
+// The index is multikey, but only on 'c', so the inexact predicate on 'b' can still be covered.
+explainResult = coll.find({a: {$gt: 5}, b: {$mod: [7, 0]}})
+                    .sort({b: 1})
+                    .limit(5)
+                    .hint(testIndex)
+                    .explain("executionStats");
+assert.eq(explainResult.executionStats.nReturned, 5);
+assert.eq(explainResult.executionStats.totalDocsExamined, 5);
+assertSameResults({a: {$gt: 5}, b: {$mod: [7, 0]}}, {b: 1}, 5);
+
+// A filter on the multikey field 'c' must be evaluated against the full documents before sorting.
+explainResult = coll.find({c: {$gte: 4}})
+                    .sort({b: 1})
+                    .limit(5)
+                    .hint(testIndex)
+                    .explain("executionStats");
+assert.eq(explainResult.executionStats.nReturned, 5);
+assert.gt(explainResult.executionStats.totalDocsExamined, 5);
+assertSameResults({c: {$gte: 4}}, {b: 1}, 5);
+
+// A sort on a field that is not in the index requires every matching document to be fetched.
+explainResult = coll.find({b: {$gte: 1000}})
+                    .sort({d: 1, b: 1})
+                    .limit(10)
+                    .hint(testIndex)
+                    .explain("executionStats");
+assert.eq(explainResult.executionStats.nReturned, 10);
+assert.gte(explainResult.executionStats.totalDocsExamined, 4000);
+assertSameResults({b: {$gte: 1000}}, {d: 1, b: 1}, 10);
+})();
@@ -0,0 +1,38 @@
+/**
+ * Tests index builds which generate keys on several threads while the collection is scanned.
+ *
+ * @tags: [requires_fcv_49]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({setParameter: {indexBuildKeyGenerationThreads: 8}});
+assert.neq(null, conn, "mongod was unable to start up");
+
+const testDB = conn.getDB(jsTestName());
+const coll = testDB.coll;
+
+const numDocs = 20000;
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numDocs; ++i) {
+    bulk.insert({_id: i, a: [i, i + numDocs], b: i % 100, c: "x".repeat(i % 50)});
+}
+assert.commandWorked(bulk.execute());
+
+assert.commandWorked(coll.createIndexes([{a: 1, b: 1}, {c: 1, _id: -1}, {b: 1}]));
+
+const validateRes = assert.commandWorked(coll.validate({full: true}));
+assert(validateRes.valid, validateRes);
+assert.eq(2 * numDocs, validateRes.keysPerIndex.a_1_b_1, validateRes);
+assert.eq(numDocs, validateRes.keysPerIndex["c_1__id_-1"], validateRes);
+
+assert.eq(numDocs / 100, coll.find({b: 42}).hint({b: 1}).itcount());
+assert.eq(1, coll.find({a: numDocs + 7}).hint({a: 1, b: 1}).itcount());
+
+// Duplicate keys found by different threads are still detected.
+assert.commandFailedWithCode(coll.createIndex({b: 1, c: 1}, {unique: true}),
+                             ErrorCodes.DuplicateKey);
+assert.commandWorked(coll.createIndex({a: 1}, {unique: true}));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,73 @@
+/**
+ * Tests that index scans which hand the ranges of their bounds to the index cursor as a single
+ * batch of seeks return the same results, and examine the same number of keys, as scans driven by
+ * the bounds checker.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+const db = conn.getDB("test");
+const coll = db.index_scan_batched_seeks;
+coll.drop();
+
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 2000; ++i) {
+    bulk.insert({a: i % 500, b: i % 7, c: [i % 3, i % 11]});
+}
+assert.commandWorked(bulk.execute());
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.createIndex({a: -1, b: 1}));
+assert.commandWorked(coll.createIndex({c: 1, a: 1}));
+
+let inList = [];
+for (let i = -5; i < 600; i += 3) {
+    inList.push(i);
+}
+
+const queries = [
+    {query: {a: {$in: inList}}, sort: {a: 1}, hint: {a: 1}},
+    {query: {a: {$in: inList}}, sort: {a: -1}, hint: {a: 1}},
+    {query: {a: {$in: inList}, b: {$gte: 3}}, sort: {a: 1}, hint: {a: -1, b: 1}},
+    {query: {a: {$in: inList}, b: 4}, sort: {a: -1, b: 1}, hint: {a: -1, b: 1}},
+    {
+        query: {$or: [{a: {$lt: 10}}, {a: {$gt: 100, $lte: 120}}, {a: 499}]},
+        sort: {a: 1},
+        hint: {a: 1}
+    },
+    {query: {c: {$in: [0, 2, 7, 10]}}, sort: {_id: 1}, hint: {c: 1, a: 1}},
+];
+
+function runQueries() {
+    return queries.map(({query, sort, hint}) => {
+        const explain =
+            coll.find(query, {_id: 0}).sort(sort).hint(hint).explain("executionStats");
+        return {
+            docs: coll.find(query, {_id: 0}).sort(sort).hint(hint).toArray(),
+            keysExamined: explain.executionStats.totalKeysExamined
+        };
+    });
+}
+
+function setBatchedSeeks(enabled) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryEnableBatchedIndexSeeks: enabled}));
+}
+
+setBatchedSeeks(false);
+const expected = runQueries();
+
+setBatchedSeeks(true);
+const actual = runQueries();
+
+// Batching doesn't change the results, nor the number of keys examined.
+for (let i = 0; i < queries.length; ++i) {
+    assert.eq(expected[i], actual[i], tojson(queries[i]));
+}
+
+// Every matching key is examined, as is the first key past the end of each range.
+const explain = coll.find({a: {$in: [1, 2, 3, 1000]}}).hint({a: 1}).explain("executionStats");
+assert.eq(13, explain.executionStats.totalKeysExamined, tojson(explain));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,64 @@
+/**
+ * Tests that with 'profilerAsyncWrites' enabled, profiler entries are written to system.profile by
+ * a background thread, and that entries which do not fit in the buffer are dropped and counted.
+ *
+ * @tags: [requires_profiling]
+ */
+(function() {
+"use strict";
+
+function getAsyncWriteMetrics(db) {
+    return db.serverStatus().metrics.profiler.asyncWrites;
+}
+
+let conn = MongoRunner.runMongod({setParameter: {profilerAsyncWrites: true}});
+assert.neq(null, conn, "mongod was unable to start up");
+
+let testDB = conn.getDB(jsTestName());
+assert.commandWorked(testDB.setProfilingLevel(2));
+
+const numOps = 50;
+for (let i = 0; i < numOps; ++i) {
+    assert.commandWorked(testDB.coll.insert({_id: i}));
+    assert.eq(1, testDB.coll.find({_id: i}).itcount());
+}
+
+// Every insert and find is eventually written to the profile collection.
+assert.soon(() => testDB.system.profile.find({ns: testDB.coll.getFullName(), op: "insert"})
+                      .itcount() === numOps);
+assert.soon(() => testDB.system.profile.find({ns: testDB.coll.getFullName(), op: "query"})
+                      .itcount() === numOps);
+
+let metrics = getAsyncWriteMetrics(testDB);
+assert.gte(metrics.queued, 2 * numOps, metrics);
+assert.gte(metrics.written, 2 * numOps, metrics);
+assert.gte(metrics.batches, 1, metrics);
+assert.eq(0, metrics.dropped, metrics);
+assert.eq(0, metrics.failed, metrics);
+
+// Switching back to synchronous writes makes entries visible as soon as the operation returns.
+assert.commandWorked(testDB.adminCommand({setParameter: 1, profilerAsyncWrites: false}));
+assert.commandWorked(testDB.coll.insert({_id: "sync"}));
+assert.eq(numOps + 1,
+          testDB.system.profile.find({ns: testDB.coll.getFullName(), op: "insert"}).itcount());
+
+MongoRunner.stopMongod(conn);
+
+// A buffer too small to hold any entry drops everything that is profiled.
+conn = MongoRunner.runMongod(
+    {setParameter: {profilerAsyncWrites: true, profilerAsyncWriteBufferSizeBytes: 1}});
+assert.neq(null, conn, "mongod was unable to start up");
+
+testDB = conn.getDB(jsTestName());
+assert.commandWorked(testDB.setProfilingLevel(2));
+for (let i = 0; i < 10; ++i) {
+    assert.commandWorked(testDB.coll.insert({_id: i}));
+}
+
+metrics = getAsyncWriteMetrics(testDB);
+assert.gte(metrics.dropped, 10, metrics);
+assert.eq(0, metrics.written, metrics);
+assert.eq(0, testDB.system.profile.find({op: "insert"}).itcount());
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,85 @@
+/**
+ * Tests that the $queryShapeStats stage reports per-shape execution statistics, and that getMores
+ * are attributed to the shape of the command which opened the cursor.
+ *
+ * @tags: [
+ *   requires_fcv_49,
+ *   sbe_incompatible,
+ * ]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+
+const testDB = conn.getDB(jsTestName());
+const adminDB = conn.getDB("admin");
+const coll = testDB.coll;
+
+assert.commandWorked(coll.insert(Array.from({length: 20}, (_, i) => ({_id: i, a: i, b: i % 2}))));
+
+function getShapeStats(ns) {
+    return adminDB.aggregate([{$queryShapeStats: {}}, {$match: {ns: ns}}]).toArray();
+}
+
+function getQueryHash(query) {
+    return coll.find(query).explain().queryPlanner.queryHash;
+}
+
+// Run two executions of one shape, each fetching its results with two getMores.
+for (let i = 0; i < 2; ++i) {
+    assert.eq(20, coll.find({a: {$gte: i}}).batchSize(8).itcount() + i);
+}
+// And a single execution of a second shape which fits in the first batch.
+assert.eq(10, coll.find({b: 1}).itcount());
+
+let stats = getShapeStats(coll.getFullName());
+assert.eq(2, stats.length, stats);
+
+const rangeStats = stats.find((entry) => entry.queryHash === getQueryHash({a: {$gte: 0}}));
+assert(rangeStats, stats);
+assert.eq(2, rangeStats.execCount, rangeStats);
+assert.eq(4, rangeStats.getMoreCount, rangeStats);
+assert.eq(39, rangeStats.nreturned, rangeStats);
+assert.eq(40, rangeStats.docsExamined, rangeStats);
+assert.eq(coll.getName(), rangeStats.representativeCommand.find, rangeStats);
+assert.gte(rangeStats.latency.totalMicros, rangeStats.latency.maxMicros, rangeStats);
+assert.eq(6,
+          rangeStats.latency.histogram.reduce((total, bucket) => total + bucket.count, 0),
+          rangeStats);
+
+const equalityStats = stats.find((entry) => entry.queryHash === getQueryHash({b: 1}));
+assert(equalityStats, stats);
+assert.eq(1, equalityStats.execCount, equalityStats);
+assert.eq(0, equalityStats.getMoreCount, equalityStats);
+assert.eq(10, equalityStats.nreturned, equalityStats);
+
+// The stage only accepts an empty specification.
+assert.commandFailedWithCode(
+    adminDB.runCommand({aggregate: 1, pipeline: [{$queryShapeStats: {foo: 1}}], cursor: {}}),
+    ErrorCodes.FailedToParse);
+
+// Setting the capacity to zero stops further executions from being recorded.
+assert.commandWorked(adminDB.runCommand({setParameter: 1, internalQueryShapeStatsCapacity: 0}));
+assert.eq(10, coll.find({b: 1}).itcount());
+stats = getShapeStats(coll.getFullName());
+assert.eq(1, stats.find((entry) => entry.queryHash === getQueryHash({b: 1})).execCount, stats);
+
+// Profiled and slow-logged getMores report the query hash and plan cache key of the command which
+// opened the cursor.
+assert.commandWorked(testDB.setProfilingLevel(2, {slowms: 0}));
+assert.eq(20, coll.find({a: {$gte: 0}}).batchSize(8).itcount());
+assert.commandWorked(testDB.setProfilingLevel(0));
+const findProfile =
+    testDB.system.profile.find({op: "query", ns: coll.getFullName()}).sort({$natural: -1}).next();
+const getMoreProfiles =
+    testDB.system.profile.find({op: "getmore", ns: coll.getFullName()}).toArray();
+assert.eq(2, getMoreProfiles.length, getMoreProfiles);
+for (let getMoreProfile of getMoreProfiles) {
+    assert.eq(findProfile.queryHash, getMoreProfile.queryHash, getMoreProfile);
+    assert.eq(findProfile.planCacheKey, getMoreProfile.planCacheKey, getMoreProfile);
+}
+
+MongoRunner.stopMongod(conn);
+})();
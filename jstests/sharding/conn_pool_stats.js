@@ -29,5 +29,32 @@ if (post32) {
                stats["totalCreated"],
                tojson(stats));
 }
+
+// Run a query through mongos so that the shard has served remote commands and pooled connections.
+assert.commandWorked(cluster.s.getDB("test").runCommand({find: "coll", filter: {}}));
+stats = assert.commandWorked(cluster.s.getDB("admin").runCommand({connPoolStats: 1}));
+printjson(stats);
+
+// Each host reports its pool's target size and how long requests waited for a connection.
+for (let host in stats["hosts"]) {
+    const hostStats = stats["hosts"][host];
+    assert("target" in hostStats, tojson(hostStats));
+    assert("queueDelayMicros" in hostStats, tojson(hostStats));
+    assert.gte(hostStats["queueDelayMicros"], 0, tojson(hostStats));
+}
+
+// Remote command latencies are tracked for the hosts mongos has sent commands to.
+assert("hostLatencyMillis" in stats);
+assert.gt(Object.keys(stats["hostLatencyMillis"]).length, 0, tojson(stats));
+for (let host in stats["hostLatencyMillis"]) {
+    assert.gte(stats["hostLatencyMillis"][host], 0, tojson(stats));
+}
+
+// Adaptive pool sizing can be enabled at runtime.
+assert.commandWorked(cluster.s.adminCommand(
+    {setParameter: 1, ShardingTaskExecutorPoolTargetQueueDelayMS: 10}));
+assert.commandFailed(cluster.s.adminCommand(
+    {setParameter: 1, ShardingTaskExecutorPoolTargetQueueDelayMS: -1}));
+
 cluster.stop();
 })();
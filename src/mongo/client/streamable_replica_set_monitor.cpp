@@ -40,10 +40,12 @@
 #include "mongo/client/connpool.h"
 #include "mongo/client/global_conn_pool.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/client/replica_set_monitor_server_parameters_gen.h"
 #include "mongo/client/streamable_replica_set_monitor_query_processor.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/server_options.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/executor/thread_pool_task_executor.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/atomic_word.h"
@@ -221,6 +223,10 @@ void StreamableReplicaSetMonitor::drop() {
             lock, Status{ErrorCodes::ShutdownInProgress, "the ReplicaSetMonitor is shutting down"});
     }
 
+    for (const auto& server : _currentTopology()->getServers()) {
+        executor::HostLatencyTracker::get().removeHost(server->getAddress());
+    }
+
     LOGV2(4333209,
           "Closing Replica Set Monitor {replicaSet}",
           "Closing Replica Set Monitor",
@@ -242,11 +248,39 @@ SemiFuture<HostAndPort> StreamableReplicaSetMonitor::getHostOrRefresh(
         .thenRunOn(_executor)
         .then([self = shared_from_this()](const std::vector<HostAndPort>& result) {
             invariant(result.size());
-            return result[self->_random.nextInt64(result.size())];
+            return selectHost(result, self->_random, executor::HostLatencyTracker::get());
         })
         .semi();
 }
 
+HostAndPort StreamableReplicaSetMonitor::selectHost(
+    const std::vector<HostAndPort>& hosts,
+    PseudoRandom& random,
+    const executor::HostLatencyTracker& latencyTracker) {
+    const auto first = random.nextInt64(hosts.size());
+    if (hosts.size() == 1 || !gReplicaSetMonitorLatencyAwareHostSelection.load()) {
+        return hosts[first];
+    }
+
+    // A host without a current latency is kept whenever it is picked first, so that a host which
+    // lost every comparison until its latency expired gets sampled again. It doesn't win when
+    // picked second, which would herd requests onto it until its first command completes.
+    const auto firstLatency = latencyTracker.getLatency(hosts[first]);
+    if (!firstLatency) {
+        return hosts[first];
+    }
+
+    auto second = random.nextInt64(hosts.size() - 1);
+    if (second >= first) {
+        ++second;
+    }
+    const auto secondLatency = latencyTracker.getLatency(hosts[second]);
+    if (secondLatency && *secondLatency < *firstLatency) {
+        return hosts[second];
+    }
+    return hosts[first];
+}
+
 std::vector<HostAndPort> StreamableReplicaSetMonitor::_extractHosts(
     const std::vector<ServerDescriptionPtr>& serverDescriptions) {
     std::vector<HostAndPort> result;
@@ -592,6 +626,14 @@ void StreamableReplicaSetMonitor::onTopologyDescriptionChangedEvent(
     if (_isDropped.load())
         return;
 
+    // Latencies of hosts which left the replica set would otherwise be kept forever.
+    for (const auto& server : previousDescription->getServers()) {
+        const auto& address = server->getAddress();
+        if (!newDescription->findServerByAddress(address)) {
+            executor::HostLatencyTracker::get().removeHost(address);
+        }
+    }
+
     // Notify external components if there are membership changes in the topology.
     if (_hasMembershipChange(previousDescription, newDescription)) {
         LOGV2(4333213,
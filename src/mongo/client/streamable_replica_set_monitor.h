@@ -53,11 +53,16 @@
 namespace mongo {
 
 class BSONObj;
+class PseudoRandom;
 class ReplicaSetMonitor;
 class ReplicaSetMonitorTest;
 struct ReadPreferenceSetting;
 using ReplicaSetMonitorPtr = std::shared_ptr<ReplicaSetMonitor>;
 
+namespace executor {
+class HostLatencyTracker;
+}  // namespace executor
+
 /**
  * Replica set monitor implementation backed by the classes in the mongo::sdam namespace.
  *
@@ -128,6 +133,17 @@ public:
     bool isKnownToHaveGoodPrimary() const;
     void runScanForMockReplicaSet() override;
 
+    /**
+     * Picks one of 'hosts' at random and, if 'latencyTracker' shows that commands have recently
+     * completed faster on another host picked at random, that one instead. Comparing only two hosts
+     * keeps requests spread across all of them, rather than herding every request onto whichever
+     * host is momentarily fastest. A host without a latency in 'latencyTracker', e.g. because it
+     * has expired, is kept whenever it is picked first, so that it gets sampled again.
+     */
+    static HostAndPort selectHost(const std::vector<HostAndPort>& hosts,
+                                  PseudoRandom& random,
+                                  const executor::HostLatencyTracker& latencyTracker);
+
 private:
     class StreamableReplicaSetMonitorQueryProcessor;
     using StreamableReplicaSetMontiorQueryProcessorPtr =
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <vector>
+
+#include "mongo/client/replica_set_monitor_server_parameters_gen.h"
+#include "mongo/client/streamable_replica_set_monitor.h"
+#include "mongo/executor/host_latency_tracker.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+using executor::HostLatencyTracker;
+
+const HostAndPort kHostA("a", 27017);
+const HostAndPort kHostB("b", 27017);
+const HostAndPort kHostC("c", 27017);
+
+const int kSelections = 300;
+
+class StreamableReplicaSetMonitorSelectHostTest : public unittest::Test {
+public:
+    void setUp() override {
+        _savedLatencyAware = gReplicaSetMonitorLatencyAwareHostSelection.load();
+        gReplicaSetMonitorLatencyAwareHostSelection.store(true);
+    }
+
+    void tearDown() override {
+        gReplicaSetMonitorLatencyAwareHostSelection.store(_savedLatencyAware);
+    }
+
+    /**
+     * Returns how many times each host was picked out of kSelections calls to selectHost().
+     */
+    std::map<HostAndPort, int> countSelections(const std::vector<HostAndPort>& hosts) {
+        std::map<HostAndPort, int> counts;
+        for (int i = 0; i < kSelections; ++i) {
+            ++counts[StreamableReplicaSetMonitor::selectHost(hosts, _random, _latencyTracker)];
+        }
+        return counts;
+    }
+
+protected:
+    ClockSourceMock _clock;
+    HostLatencyTracker _latencyTracker{&_clock};
+    PseudoRandom _random{1};
+
+private:
+    bool _savedLatencyAware;
+};
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, SingleHostIsAlwaysSelected) {
+    _latencyTracker.recordLatency(kHostA, Milliseconds(100));
+    auto counts = countSelections({kHostA});
+    ASSERT_EQ(counts[kHostA], kSelections);
+}
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, HostsWithoutLatenciesAreSelectedAtRandom) {
+    auto counts = countSelections({kHostA, kHostB, kHostC});
+    ASSERT_GT(counts[kHostA], 0);
+    ASSERT_GT(counts[kHostB], 0);
+    ASSERT_GT(counts[kHostC], 0);
+}
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, FasterOfTwoHostsIsSelected) {
+    _latencyTracker.recordLatency(kHostA, Milliseconds(10));
+    _latencyTracker.recordLatency(kHostB, Milliseconds(1));
+    auto counts = countSelections({kHostA, kHostB});
+    ASSERT_EQ(counts[kHostB], kSelections);
+}
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, SlowestHostIsNeverSelectedButOthersShareLoad) {
+    _latencyTracker.recordLatency(kHostA, Milliseconds(1));
+    _latencyTracker.recordLatency(kHostB, Milliseconds(2));
+    _latencyTracker.recordLatency(kHostC, Milliseconds(3));
+    auto counts = countSelections({kHostA, kHostB, kHostC});
+
+    // The slowest host always loses its comparison. The middle one wins whenever it is compared
+    // with the slowest, so requests are not all herded onto the fastest.
+    ASSERT_EQ(counts[kHostC], 0);
+    ASSERT_GT(counts[kHostB], 0);
+    ASSERT_GT(counts[kHostA], counts[kHostB]);
+}
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, SlowHostIsSelectedAgainOnceItsLatencyExpires) {
+    _latencyTracker.recordLatency(kHostA, Milliseconds(1));
+    _latencyTracker.recordLatency(kHostB, Milliseconds(10));
+    ASSERT_EQ(countSelections({kHostA, kHostB})[kHostB], 0);
+
+    // Only the fast host keeps receiving commands, so only its latency is refreshed.
+    _clock.advance(HostLatencyTracker::kSampleLifetime);
+    _latencyTracker.recordLatency(kHostA, Milliseconds(1));
+    _clock.advance(Milliseconds(1));
+    ASSERT_GT(countSelections({kHostA, kHostB})[kHostB], 0);
+
+    // Once the slow host reports a latency again it is compared on it.
+    _latencyTracker.recordLatency(kHostB, Milliseconds(10));
+    ASSERT_EQ(countSelections({kHostA, kHostB})[kHostB], 0);
+}
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, HostWithoutLatencyIsStillSelected) {
+    // A host no command has completed against yet is kept whenever it is picked first, so that it
+    // gets the chance to report a latency.
+    _latencyTracker.recordLatency(kHostA, Milliseconds(1));
+    auto counts = countSelections({kHostA, kHostB});
+    ASSERT_GT(counts[kHostA], 0);
+    ASSERT_GT(counts[kHostB], 0);
+}
+
+TEST_F(StreamableReplicaSetMonitorSelectHostTest, LatenciesAreIgnoredWhenDisabled) {
+    gReplicaSetMonitorLatencyAwareHostSelection.store(false);
+    _latencyTracker.recordLatency(kHostA, Milliseconds(10));
+    _latencyTracker.recordLatency(kHostB, Milliseconds(1));
+    auto counts = countSelections({kHostA, kHostB});
+    ASSERT_GT(counts[kHostA], 0);
+    ASSERT_GT(counts[kHostB], 0);
+}
+
+}  // namespace
+}  // namespace mongo
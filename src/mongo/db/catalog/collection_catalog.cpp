@@ -41,12 +41,98 @@
 #include "mongo/db/storage/snapshot_helper.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/uuid.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 namespace {
-struct LatestCollectionCatalog {
-    std::shared_ptr<CollectionCatalog> catalog = std::make_shared<CollectionCatalog>();
+// Threads are assigned to read slots round-robin, in the order they first read the catalog.
+AtomicWord<unsigned> nextReadSlotAssignment{0};
+thread_local unsigned threadReadSlotAssignment = nextReadSlotAssignment.fetchAndAdd(1);
+
+/**
+ * The latest version of the catalog. Every read slot holds its own reference to the catalog, with
+ * its own reference count, which readers assigned to the slot copy under the slot's SpinLock. The
+ * lock is needed because a shared_ptr can't be copied while another thread replaces it, but it is
+ * only held long enough to compare versions and bump the reference count. So readers only contend
+ * with the other threads assigned to the same slot, rather than with every reader of the catalog.
+ * The slots are updated when a new catalog is published, so they don't keep a replaced catalog
+ * alive for longer than the readers still using it.
+ */
+class LatestCollectionCatalog {
+public:
+    static constexpr size_t kNumReadSlots = 32;
+
+    LatestCollectionCatalog() {
+        publish(std::make_shared<CollectionCatalog>());
+    }
+
+    std::shared_ptr<const CollectionCatalog> get() const {
+        auto& slot = _readSlots[threadReadSlotAssignment % kNumReadSlots];
+        std::shared_ptr<const CollectionCatalog> replaced;
+
+        // Readers of the same slot serialize here. The slot is normally current, since publishing
+        // refreshes every slot, and only needs refreshing by a reader racing with a publish.
+        stdx::lock_guard<SpinLock> lk(slot.mutex);
+        if (MONGO_unlikely(slot.version != _version.load())) {
+            replaced = _refresh(lk, slot);
+        }
+        return slot.catalog;
+    }
+
+    /**
+     * Returns the latest catalog for copying. Must only be called by the thread publishing the
+     * next version.
+     */
+    std::shared_ptr<CollectionCatalog> getForWrite() const {
+        return atomic_load(&_catalog);
+    }
+
+    /**
+     * Makes 'newCatalog' the latest version of the catalog. Must be called by one thread at a
+     * time.
+     */
+    void publish(std::shared_ptr<CollectionCatalog> newCatalog) {
+        atomic_store(&_catalog, std::move(newCatalog));
+        _version.fetchAndAdd(1);
+
+        for (auto& slot : _readSlots) {
+            std::shared_ptr<const CollectionCatalog> replaced;
+            stdx::lock_guard<SpinLock> lk(slot.mutex);
+            replaced = _refresh(lk, slot);
+        }
+    }
+
+private:
+    struct ReadSlot {
+        SpinLock mutex;
+        uint64_t version = 0;
+        std::shared_ptr<const CollectionCatalog> catalog;
+    };
+
+    /**
+     * Points the slot to the latest catalog, and returns the reference it held before, which
+     * should be released after unlocking the slot.
+     */
+    std::shared_ptr<const CollectionCatalog> _refresh(WithLock, ReadSlot& slot) const {
+        // The catalog is at least as new as the version loaded before it.
+        slot.version = _version.load();
+        auto catalog = atomic_load(&_catalog);
+
+        // Alias the catalog with a reference held by the slot itself, so that copies made by
+        // readers only touch the slot's reference count.
+        std::shared_ptr<const CollectionCatalog> slotCatalog(
+            std::make_shared<std::shared_ptr<const CollectionCatalog>>(catalog), catalog.get());
+        slot.catalog.swap(slotCatalog);
+        return slotCatalog;
+    }
+
+    std::shared_ptr<CollectionCatalog> _catalog;
+    AtomicWord<uint64_t> _version{0};
+
+    mutable CacheAligned<ReadSlot> _readSlots[kNumReadSlots];
 };
 const ServiceContext::Decoration<LatestCollectionCatalog> getCatalog =
     ServiceContext::declareDecoration<LatestCollectionCatalog>();
@@ -310,7 +396,7 @@ bool CollectionCatalog::iterator::_exhausted() {
 }
 
 std::shared_ptr<const CollectionCatalog> CollectionCatalog::get(ServiceContext* svcCtx) {
-    return atomic_load(&getCatalog(svcCtx).catalog);
+    return getCatalog(svcCtx).get();
 }
 
 std::shared_ptr<const CollectionCatalog> CollectionCatalog::get(OperationContext* opCtx) {
@@ -395,7 +481,7 @@ void CollectionCatalog::write(ServiceContext* svcCtx, CatalogWriteFn job) {
 
     auto& storage = getCatalog(svcCtx);
     // hold onto base so if we need to delete it we can do it outside of the lock
-    auto base = atomic_load(&storage.catalog);
+    auto base = storage.getForWrite();
     // copy the collection catalog, this could be expensive, but we will only have one pending
     // collection in flight at a given time
     auto clone = std::make_shared<CollectionCatalog>(*base);
@@ -419,7 +505,7 @@ void CollectionCatalog::write(ServiceContext* svcCtx, CatalogWriteFn job) {
         stdx::lock_guard lock(mutex);
         if (queue.empty()) {
             // Queue is empty, store catalog and relinquish responsibility of being worker thread
-            atomic_store(&storage.catalog, std::move(clone));
+            storage.publish(std::move(clone));
             workerExists = false;
             break;
         }
@@ -38,6 +38,7 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 
@@ -506,6 +507,34 @@ TEST_F(CollectionCatalogTest, CollectionCatalogEpoch) {
     ASSERT_EQ(originalEpoch + 1, incrementedEpoch);
 }
 
+// Readers on any thread should see the catalog published by a write once it returns, and should
+// not keep the replaced catalog alive.
+TEST_F(CollectionCatalogTest, WritePublishesCatalogToAllReaders) {
+    auto svcCtx = getServiceContext();
+    auto uuid = CollectionUUID::gen();
+    NamespaceString newNss(nss.db(), "newcol");
+
+    std::weak_ptr<const CollectionCatalog> original = CollectionCatalog::get(svcCtx);
+    stdx::thread([&] { ASSERT(CollectionCatalog::get(svcCtx) == original.lock()); }).join();
+
+    CollectionCatalog::write(svcCtx, [&](CollectionCatalog& catalog) {
+        catalog.registerCollection(uuid, std::make_shared<CollectionMock>(newNss));
+    });
+    ASSERT(original.expired());
+
+    auto checkRegistered = [&] {
+        auto latest = CollectionCatalog::get(svcCtx);
+        ASSERT_EQUALS(*latest->lookupNSSByUUID(&opCtx, uuid), newNss);
+    };
+    checkRegistered();
+    stdx::thread(checkRegistered).join();
+
+    CollectionCatalog::write(svcCtx, [&](CollectionCatalog& catalog) {
+        catalog.deregisterCollection(&opCtx, uuid);
+    });
+    ASSERT_EQUALS(CollectionCatalog::get(svcCtx)->lookupNSSByUUID(&opCtx, uuid), boost::none);
+}
+
 DEATH_TEST_F(CollectionCatalogResourceTest, AddInvalidResourceType, "invariant") {
     auto rid = ResourceId(RESOURCE_GLOBAL, 0);
     catalog.addResource(rid, "");
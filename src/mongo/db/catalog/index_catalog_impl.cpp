@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -1344,6 +1345,24 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, coll->ns(), index->descriptor(), &options);
 
+    // Outside of hybrid index builds, whose side writes are made one record at a time, the keys of
+    // consecutive records which are written at the same timestamp are inserted as a single sorted
+    // batch.
+    if (!index->isHybridBuilding() && bsonRecords.size() > 1) {
+        for (auto runBegin = bsonRecords.begin(); runBegin != bsonRecords.end();) {
+            const auto runEnd = std::find_if(runBegin, bsonRecords.end(), [&](const auto& record) {
+                return record.ts != runBegin->ts;
+            });
+            Status status = _indexRecordsInKeyOrder(
+                opCtx, coll, index, runBegin, runEnd, options, keysInsertedOut);
+            if (!status.isOK()) {
+                return status;
+            }
+            runBegin = runEnd;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -1385,6 +1404,68 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_indexRecordsInKeyOrder(OperationContext* opCtx,
+                                                 const CollectionPtr& coll,
+                                                 IndexCatalogEntry* index,
+                                                 std::vector<BsonRecord>::const_iterator begin,
+                                                 std::vector<BsonRecord>::const_iterator end,
+                                                 const InsertDeleteOptions& options,
+                                                 int64_t* keysInsertedOut) {
+    auto& executionCtx = StorageExecutionContext::get(opCtx);
+    auto accessMethod = index->accessMethod();
+
+    if (!begin->ts.isNull()) {
+        Status status = opCtx->recoveryUnit()->setTimestamp(begin->ts);
+        if (!status.isOK())
+            return status;
+    }
+
+    std::vector<KeyString::Value> batchKeys;
+    for (auto it = begin; it != end; ++it) {
+        invariant(it->id != RecordId());
+
+        auto keys = executionCtx.keys();
+        auto multikeyMetadataKeys = executionCtx.multikeyMetadataKeys();
+        auto multikeyPaths = executionCtx.multikeyPaths();
+
+        accessMethod->getKeys(executionCtx.pooledBufferBuilder(),
+                              *it->docPtr,
+                              options.getKeysMode,
+                              IndexAccessMethod::GetKeysContext::kAddingKeys,
+                              keys.get(),
+                              multikeyMetadataKeys.get(),
+                              multikeyPaths.get(),
+                              it->id,
+                              IndexAccessMethod::kNoopOnSuppressedErrorFn);
+        batchKeys.insert(batchKeys.end(), keys->begin(), keys->end());
+
+        // Multikey state is tracked per record, exactly as insertKeysAndUpdateMultikeyPaths()
+        // would, since the paths which are multikey can differ between the documents.
+        if (accessMethod->shouldMarkIndexAsMultikey(
+                keys->size(), *multikeyMetadataKeys, *multikeyPaths)) {
+            index->setMultikey(opCtx, coll, *multikeyMetadataKeys, *multikeyPaths);
+        }
+        if (keysInsertedOut) {
+            *keysInsertedOut += multikeyMetadataKeys->size();
+        }
+    }
+
+    // Every key ends with the RecordId of its document, so the keys of different records never
+    // collide and the set holds all of them, sorted.
+    const KeyStringSet sortedKeys(batchKeys.begin(), batchKeys.end());
+
+    int64_t numInserted;
+    Status status = accessMethod->insertKeys(
+        opCtx, coll, sortedKeys, RecordId(), options, nullptr, &numInserted);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (keysInsertedOut) {
+        *keysInsertedOut += numInserted;
+    }
+    return Status::OK();
+}
+
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        const CollectionPtr& coll,
                                        IndexCatalogEntry* index,
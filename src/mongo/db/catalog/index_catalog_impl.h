@@ -329,6 +329,18 @@ private:
                                  const std::vector<BsonRecord>& bsonRecords,
                                  int64_t* keysInsertedOut);
 
+    /**
+     * Generates the keys of every record in [begin, end), which must all share the same
+     * timestamp, and inserts them into 'index' together in key order.
+     */
+    Status _indexRecordsInKeyOrder(OperationContext* opCtx,
+                                   const CollectionPtr& coll,
+                                   IndexCatalogEntry* index,
+                                   std::vector<BsonRecord>::const_iterator begin,
+                                   std::vector<BsonRecord>::const_iterator end,
+                                   const InsertDeleteOptions& options,
+                                   int64_t* keysInsertedOut);
+
     Status _indexRecords(OperationContext* opCtx,
                          const CollectionPtr& coll,
                          IndexCatalogEntry* index,
@@ -59,7 +59,9 @@
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
@@ -346,6 +348,260 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(
     }
 }
 
+/**
+ * Generates and sorts the keys of the documents read by a collection scan on a pool of worker
+ * threads. The scanning thread hands over batches of consecutive documents, and each worker adds
+ * the keys of the documents it receives to its own BulkBuilder for each index, so that no Sorter is
+ * shared between threads. finish() merges the workers' BulkBuilders into those of the
+ * MultiIndexBlock, whose done() then performs a k-way merge of all of their Sorters.
+ *
+ * Every document handed over is processed before finish() returns, so the collection scan
+ * position recorded for a resumable index build always matches the keys in the Sorters.
+ */
+class MultiIndexBlock::ParallelKeyGenerator {
+public:
+    ParallelKeyGenerator(MultiIndexBlock* block, size_t numThreads);
+
+    ~ParallelKeyGenerator() {
+        _stop();
+    }
+
+    /**
+     * Queues a copy of 'doc' to have its keys generated. Blocks, interruptibly, when the workers
+     * fall behind. Throws if a worker failed.
+     */
+    void add(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc) {
+        _pendingBatch.bytes += doc.objsize();
+        _pendingBatch.docs.emplace_back(doc.getOwned(), loc);
+        if (_pendingBatch.docs.size() >= kMaxDocsPerBatch ||
+            _pendingBatch.bytes >= kMaxBytesPerBatch) {
+            flush(opCtx);
+        }
+    }
+
+    /**
+     * Hands the queued documents over to the workers.
+     */
+    void flush(OperationContext* opCtx);
+
+    /**
+     * Waits for the workers to process every document handed over to them, merges their
+     * BulkBuilders into the MultiIndexBlock's, records the documents whose key generation errors
+     * they suppressed with the SkippedRecordTracker of each index, and records the last document
+     * handed over as the collection scan position. Documents queued but not flushed are
+     * discarded. Returns the first error encountered by a worker, and may be called again to
+     * retrieve it.
+     */
+    Status finish(OperationContext* opCtx, const CollectionPtr& collection);
+
+private:
+    static constexpr size_t kMaxDocsPerBatch = 512;
+    static constexpr size_t kMaxBytesPerBatch = 1024 * 1024;
+
+    struct Batch {
+        std::vector<std::pair<BSONObj, RecordId>> docs;
+        size_t bytes = 0;
+    };
+
+    struct BatchCost {
+        size_t operator()(const Batch& batch) const {
+            return std::max<size_t>(batch.bytes, 1);
+        }
+    };
+
+    using Queue = MultiProducerMultiConsumerQueue<Batch, BatchCost>;
+
+    /**
+     * Stops the workers once they have processed every document handed over to them and merges
+     * their BulkBuilders into the MultiIndexBlock's.
+     */
+    void _stop();
+
+    void _work(std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>* bulkBuilders,
+               std::vector<std::vector<RecordId>>* skippedRecords);
+
+    MultiIndexBlock* const _block;
+
+    Queue::Pipe _pipe;
+    ThreadPool _pool;
+
+    // The BulkBuilders of each worker, parallel to '_block->_indexes'.
+    std::vector<std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>> _workerBulkBuilders;
+
+    // The documents whose key generation errors were suppressed by each worker, by index. Workers
+    // do not hold the locks needed to write them to the SkippedRecordTracker's table, so finish()
+    // records them from the scanning thread.
+    std::vector<std::vector<std::vector<RecordId>>> _workerSkippedRecords;
+
+    Batch _pendingBatch;
+    boost::optional<RecordId> _lastRecordIdHandedOver;
+    bool _stopped = false;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("MultiIndexBlock::ParallelKeyGenerator::_mutex");
+    Status _workerStatus = Status::OK();
+};
+
+MultiIndexBlock::ParallelKeyGenerator::ParallelKeyGenerator(MultiIndexBlock* block,
+                                                            size_t numThreads)
+    : _block(block),
+      _pipe([&] {
+          // Bound the documents waiting for a worker while leaving room for a batch which was
+          // completed by a maximum size document.
+          Queue::Options options;
+          options.maxQueueDepth =
+              std::max(2 * numThreads * kMaxBytesPerBatch,
+                       kMaxBytesPerBatch + static_cast<size_t>(BSONObjMaxInternalSize));
+          return options;
+      }()),
+      _pool([&] {
+          ThreadPool::Options options;
+          options.poolName = "IndexBuildKeyGeneration";
+          options.minThreads = numThreads;
+          options.maxThreads = numThreads;
+          options.onCreateThread = [](const std::string& threadName) {
+              Client::initThread(threadName.c_str());
+          };
+          return options;
+      }()) {
+    // The memory budget of each index is shared between the workers' Sorters. The MultiIndexBlock's
+    // own Sorters receive no keys until the workers' are merged into them.
+    const size_t maxMemoryUsageBytes =
+        std::max<size_t>(_block->_eachIndexBuildMaxMemoryUsageBytes / numThreads, 1);
+
+    _workerBulkBuilders.resize(numThreads);
+    for (auto& bulkBuilders : _workerBulkBuilders) {
+        for (const auto& index : _block->_indexes) {
+            bulkBuilders.push_back(index.real->initiateBulk(maxMemoryUsageBytes, boost::none));
+        }
+    }
+    _workerSkippedRecords.assign(numThreads,
+                                 std::vector<std::vector<RecordId>>(_block->_indexes.size()));
+
+    _pool.startup();
+    for (size_t worker = 0; worker < numThreads; ++worker) {
+        _pool.schedule([this,
+                        bulkBuilders = &_workerBulkBuilders[worker],
+                        skippedRecords = &_workerSkippedRecords[worker]](Status status) {
+            invariant(status);
+            _work(bulkBuilders, skippedRecords);
+        });
+    }
+}
+
+void MultiIndexBlock::ParallelKeyGenerator::flush(OperationContext* opCtx) {
+    if (_pendingBatch.docs.empty()) {
+        return;
+    }
+
+    auto lastRecordId = _pendingBatch.docs.back().second;
+    try {
+        _pipe.producer.push(std::move(_pendingBatch), opCtx);
+    } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+        // A worker closed the queue after failing to generate keys.
+        _stop();
+        stdx::lock_guard<Latch> lk(_mutex);
+        invariant(!_workerStatus.isOK());
+        uassertStatusOK(_workerStatus);
+    }
+
+    _pendingBatch = Batch();
+    _lastRecordIdHandedOver = lastRecordId;
+}
+
+Status MultiIndexBlock::ParallelKeyGenerator::finish(OperationContext* opCtx,
+                                                     const CollectionPtr& collection) {
+    _stop();
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!_workerStatus.isOK()) {
+        return _workerStatus;
+    }
+
+    try {
+        for (auto& skippedRecords : _workerSkippedRecords) {
+            for (size_t i = 0; i < skippedRecords.size(); ++i) {
+                if (skippedRecords[i].empty()) {
+                    continue;
+                }
+                auto tracker = _block->_indexes[i]
+                                   .block->getEntry(opCtx, collection)
+                                   ->indexBuildInterceptor()
+                                   ->getSkippedRecordTracker();
+                for (const auto& loc : skippedRecords[i]) {
+                    tracker->record(opCtx, loc);
+                }
+                skippedRecords[i].clear();
+            }
+        }
+    } catch (const DBException& ex) {
+        _workerStatus = ex.toStatus();
+        return _workerStatus;
+    }
+
+    if (_lastRecordIdHandedOver) {
+        _block->_lastRecordIdInserted = _lastRecordIdHandedOver;
+    }
+    return Status::OK();
+}
+
+void MultiIndexBlock::ParallelKeyGenerator::_stop() {
+    if (_stopped) {
+        return;
+    }
+    _stopped = true;
+
+    _pipe.producer.close();
+    _pool.shutdown();
+    _pool.join();
+
+    for (auto& bulkBuilders : _workerBulkBuilders) {
+        for (size_t i = 0; i < bulkBuilders.size(); ++i) {
+            _block->_indexes[i].bulk->mergeFrom(std::move(bulkBuilders[i]));
+        }
+    }
+    _workerBulkBuilders.clear();
+}
+
+void MultiIndexBlock::ParallelKeyGenerator::_work(
+    std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>* bulkBuilders,
+    std::vector<std::vector<RecordId>>* skippedRecords) {
+    auto opCtx = cc().makeOperationContext();
+
+    try {
+        while (true) {
+            auto batch = _pipe.consumer.pop();
+            for (const auto& [doc, loc] : batch.docs) {
+                for (size_t i = 0; i < bulkBuilders->size(); ++i) {
+                    uassertStatusOK(_block->_insertIntoBulkBuilder(
+                        opCtx.get(),
+                        i,
+                        (*bulkBuilders)[i].get(),
+                        doc,
+                        loc,
+                        [&skipped = (*skippedRecords)[i]](const RecordId& skippedLoc) {
+                            skipped.push_back(skippedLoc);
+                        }));
+                }
+            }
+        }
+    } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+        // Every batch has been processed.
+    } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+        // Another worker failed.
+    } catch (const DBException& ex) {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_workerStatus.isOK()) {
+                _workerStatus = ex.toStatus();
+            }
+        }
+
+        // Stop the other workers, and make the scanning thread fail when it next hands over a
+        // batch.
+        _pipe.consumer.close();
+    }
+}
+
 Status MultiIndexBlock::insertAllDocumentsInCollection(
     OperationContext* opCtx,
     const CollectionPtr& collection,
@@ -443,6 +699,11 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
     bool readOnce = useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    boost::optional<ParallelKeyGenerator> parallelKeyGenerator;
+    if (const size_t numThreads = indexBuildKeyGenerationThreads.load(); numThreads > 1) {
+        parallelKeyGenerator.emplace(this, numThreads);
+    }
+
     try {
         // The phase will be kCollectionScan when resuming an index build from the collection scan
         // phase.
@@ -473,7 +734,11 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
 
             // The external sorter is not part of the storage engine and therefore does not need a
             // WriteUnitOfWork to write keys.
-            uassertStatusOK(_insert(opCtx, objToIndex, loc));
+            if (parallelKeyGenerator) {
+                parallelKeyGenerator->add(opCtx, objToIndex, loc);
+            } else {
+                uassertStatusOK(_insert(opCtx, objToIndex, loc));
+            }
 
             _failPointHangDuringBuild(opCtx,
                                       &hangIndexBuildDuringCollectionScanPhaseAfterInsertion,
@@ -486,7 +751,23 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
             progress->hit();
             n++;
         }
+
+        if (parallelKeyGenerator) {
+            parallelKeyGenerator->flush(opCtx);
+            uassertStatusOK(parallelKeyGenerator->finish(opCtx, collection));
+        }
     } catch (DBException& ex) {
+        if (parallelKeyGenerator) {
+            // Wait for the documents already handed over to the key generation threads, so that
+            // the collection scan position matches the keys in the sorters if this build is
+            // resumed. If a thread failed, the sorters are incomplete and the build cannot resume.
+            auto workerStatus = parallelKeyGenerator->finish(opCtx, collection);
+            if (!workerStatus.isOK()) {
+                _phase = IndexBuildPhaseEnum::kInitialized;
+                return workerStatus.withContext("collection scan stopped");
+            }
+        }
+
         if (ex.isA<ErrorCategory::Interruption>() || ex.isA<ErrorCategory::ShutdownError>() ||
             ErrorCodes::IndexBuildAborted == ex.code()) {
             // If the collection scan is stopped because due to an interrupt or shutdown event, we
@@ -572,20 +853,7 @@ Status MultiIndexBlock::insertSingleDocumentForInitialSyncOrRecovery(OperationCo
 Status MultiIndexBlock::_insert(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc) {
     invariant(!_buildIsCleanedUp);
     for (size_t i = 0; i < _indexes.size(); i++) {
-        if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
-            continue;
-        }
-
-        Status idxStatus = Status::OK();
-
-        // When calling insert, BulkBuilderImpl's Sorter performs file I/O that may result in an
-        // exception.
-        try {
-            idxStatus = _indexes[i].bulk->insert(opCtx, doc, loc, _indexes[i].options);
-        } catch (...) {
-            return exceptionToStatus();
-        }
-
+        Status idxStatus = _insertIntoBulkBuilder(opCtx, i, _indexes[i].bulk.get(), doc, loc);
         if (!idxStatus.isOK())
             return idxStatus;
     }
@@ -595,6 +863,29 @@ Status MultiIndexBlock::_insert(OperationContext* opCtx, const BSONObj& doc, con
     return Status::OK();
 }
 
+Status MultiIndexBlock::_insertIntoBulkBuilder(
+    OperationContext* opCtx,
+    size_t i,
+    IndexAccessMethod::BulkBuilder* bulk,
+    const BSONObj& doc,
+    const RecordId& loc,
+    const IndexAccessMethod::BulkBuilder::OnSkippedRecordFn& onSkippedRecord) const {
+    if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
+        return Status::OK();
+    }
+
+    // When calling insert, BulkBuilderImpl's Sorter performs file I/O that may result in an
+    // exception.
+    try {
+        if (onSkippedRecord) {
+            return bulk->insert(opCtx, doc, loc, _indexes[i].options, onSkippedRecord);
+        }
+        return bulk->insert(opCtx, doc, loc, _indexes[i].options);
+    } catch (...) {
+        return exceptionToStatus();
+    }
+}
+
 Status MultiIndexBlock::dumpInsertsFromBulk(OperationContext* opCtx,
                                             const CollectionPtr& collection) {
     return dumpInsertsFromBulk(opCtx, collection, nullptr);
@@ -290,6 +290,8 @@ public:
     void setIndexBuildMethod(IndexBuildMethod indexBuildMethod);
 
 private:
+    class ParallelKeyGenerator;
+
     struct IndexToBuild {
         std::unique_ptr<IndexBuildBlock> block;
 
@@ -319,6 +321,20 @@ private:
 
     Status _insert(OperationContext* opCtx, const BSONObj& wholeDocument, const RecordId& loc);
 
+    /**
+     * Unless 'wholeDocument' is excluded by the filter of the index at position 'i' of '_indexes',
+     * generates its keys for that index and adds them to 'bulk'. If 'onSkippedRecord' is set, it
+     * is called instead of recording the document with the index's SkippedRecordTracker when a key
+     * generation error is suppressed.
+     */
+    Status _insertIntoBulkBuilder(
+        OperationContext* opCtx,
+        size_t i,
+        IndexAccessMethod::BulkBuilder* bulk,
+        const BSONObj& wholeDocument,
+        const RecordId& loc,
+        const IndexAccessMethod::BulkBuilder::OnSkippedRecordFn& onSkippedRecord = nullptr) const;
+
     // Is set during init() and ensures subsequent function calls act on the same Collection.
     boost::optional<UUID> _collectionUUID;
 
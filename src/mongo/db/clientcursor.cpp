@@ -46,6 +46,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/cursor_server_params.h"
 #include "mongo/db/jsobj.h"
@@ -88,6 +89,8 @@ ClientCursor::ClientCursor(ClientCursorParams params,
       _readConcernArgs(std::move(params.readConcernArgs)),
       _originatingCommand(params.originatingCommandObj),
       _originatingPrivileges(std::move(params.originatingPrivileges)),
+      _queryHash(CurOp::get(operationUsingCursor)->debug().queryHash),
+      _planCacheKey(CurOp::get(operationUsingCursor)->debug().planCacheKey),
       _queryOptions(params.queryOptions),
       _exec(std::move(params.exec)),
       _operationUsingCursor(operationUsingCursor),
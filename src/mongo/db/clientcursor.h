@@ -188,6 +188,22 @@ public:
         return _originatingCommand;
     }
 
+    /**
+     * Returns the query hash of the operation which created this cursor, if that operation had a
+     * query shape. This allows the costs of getMores to be attributed to that shape.
+     */
+    boost::optional<uint32_t> getQueryHash() const {
+        return _queryHash;
+    }
+
+    /**
+     * Returns the plan cache key hash of the operation which created this cursor. It is set
+     * whenever getQueryHash() is, and must be reported alongside it.
+     */
+    boost::optional<uint32_t> getPlanCacheKey() const {
+        return _planCacheKey;
+    }
+
     /**
      * Returns the privileges required to run a getMore against this cursor. This is the same as the
      * set of privileges which would have been required to create the cursor in the first place.
@@ -385,6 +401,11 @@ private:
     // The privileges required for the _originatingCommand.
     const PrivilegeVector _originatingPrivileges;
 
+    // The query hash and plan cache key hash of the operation which created this cursor. See
+    // getQueryHash() and getPlanCacheKey().
+    const boost::optional<uint32_t> _queryHash;
+    const boost::optional<uint32_t> _planCacheKey;
+
     // See the QueryOptions enum in dbclientinterface.h.
     const int _queryOptions = 0;
 
@@ -39,6 +39,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/executor/connection_pool_stats.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/grid.h"
@@ -108,6 +109,12 @@ public:
         // Always report all replica sets being tracked.
         ReplicaSetMonitorManager::get()->report(&result);
 
+        // Report how long remote commands have recently taken on each host.
+        {
+            BSONObjBuilder latencyBuilder(result.subobjStart("hostLatencyMillis"));
+            executor::HostLatencyTracker::get().append(&latencyBuilder);
+        }
+
         return true;
     }
 
@@ -533,6 +533,11 @@ public:
                     curOp->setOriginatingCommand_inlock(originatingCommand);
                 }
 
+                // Attribute this getMore to the query shape of the operation which created the
+                // cursor. OpDebug requires the plan cache key whenever the query hash is set.
+                curOp->debug().queryHash = cursorPin->getQueryHash();
+                curOp->debug().planCacheKey = cursorPin->getPlanCacheKey();
+
                 // Update the genericCursor stored in curOp with the new cursor stats.
                 curOp->setGenericCursor_inlock(cursorPin->toGenericCursor());
             }
@@ -31,9 +31,11 @@
 
 #include "mongo/config.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/transport/message_buffer_pool.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_work_stealing.h"
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/net/ssl_manager.h"
@@ -84,7 +86,12 @@ public:
         BSONObjBuilder b;
         networkCounter.append(b);
         appendMessageCompressionStats(&b);
-        auto executor = transport::ServiceExecutorSynchronous::get(opCtx->getServiceContext());
+        transport::MessageBufferPool::appendStats(&b);
+        auto svcCtx = opCtx->getServiceContext();
+        transport::ServiceExecutor* executor = transport::ServiceExecutorWorkStealing::get(svcCtx);
+        if (!executor) {
+            executor = transport::ServiceExecutorSynchronous::get(svcCtx);
+        }
         if (executor) {
             BSONObjBuilder section(b.subobjStart("serviceExecutorTaskStats"));
             executor->appendStats(&section);
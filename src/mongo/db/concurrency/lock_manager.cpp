@@ -48,6 +48,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 #include "mongo/util/timer.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 namespace {
@@ -192,9 +193,10 @@ struct LockHead {
 
     /**
      * Finish creation of request and put it on the LockHead's conflict or granted queues. Returns
-     * LOCK_WAITING for conflict case and LOCK_OK otherwise.
+     * LOCK_WAITING for conflict case and LOCK_OK otherwise. 'fastIntentModes' are the modes in
+     * which the resource is held through its FastIntentLock.
      */
-    LockResult newRequest(LockRequest* request) {
+    LockResult newRequest(LockRequest* request, uint32_t fastIntentModes = 0) {
         invariant(!request->partitionedLock);
         request->lock = this;
 
@@ -204,7 +206,7 @@ struct LockHead {
 
         // New lock request. Queue after all granted modes and after any already requested
         // conflicting modes
-        if (conflicts(request->mode, grantedModes) ||
+        if (conflicts(request->mode, grantedModes | fastIntentModes) ||
             (!compatibleFirstCount && conflicts(request->mode, conflictModes))) {
             request->status = LockRequest::STATUS_WAITING;
 
@@ -233,6 +235,25 @@ struct LockHead {
         return LOCK_OK;
     }
 
+    /**
+     * Adds a request which is already granted, in an intent mode, elsewhere to the granted queue.
+     */
+    void addGrantedIntentRequest(LockRequest* request) {
+        invariant(request->status == LockRequest::STATUS_GRANTED);
+        invariant(intentModes & modeMask(request->mode));
+        request->lock = this;
+        grantedList.push_back(request);
+        incGrantedModeCount(request->mode);
+    }
+
+    /**
+     * True iff there are no granted or pending requests in non-intent modes, so intent mode
+     * requests can be granted without looking at the LockHead.
+     */
+    bool intentOnly() const {
+        return !(grantedModes & ~intentModes) && !conflictModes;
+    }
+
     /**
      * Lock each partitioned LockHead in turn, and move any (granted) intent mode requests for
      * lock->resourceId to lock, which must itself already be locked.
@@ -373,6 +394,56 @@ struct PartitionedLockHead {
     LockRequestList grantedList;
 };
 
+/**
+ * Grants intent mode requests on the global and database resources, which nearly every operation
+ * acquires, without taking any mutex. Each request only increments a counter in one of several
+ * stripes, which keeps concurrent lockers from contending on a single cache line.
+ *
+ * Before a request in a non-intent mode is queued on the resource's LockHead, 'blocked' is set,
+ * which makes new intent requests go through the LockHead instead, and the modes still held
+ * through the counters are treated as granted on the LockHead until they drain. An acquirer which
+ * finds 'blocked' set after incrementing its counter decrements it again, so either the acquirer
+ * sees 'blocked' or the conflicting request sees the acquirer's count.
+ *
+ * Entries are claimed under the bucket mutex of their resource and are never released, so a
+ * resource keeps its entry, and lookups can stop at the first free entry.
+ */
+struct FastIntentLock {
+    static constexpr unsigned kNumStripes = 32;
+
+    AtomicWord<long long>& count(LockRequest* request) {
+        auto& stripe = stripes[request->locker->getId() % kNumStripes];
+        return request->mode == MODE_IS ? stripe.isCount : stripe.ixCount;
+    }
+
+    ResourceId resourceId() const {
+        return ResourceId::fromFullHash(resId.load());
+    }
+
+    uint32_t heldModes() const {
+        long long isCount = 0;
+        long long ixCount = 0;
+        for (const auto& stripe : stripes) {
+            isCount += stripe.isCount.load();
+            ixCount += stripe.ixCount.load();
+        }
+        return (isCount > 0 ? modeMask(MODE_IS) : 0) | (ixCount > 0 ? modeMask(MODE_IX) : 0);
+    }
+
+    // The ResourceId this entry belongs to, or zero while it is free.
+    AtomicWord<uint64_t> resId{0};
+
+    // Set while the LockHead of the resource has granted or pending requests in non-intent modes.
+    // Only written under the resource's bucket mutex.
+    AtomicWord<bool> blocked{false};
+
+    struct Stripe {
+        AtomicWord<long long> isCount{0};
+        AtomicWord<long long> ixCount{0};
+    };
+    CacheAligned<Stripe> stripes[kNumStripes];
+};
+
 void LockHead::migratePartitionedLockHeads() {
     invariant(partitioned());
 
@@ -417,6 +488,10 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
+// Enough for the global resources and the databases in use. Databases beyond that use the
+// partitions instead.
+const unsigned LockManager::_numFastIntentLocks = 128;
+
 // static
 std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serviceContext) {
     std::map<LockerId, BSONObj> lockToClientMap;
@@ -446,6 +521,7 @@ std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serv
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+    _fastIntentLocks = new FastIntentLock[_numFastIntentLocks];
 }
 
 LockManager::~LockManager() {
@@ -456,8 +532,13 @@ LockManager::~LockManager() {
         invariant(_lockBuckets[i].data.empty());
     }
 
+    for (unsigned i = 0; i < _numFastIntentLocks; i++) {
+        invariant(_fastIntentLocks[i].heldModes() == 0);
+    }
+
     delete[] _lockBuckets;
     delete[] _partitions;
+    delete[] _fastIntentLocks;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -467,6 +548,15 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
     request->mode = mode;
 
+    // Compatible-first requests change the policy of their LockHead, so they must be on it.
+    const bool canUseFastIntentLock = request->partitioned && !request->compatibleFirst;
+    if (canUseFastIntentLock) {
+        FastIntentLock* fastLock = _findFastIntentLock(resId);
+        if (fastLock && _tryLockFastIntent(fastLock, request)) {
+            return LOCK_OK;
+        }
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
         Partition* partition = _getPartition(request);
@@ -492,8 +582,21 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     LockHead* lock = bucket->findOrInsert(resId);
 
+    // Start using the fast intent lock if possible. It cannot be blocked, as that requires a
+    // non-intent request on the LockHead, but could have been blocked by one which has since
+    // gone away.
+    if (canUseFastIntentLock && lock->intentOnly()) {
+        if (FastIntentLock* fastLock = _findOrInsertFastIntentLock(resId)) {
+            fastLock->blocked.store(false);
+            fastLock->count(request).fetchAndAdd(1);
+            request->fastIntentLock = fastLock;
+            request->status = LockRequest::STATUS_GRANTED;
+            return LOCK_OK;
+        }
+    }
+
     // Start a partitioned lock if possible
-    if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
+    if (request->partitioned && lock->intentOnly()) {
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
         PartitionedLockHead* partitionedLock = partition->findOrInsert(resId);
@@ -508,8 +611,10 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
         lock->migratePartitionedLockHeads();
     }
 
+    const uint32_t fastIntentModes = request->partitioned ? 0 : _blockFastIntentLock(resId);
+
     request->partitioned = false;
-    return lock->newRequest(request);
+    return lock->newRequest(request, fastIntentModes);
 }
 
 LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode newMode) {
@@ -538,15 +643,23 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
     invariant(request->status == LockRequest::STATUS_GRANTED);
 
-    LockBucket::Map::iterator it = bucket->data.find(resId);
-    invariant(it != bucket->data.end());
-
-    LockHead* const lock = it->second;
+    LockHead* lock;
+    if (request->fastIntentLock) {
+        lock = bucket->findOrInsert(resId);
+        _migrateFastIntentRequest(lock, request);
+    } else {
+        LockBucket::Map::iterator it = bucket->data.find(resId);
+        invariant(it != bucket->data.end());
+        lock = it->second;
+    }
 
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
 
+    const uint32_t fastIntentModes =
+        (intentModes & modeMask(newMode)) ? 0 : _blockFastIntentLock(resId);
+
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
     uint32_t grantedModesWithoutCurrentRequest = 0;
@@ -569,7 +682,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     //
     // Because the check does not look into the conflict modes bitmap, it will grant L to
     // T1 in S mode, instead of block, which would otherwise cause deadlock.
-    if (conflicts(newMode, grantedModesWithoutCurrentRequest)) {
+    if (conflicts(newMode, grantedModesWithoutCurrentRequest | fastIntentModes)) {
         request->status = LockRequest::STATUS_CONVERTING;
         request->convertMode = newMode;
 
@@ -590,6 +703,18 @@ bool LockManager::unlock(LockRequest* request) {
     invariant(request->recursiveCount > 0);
     request->recursiveCount--;
 
+    if (FastIntentLock* fastLock = request->fastIntentLock) {
+        if (request->recursiveCount > 0)
+            return false;
+
+        request->fastIntentLock = nullptr;
+        fastLock->count(request).fetchAndSubtract(1);
+        if (MONGO_unlikely(fastLock->blocked.load())) {
+            _onFastIntentReleased(fastLock);
+        }
+        return true;
+    }
+
     if (request->partitioned) {
         // Unlocking a lock that was acquired as partitioned. The lock request may since have
         // moved to the lock head, but there is no safe way to find out without synchronizing
@@ -667,7 +792,7 @@ bool LockManager::unlock(LockRequest* request) {
 }
 
 void LockManager::downgrade(LockRequest* request, LockMode newMode) {
-    invariant(request->lock);
+    invariant(request->lock || request->fastIntentLock);
     invariant(request->recursiveCount > 0);
 
     // The conflict set of the newMode should be a subset of the conflict set of the old mode.
@@ -675,12 +800,19 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[request->mode]);
 
-    LockHead* lock = request->lock;
+    const ResourceId resId = request->fastIntentLock
+        ? request->fastIntentLock->resourceId()
+        : request->lock->resourceId;
 
-    LockBucket* bucket = _getBucket(lock->resourceId);
+    LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
     invariant(request->status == LockRequest::STATUS_GRANTED);
 
+    if (request->fastIntentLock) {
+        _migrateFastIntentRequest(bucket->findOrInsert(resId), request);
+    }
+    LockHead* lock = request->lock;
+
     lock->incGrantedModeCount(newMode);
     lock->decGrantedModeCount(request->mode);
     request->mode = newMode;
@@ -726,6 +858,10 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
 }
 
 void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
+    FastIntentLock* fastLock = _findFastIntentLock(lock->resourceId);
+    const uint32_t fastIntentModes =
+        (fastLock && fastLock->blocked.load()) ? fastLock->heldModes() : 0;
+
     // Unblock any converting requests (because conversions are still counted as granted and
     // are on the granted queue).
     for (LockRequest* iter = lock->grantedList._front;
@@ -756,7 +892,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
                 }
             }
 
-            if (!conflicts(iter->convertMode, grantedModesWithoutCurrentRequest)) {
+            if (!conflicts(iter->convertMode,
+                           grantedModesWithoutCurrentRequest | fastIntentModes)) {
                 lock->conversionsCount--;
                 lock->decGrantedModeCount(iter->mode);
                 iter->status = LockRequest::STATUS_GRANTED;
@@ -795,7 +932,7 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
         // the granted queue.
         iterNext = iter->next;
 
-        if (conflicts(iter->mode, lock->grantedModes)) {
+        if (conflicts(iter->mode, lock->grantedModes | fastIntentModes)) {
             // If iter doesn't have a previous pointer, this means that it is at the front of the
             // queue. If we continue scanning the queue beyond this point, we will starve it by
             // granting more and more requests. However, if we newly transition to compatibleFirst
@@ -829,6 +966,11 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
         }
     }
 
+    // Once no request conflicts with intent modes anymore, let them use the fast path again.
+    if (fastLock && lock->intentOnly()) {
+        fastLock->blocked.store(false);
+    }
+
     // This is a convenient place to check that the state of the two request queues is in sync
     // with the bitmask on the modes.
     invariant((lock->grantedModes == 0) ^ (lock->grantedList._front != nullptr));
@@ -843,6 +985,100 @@ LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
     return &_partitions[request->locker->getId() % _numPartitions];
 }
 
+namespace {
+
+// How many entries to look at for the fast intent lock of a resource, starting at the one its
+// hash maps to.
+constexpr unsigned kMaxFastIntentLockProbes = 8;
+
+bool hasFastIntentLock(ResourceId resId) {
+    const ResourceType type = resId.getType();
+    return type == RESOURCE_GLOBAL || type == RESOURCE_PBWM || type == RESOURCE_RSTL ||
+        type == RESOURCE_DATABASE;
+}
+
+}  // namespace
+
+FastIntentLock* LockManager::_findFastIntentLock(ResourceId resId) const {
+    if (!hasFastIntentLock(resId)) {
+        return nullptr;
+    }
+    for (unsigned i = 0; i < kMaxFastIntentLockProbes; i++) {
+        FastIntentLock* fastLock = &_fastIntentLocks[(resId + i) % _numFastIntentLocks];
+        const uint64_t owner = fastLock->resId.load();
+        if (owner == resId) {
+            return fastLock;
+        }
+        if (owner == 0) {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+FastIntentLock* LockManager::_findOrInsertFastIntentLock(ResourceId resId) {
+    if (!hasFastIntentLock(resId)) {
+        return nullptr;
+    }
+    for (unsigned i = 0; i < kMaxFastIntentLockProbes; i++) {
+        FastIntentLock* fastLock = &_fastIntentLocks[(resId + i) % _numFastIntentLocks];
+        // Resources in other buckets may be claiming entries at the same time.
+        uint64_t owner = fastLock->resId.compareAndSwap(0, resId);
+        if (owner == 0 || owner == resId) {
+            return fastLock;
+        }
+    }
+    return nullptr;
+}
+
+bool LockManager::_tryLockFastIntent(FastIntentLock* fastLock, LockRequest* request) {
+    auto& count = fastLock->count(request);
+    count.fetchAndAdd(1);
+    if (MONGO_likely(!fastLock->blocked.load())) {
+        request->fastIntentLock = fastLock;
+        request->status = LockRequest::STATUS_GRANTED;
+        return true;
+    }
+
+    // A conflicting request may have seen our count, and be waiting for it to go away.
+    count.fetchAndSubtract(1);
+    _onFastIntentReleased(fastLock);
+    return false;
+}
+
+uint32_t LockManager::_blockFastIntentLock(ResourceId resId) {
+    FastIntentLock* fastLock = _findFastIntentLock(resId);
+    if (!fastLock) {
+        return 0;
+    }
+    fastLock->blocked.store(true);
+    return fastLock->heldModes();
+}
+
+void LockManager::_onFastIntentReleased(FastIntentLock* fastLock) {
+    const ResourceId resId = fastLock->resourceId();
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    auto it = bucket->data.find(resId);
+    if (it != bucket->data.end()) {
+        _onLockModeChanged(it->second, true);
+    }
+}
+
+void LockManager::_migrateFastIntentRequest(LockHead* lock, LockRequest* request) {
+    FastIntentLock* fastLock = request->fastIntentLock;
+    invariant(fastLock);
+    invariant(fastLock->resId.load() == lock->resourceId);
+
+    // Add the request to the LockHead before dropping its count, so that it is always accounted
+    // for.
+    request->fastIntentLock = nullptr;
+    request->partitioned = false;
+    lock->addGrantedIntentRequest(request);
+    fastLock->count(request).fetchAndSubtract(1);
+}
+
 void LockManager::dump() const {
     BSONArrayBuilder locks;
     _buildLocksArray(getLockToClientMap(getGlobalServiceContext()), true, nullptr, &locks);
@@ -981,6 +1217,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    fastIntentLock = nullptr;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -187,6 +187,47 @@ private:
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Returns the fast intent lock counters of a global or database resource, or nullptr if it
+     * has none. There is no need to hold a lock when calling this function.
+     */
+    FastIntentLock* _findFastIntentLock(ResourceId resId) const;
+
+    /**
+     * Same as above, but claims a free entry for the resource if it has none yet. Returns nullptr
+     * if no entry is free or the resource is of another type. Must be called under the resource's
+     * bucket mutex.
+     */
+    FastIntentLock* _findOrInsertFastIntentLock(ResourceId resId);
+
+    /**
+     * Attempts to grant an intent mode request through 'fastLock', without any mutex. Fails when
+     * the resource has a granted or pending request in a conflicting mode.
+     */
+    bool _tryLockFastIntent(FastIntentLock* fastLock, LockRequest* request);
+
+    /**
+     * Returns the intent modes in which the resource is held through its fast intent lock. Also
+     * stops further fast acquisitions, so that the result can only lose modes until the resource
+     * no longer has requests in non-intent modes. Must be called under the resource's bucket
+     * mutex, before queueing a request in a non-intent mode.
+     */
+    uint32_t _blockFastIntentLock(ResourceId resId);
+
+    /**
+     * Should be invoked after a fast intent request went away while fast acquisitions were
+     * stopped, as it may have been the last one a conflicting request was waiting for. Must not
+     * be called with any mutex held.
+     */
+    void _onFastIntentReleased(FastIntentLock* fastLock);
+
+    /**
+     * Moves a request granted through its fast intent lock to 'lock', which must be the LockHead
+     * for the same resource, so that it can be converted or downgraded. Must be called under the
+     * bucket mutex of 'lock'.
+     */
+    void _migrateFastIntentRequest(LockHead* lock, LockRequest* request);
+
     /**
      * The backend of `dump` and `getLockInfoBSON`.
      * If `mutableThis`, then we also clean the unused locks in the buckets while iterating.
@@ -221,5 +262,8 @@ private:
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    static const unsigned _numFastIntentLocks;
+    FastIntentLock* _fastIntentLocks;
 };
 }  // namespace mongo
@@ -46,6 +46,7 @@ namespace mongo {
 
 class Locker;
 
+struct FastIntentLock;
 struct LockHead;
 struct PartitionedLockHead;
 
@@ -214,6 +215,15 @@ public:
         : _fullHash(fullHash(type, hashStringData(ns))) {}
     ResourceId(ResourceType type, uint64_t hashId) : _fullHash(fullHash(type, hashId)) {}
 
+    /**
+     * Recreates a ResourceId from the value it converts to.
+     */
+    static ResourceId fromFullHash(uint64_t fullHash) {
+        ResourceId resId;
+        resId._fullHash = fullHash;
+        return resId;
+    }
+
     bool isValid() const {
         return getType() != RESOURCE_INVALID;
     }
@@ -426,6 +436,16 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Pointer to the counters through which this request was granted without a LockHead, or null.
+    // Only intent mode requests on global and database resources are granted this way. While it is
+    // set, neither 'lock' nor 'partitionedLock' is, and the request can only transition from it to
+    // 'lock'.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    FastIntentLock* fastIntentLock;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
@@ -952,4 +952,107 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, IntentConvertUpgradeWaitsForOtherIntentHolders) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+    LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+
+    LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+
+    // Upgrade the IS lock to X, which must wait for the IX lock
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT_EQ(0, request1.numNotifies);
+
+    // New intent locks queue behind the conversion
+    LockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_IS));
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT_EQ(LOCK_OK, request1.lastResult);
+    ASSERT_EQ(1, request1.numNotifies);
+    ASSERT_EQ(0, request3.numNotifies);
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT_EQ(LOCK_OK, request3.lastResult);
+    ASSERT_EQ(1, request3.numNotifies);
+
+    ASSERT(lockMgr.unlock(&request3));
+}
+
+TEST(LockManager, IntentDowngradeWaitsForConflictingRequest) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+
+    // Downgrade the IX request to IS, after which S is compatible but X is not
+    lockMgr.downgrade(&request1, MODE_IS);
+
+    LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_S));
+    ASSERT(lockMgr.unlock(&request2));
+
+    LockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_X));
+
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT_EQ(LOCK_OK, request3.lastResult);
+    ASSERT_EQ(1, request3.numNotifies);
+
+    ASSERT(lockMgr.unlock(&request3));
+}
+
+TEST(LockManager, IntentLocksGrantedAgainAfterConflictCancelled) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+    LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    // Cancelling the X request grants the queued intent lock, and new ones are granted right away
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(0, requestX.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestIS.lastResult);
+    ASSERT_EQ(1, requestIS.numNotifies);
+
+    LockerImpl lockerIX1;
+    LockRequestCombo requestIX1(&lockerIX1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX1, MODE_IX));
+
+    // A later conflicting request still waits for all of them
+    LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestS, MODE_S));
+
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT_EQ(0, requestS.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestIX1));
+    ASSERT_EQ(LOCK_OK, requestS.lastResult);
+    ASSERT_EQ(1, requestS.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestS));
+}
+
 }  // namespace mongo
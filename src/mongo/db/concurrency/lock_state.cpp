@@ -360,9 +360,10 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        const TicketAdmission admission = opCtx ? TicketAdmission::get(opCtx) : TicketAdmission();
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, admission);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, admission)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
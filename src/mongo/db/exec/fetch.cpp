@@ -38,6 +38,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/str.h"
 
@@ -49,6 +50,12 @@ using std::vector;
 // static
 const char* FetchStage::kStageType = "FETCH";
 
+namespace {
+// Documents are fetched one at a time until this many have been fetched, so that plans which stop
+// early, such as those under a small limit, don't read further ahead in their child than before.
+const size_t kDocsFetchedBeforeBatching = 1000;
+}  // namespace
+
 FetchStage::FetchStage(ExpressionContext* expCtx,
                        WorkingSet* ws,
                        std::unique_ptr<PlanStage> child,
@@ -69,7 +76,7 @@ bool FetchStage::isEOF() {
         return false;
     }
 
-    return child()->isEOF();
+    return _batch.empty() && child()->isEOF();
 }
 
 PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
@@ -77,55 +84,139 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    // Either retry the last WSM we worked on or get a new one from our child.
-    WorkingSetID id;
-    StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
-        status = ADVANCED;
-        id = _idRetrying;
+    // Retry the last WSM we worked on, if fetching it hit a write conflict.
+    if (_idRetrying != WorkingSet::INVALID_ID) {
+        WorkingSetID id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+        return fetchAndReturnIfMatches(id, nullptr, out);
     }
 
-    if (PlanStage::ADVANCED == status) {
-        WorkingSetMember* member = _ws->get(id);
+    if (!_batchReady) {
+        if (_batch.size() < batchSize() && !child()->isEOF()) {
+            WorkingSetID id;
+            StageState status = child()->work(&id);
+            if (PlanStage::ADVANCED == status) {
+                _batch.push_back({id});
+            } else if (PlanStage::NEED_YIELD == status) {
+                *out = id;
+                return status;
+            } else if (PlanStage::IS_EOF != status) {
+                return status;
+            }
 
-        // If there's an obj there, there is no fetching to perform.
-        if (member->hasObj()) {
-            ++_specificStats.alreadyHasObj;
-        } else {
-            // We need a valid RecordId to fetch from and this is the only state that has one.
-            verify(WorkingSetMember::RID_AND_IDX == member->getState());
-            verify(member->hasRecordId());
+            if (_batch.size() < batchSize() && !child()->isEOF()) {
+                return NEED_TIME;
+            }
+        }
 
-            try {
-                if (!_cursor)
-                    _cursor = collection()->getCursor(opCtx());
+        if (_batch.empty()) {
+            return IS_EOF;
+        }
 
-                if (!WorkingSetCommon::fetch(opCtx(), _ws, id, _cursor, collection()->ns())) {
-                    _ws->free(id);
-                    return NEED_TIME;
-                }
+        // There is nothing to gain from fetching a single member ahead of time.
+        if (_batch.size() > 1) {
+            try {
+                fetchBatch();
             } catch (const WriteConflictException&) {
-                // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
-                // be freed when we yield.
-                member->makeObjOwnedIfNeeded();
-                _idRetrying = id;
+                // The members keep their place in '_batch', and are fetched again after the yield.
                 *out = WorkingSet::INVALID_ID;
                 return NEED_YIELD;
             }
         }
+        _batchReady = true;
+    }
+
+    BatchedMember next = std::move(_batch.front());
+    _batch.pop_front();
+    if (_batch.empty()) {
+        _batchReady = false;
+    }
+    return fetchAndReturnIfMatches(next.id, next.fetched ? &next.record : nullptr, out);
+}
+
+size_t FetchStage::batchSize() const {
+    if (_docsFetched < kDocsFetchedBeforeBatching) {
+        return 1;
+    }
+    return internalQueryFetchBatchSize.load();
+}
+
+void FetchStage::fetchBatch() {
+    std::vector<RecordId> ids;
+    ids.reserve(_batch.size());
+    for (auto&& batched : _batch) {
+        WorkingSetMember* member = _ws->get(batched.id);
+        if (!member->hasObj()) {
+            ids.push_back(member->recordId);
+        }
+    }
+
+    if (!_cursor)
+        _cursor = collection()->getCursor(opCtx());
+
+    std::vector<boost::optional<Record>> records;
+    _cursor->fetchBatch(ids, &records);
 
-        return returnIfMatches(member, id, out);
-    } else if (PlanStage::NEED_YIELD == status) {
-        *out = id;
+    auto record = records.begin();
+    for (auto&& batched : _batch) {
+        if (!_ws->get(batched.id)->hasObj()) {
+            batched.record = std::move(*record++);
+            batched.fetched = true;
+        }
     }
+    _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+}
+
+PlanStage::StageState FetchStage::fetchAndReturnIfMatches(WorkingSetID id,
+                                                          boost::optional<Record>* prefetched,
+                                                          WorkingSetID* out) {
+    WorkingSetMember* member = _ws->get(id);
+
+    // If there's an obj there, there is no fetching to perform.
+    if (member->hasObj()) {
+        ++_specificStats.alreadyHasObj;
+    } else {
+        // We need a valid RecordId to fetch from and this is the only state that has one.
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+        verify(member->hasRecordId());
+
+        try {
+            if (!_cursor)
+                _cursor = collection()->getCursor(opCtx());
 
-    return status;
+            ++_docsFetched;
+
+            // A record fetched in a batch can only be used if we haven't yielded since.
+            bool fetched;
+            if (prefetched && _batchSnapshotId == opCtx()->recoveryUnit()->getSnapshotId()) {
+                fetched = WorkingSetCommon::fetch(
+                    opCtx(), _ws, id, std::move(*prefetched), collection()->ns());
+            } else {
+                fetched = WorkingSetCommon::fetch(opCtx(), _ws, id, _cursor, collection()->ns());
+            }
+            if (!fetched) {
+                _ws->free(id);
+                return NEED_TIME;
+            }
+        } catch (const WriteConflictException&) {
+            // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
+            // be freed when we yield.
+            member->makeObjOwnedIfNeeded();
+            _idRetrying = id;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+    }
+
+    return returnIfMatches(member, id, out);
 }
 
 void FetchStage::doSaveStateRequiresCollection() {
+    // Members waiting in '_batch' may point into storage that is released when we yield.
+    for (auto&& batched : _batch) {
+        _ws->get(batched.id)->makeObjOwnedIfNeeded();
+    }
+
     if (_cursor) {
         _cursor->saveUnpositioned();
     }
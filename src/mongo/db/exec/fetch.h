@@ -29,12 +29,15 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/snapshot.h"
 
 namespace mongo {
 
@@ -46,6 +49,11 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * Once it has fetched enough documents one at a time to look like a long scan, the stage buffers
+ * members from its child and fetches them in batches with SeekableRecordCursor::fetchBatch(),
+ * which reads them in RecordId order. Members are still returned in the order the child produced
+ * them.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public RequiresCollectionStage {
@@ -86,6 +94,44 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Fetches the member with id 'memberID', if it does not already have an object, and then
+     * returns it as returnIfMatches() does. Uses 'prefetched' rather than reading the record again
+     * if it is not null and was read in the current snapshot.
+     */
+    StageState fetchAndReturnIfMatches(WorkingSetID memberID,
+                                       boost::optional<Record>* prefetched,
+                                       WorkingSetID* out);
+
+    /**
+     * Looks up the records for all the members in '_batch' which need them.
+     */
+    void fetchBatch();
+
+    /**
+     * The number of members to gather from our child before fetching them.
+     */
+    size_t batchSize() const;
+
+    struct BatchedMember {
+        WorkingSetID id;
+        boost::optional<Record> record;
+        bool fetched = false;
+    };
+
+    // Members from our child waiting to be fetched and returned, in the order our child returned
+    // them.
+    std::deque<BatchedMember> _batch;
+
+    // Whether '_batch' is complete and its records have been fetched, if it was worth doing so.
+    bool _batchReady = false;
+
+    // The snapshot the records in '_batch' were read in.
+    SnapshotId _batchSnapshotId;
+
+    // The number of documents this stage has fetched.
+    size_t _docsFetched = 0;
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
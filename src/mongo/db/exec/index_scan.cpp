@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/index_scan.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/index_catalog.h"
@@ -42,6 +43,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace {
 
@@ -55,6 +57,72 @@ int sgn(int i) {
 }  // namespace
 
 namespace mongo {
+namespace {
+
+/**
+ * Returns true if 'oil' places no constraint on the values of its field.
+ */
+bool isUnbounded(const OrderedIntervalList& oil) {
+    if (oil.intervals.size() != 1) {
+        return false;
+    }
+    const Interval& interval = oil.intervals[0];
+    return (interval.isMinToMax() || interval.isMaxToMin()) && interval.startInclusive &&
+        interval.endInclusive;
+}
+
+/**
+ * If 'bounds' has more than one interval on its leading field and places no constraint on the
+ * remaining fields, returns the sequence of key ranges to seek to, one per leading interval.
+ * Otherwise returns an empty vector.
+ *
+ * Restricting batches to unbounded trailing fields keeps keysExamined the same as for a scan
+ * driven by IndexBoundsChecker: the only keys the checker looks at without returning them are
+ * then the first key past the end of each range, which the cursor counts as well.
+ */
+std::vector<SortedDataInterface::Cursor::SeekRange> makeSeekBatch(const IndexBounds& bounds,
+                                                                  const SortedDataInterface* sdi,
+                                                                  bool forward) {
+    std::vector<SortedDataInterface::Cursor::SeekRange> seekBatch;
+    if (bounds.fields.empty() || bounds.fields[0].intervals.size() < 2 ||
+        !std::all_of(bounds.fields.begin() + 1, bounds.fields.end(), isUnbounded)) {
+        return seekBatch;
+    }
+
+    // Reuse a single IndexBounds for each interval on the leading field so that the trailing
+    // fields are only copied once.
+    IndexBounds rangeBounds;
+    rangeBounds.fields.reserve(bounds.fields.size());
+    rangeBounds.fields.emplace_back(bounds.fields[0].name);
+    rangeBounds.fields.insert(
+        rangeBounds.fields.end(), bounds.fields.begin() + 1, bounds.fields.end());
+
+    seekBatch.reserve(bounds.fields[0].intervals.size());
+    for (const auto& interval : bounds.fields[0].intervals) {
+        rangeBounds.fields[0].intervals.assign(1, interval);
+
+        BSONObj startKey;
+        bool startKeyInclusive;
+        BSONObj endKey;
+        bool endKeyInclusive;
+        if (!IndexBoundsBuilder::isSingleInterval(
+                rangeBounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
+            return {};
+        }
+
+        seekBatch.push_back({IndexEntryComparison::makeKeyStringFromBSONKeyForSeek(
+                                 startKey,
+                                 sdi->getKeyStringVersion(),
+                                 sdi->getOrdering(),
+                                 forward,
+                                 startKeyInclusive),
+                             std::move(endKey),
+                             endKeyInclusive});
+    }
+    return seekBatch;
+}
+
+}  // namespace
 
 // static
 const char* IndexScan::kStageType = "IXSCAN";
@@ -123,20 +191,41 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
                 _forward,
                 _startKeyInclusive);
             return _indexCursor->seek(keyStringForSeek);
-        } else {
-            _checker.reset(new IndexBoundsChecker(&_bounds, _keyPattern, _direction));
+        }
 
-            if (!_checker->getStartSeekPoint(&_seekPoint))
-                return boost::none;
-            return _indexCursor->seek(IndexEntryComparison::makeKeyStringFromSeekPointForSeek(
-                _seekPoint,
-                indexAccessMethod()->getSortedDataInterface()->getKeyStringVersion(),
-                indexAccessMethod()->getSortedDataInterface()->getOrdering(),
-                _forward));
+        if (internalQueryEnableBatchedIndexSeeks.load()) {
+            auto seekBatch = makeSeekBatch(
+                _bounds, indexAccessMethod()->getSortedDataInterface(), _forward);
+            if (!seekBatch.empty()) {
+                _seekBatchRemaining = seekBatch.size();
+                _usingSeekBatch = true;
+                _indexCursor->setSeekBatch(std::move(seekBatch));
+                return seekNextInBatch();
+            }
         }
+
+        _checker.reset(new IndexBoundsChecker(&_bounds, _keyPattern, _direction));
+
+        if (!_checker->getStartSeekPoint(&_seekPoint))
+            return boost::none;
+        return _indexCursor->seek(IndexEntryComparison::makeKeyStringFromSeekPointForSeek(
+            _seekPoint,
+            indexAccessMethod()->getSortedDataInterface()->getKeyStringVersion(),
+            indexAccessMethod()->getSortedDataInterface()->getOrdering(),
+            _forward));
     }
 }
 
+boost::optional<IndexKeyEntry> IndexScan::seekNextInBatch() {
+    invariant(_seekBatchRemaining > 0);
+    auto kv = _indexCursor->seekNextInBatch();
+
+    // If the seek throws a WriteConflictException, this range is still to be visited when we are
+    // retried.
+    --_seekBatchRemaining;
+    return kv;
+}
+
 PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     // Get the next kv pair from the index, if any.
     boost::optional<IndexKeyEntry> kv;
@@ -156,6 +245,10 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
                     indexAccessMethod()->getSortedDataInterface()->getOrdering(),
                     _forward));
                 break;
+            case NEED_BATCH_SEEK:
+                ++_specificStats.seeks;
+                kv = seekNextInBatch();
+                break;
             case HIT_END:
                 return PlanStage::IS_EOF;
         }
@@ -184,7 +277,17 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
             dassert(_forward ? cmp <= 0 : cmp >= 0);
         }
 
-        ++_specificStats.keysExamined;
+        if (!_usingSeekBatch) {
+            ++_specificStats.keysExamined;
+        }
+    }
+
+    if (_usingSeekBatch) {
+        // The cursor also counts the keys it stops on past the end of each range, which are never
+        // returned to us.
+        const size_t keysExamined = _indexCursor->keysExaminedInSeekBatch();
+        _specificStats.keysExamined += keysExamined - _seekBatchKeysExamined;
+        _seekBatchKeysExamined = keysExamined;
     }
 
     if (kv && _checker) {
@@ -202,6 +305,12 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         }
     }
 
+    if (!kv && _seekBatchRemaining > 0) {
+        // Only the current range of the seek batch is exhausted.
+        _scanState = NEED_BATCH_SEEK;
+        return PlanStage::NEED_TIME;
+    }
+
     if (!kv) {
         _scanState = HIT_END;
         _commonStats.isEOF = true;
@@ -251,7 +360,7 @@ void IndexScan::doSaveStateRequiresIndex() {
     if (!_indexCursor)
         return;
 
-    if (_scanState == NEED_SEEK) {
+    if (_scanState == NEED_SEEK || _scanState == NEED_BATCH_SEEK) {
         _indexCursor->saveUnpositioned();
         return;
     }
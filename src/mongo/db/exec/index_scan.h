@@ -101,6 +101,9 @@ public:
         // Skipping keys as directed by the _checker.
         NEED_SEEK,
 
+        // Moving on to the next range of the batch of seeks submitted to the index cursor.
+        NEED_BATCH_SEEK,
+
         // Retrieving the next key, and applying the filter if necessary.
         GETTING_NEXT,
 
@@ -140,6 +143,12 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Positions the index cursor on the next range of the seek batch, returning its first entry
+     * if any.
+     */
+    boost::optional<IndexKeyEntry> seekNextInBatch();
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
@@ -184,6 +193,19 @@ private:
     std::unique_ptr<IndexBoundsChecker> _checker;
     IndexSeekPoint _seekPoint;
 
+    //
+    //    However, if each interval on the leading field of the bounds maps to a contiguous range
+    //    of index keys, as is the case for an $in over the leading field, the ranges are instead
+    //    handed to the index cursor as a single batch of seeks and _checker is NULL. The cursor
+    //    stops at the end of each range, and _seekBatchRemaining counts the ranges left to visit.
+    //    keysExamined is then taken from the cursor, since it looks at a key past the end of each
+    //    range without returning it.
+    //
+
+    bool _usingSeekBatch = false;
+    size_t _seekBatchRemaining = 0;
+    size_t _seekBatchKeysExamined = 0;
+
     //
     // 2) If the index scan is a single contiguous interval, then the scan can execute faster by
     //    letting the index cursor tell us when it hits the end, rather than repeatedly doing
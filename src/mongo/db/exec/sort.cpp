@@ -126,13 +126,16 @@ PlanStage::StageState SortStageDefault::unspool(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (!_addSortKeyMetadata) {
+        *out = _ws->emplace(_sortExecutor.getNextWithoutSortKey().extract());
+        return PlanStage::ADVANCED;
+    }
+
     auto&& [key, nextWsm] = _sortExecutor.getNext();
     *out = _ws->emplace(nextWsm.extract());
 
-    if (_addSortKeyMetadata) {
-        auto member = _ws->get(*out);
-        member->metadata().setSortKey(std::move(key), _sortKeyGen.isSingleElementKey());
-    }
+    auto member = _ws->get(*out);
+    member->metadata().setSortKey(std::move(key), _sortKeyGen.isSingleElementKey());
 
     return PlanStage::ADVANCED;
 }
@@ -168,17 +171,20 @@ PlanStage::StageState SortStageSimple::unspool(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    auto&& [key, nextObj] = _sortExecutor.getNext();
-
     *out = _ws->allocate();
     auto member = _ws->get(*out);
-    member->resetDocument(SnapshotId{}, nextObj.getOwned());
-    member->transitionToOwnedObj();
 
-    if (_addSortKeyMetadata) {
-        member->metadata().setSortKey(std::move(key), _sortKeyGen.isSingleElementKey());
+    if (!_addSortKeyMetadata) {
+        member->resetDocument(SnapshotId{}, _sortExecutor.getNextWithoutSortKey().getOwned());
+        member->transitionToOwnedObj();
+        return PlanStage::ADVANCED;
     }
 
+    auto&& [key, nextObj] = _sortExecutor.getNext();
+    member->resetDocument(SnapshotId{}, nextObj.getOwned());
+    member->transitionToOwnedObj();
+    member->metadata().setSortKey(std::move(key), _sortKeyGen.isSingleElementKey());
+
     return PlanStage::ADVANCED;
 }
 
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/sort_key_comparator.h"
@@ -36,6 +37,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 /**
@@ -47,16 +49,32 @@ namespace mongo {
  * The template parameter is the type of data being sorted. In DocumentSource execution, we sort
  * Document objects directly, but in the PlanStage layer we may sort WorkingSetMembers. The type of
  * the sort key, on the other hand, is always Value.
+ *
+ * Sort keys are encoded into KeyStrings once, as they are added, with each component inverted
+ * according to the direction of the sort pattern. The Sorter then orders them with a plain memcmp
+ * instead of a type-aware comparison of Values, and the keys are only decoded back into Values for
+ * the callers which ask for them. A KeyString can hold at most Ordering::kMaxCompoundIndexKeys
+ * components, so sort patterns with more components than that are sorted on their Values with a
+ * SortKeyComparator instead.
  */
 template <typename T>
 class SortExecutor {
 public:
-    using DocumentSorter = Sorter<Value, T>;
+    using DocumentSorter = Sorter<KeyString::Value, T>;
     class Comparator {
     public:
-        Comparator(const SortPattern& sortPattern) : _sortKeyComparator(sortPattern) {}
         int operator()(const typename DocumentSorter::Data& lhs,
                        const typename DocumentSorter::Data& rhs) const {
+            return lhs.first.compare(rhs.first);
+        }
+    };
+
+    using ValueSorter = Sorter<Value, T>;
+    class ValueComparator {
+    public:
+        ValueComparator(const SortPattern& sortPattern) : _sortKeyComparator(sortPattern) {}
+        int operator()(const typename ValueSorter::Data& lhs,
+                       const typename ValueSorter::Data& rhs) const {
             return _sortKeyComparator(lhs.first, rhs.first);
         }
 
@@ -73,6 +91,7 @@ public:
                  std::string tempDir,
                  bool allowDiskUse)
         : _sortPattern(std::move(sortPattern)),
+          _ordering(makeOrdering(_sortPattern)),
           _tempDir(std::move(tempDir)),
           _diskUseAllowed(allowDiskUse) {
         _stats.sortPattern =
@@ -123,10 +142,17 @@ public:
      * Should only be called before 'loadingDone()' is called.
      */
     void add(const Value& sortKey, const T& data) {
-        if (!_sorter) {
-            _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
+        if (!_ordering) {
+            if (!_valueSorter) {
+                _valueSorter.reset(makeValueSorter());
+            }
+            _valueSorter->add(sortKey, data);
+        } else {
+            if (!_sorter) {
+                _sorter.reset(makeSorter());
+            }
+            _sorter->emplace(encodeSortKey(sortKey), data.getOwned());
         }
-        _sorter->add(sortKey, data);
 
         _stats.totalDataSizeBytes += data.memUsageForSorter();
     }
@@ -135,9 +161,20 @@ public:
      * Signals to the sort executor that there will be no more input documents.
      */
     void loadingDone() {
-        // This conditional should only pass if no documents were added to the sorter.
+        // These conditionals should only pass if no documents were added to the sorter.
+        if (!_ordering) {
+            if (!_valueSorter) {
+                _valueSorter.reset(makeValueSorter());
+            }
+            _valueOutput.reset(_valueSorter->done());
+            _stats.keysSorted += _valueSorter->numSorted();
+            _stats.spills += _valueSorter->numSpills();
+            _valueSorter.reset();
+            return;
+        }
+
         if (!_sorter) {
-            _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
+            _sorter.reset(makeSorter());
         }
         _output.reset(_sorter->done());
         _stats.keysSorted += _sorter->numSorted();
@@ -154,8 +191,9 @@ public:
             return false;
         }
 
-        if (!_output->more()) {
+        if (!(_ordering ? _output->more() : _valueOutput->more())) {
             _output.reset();
+            _valueOutput.reset();
             _isEOF = true;
             return false;
         }
@@ -169,10 +207,97 @@ public:
      * end-of-stream must be detected with 'hasNext()'.
      */
     std::pair<Value, T> getNext() {
-        return _output->next();
+        if (!_ordering) {
+            return _valueOutput->next();
+        }
+        auto next = _output->next();
+        return {decodeSortKey(next.first), std::move(next.second)};
+    }
+
+    /**
+     * Like 'getNext()', but only returns the item being sorted, sparing the cost of decoding its
+     * sort key.
+     */
+    T getNextWithoutSortKey() {
+        return _ordering ? _output->next().second : _valueOutput->next().second;
     }
 
 private:
+    /**
+     * Returns the Ordering which sort keys are encoded with, or boost::none if 'sortPattern' has
+     * too many components for its keys to be encoded into KeyStrings.
+     */
+    static boost::optional<Ordering> makeOrdering(const SortPattern& sortPattern) {
+        if (sortPattern.size() >= Ordering::kMaxCompoundIndexKeys) {
+            return boost::none;
+        }
+
+        BSONObjBuilder directions;
+        for (auto&& part : sortPattern) {
+            directions.append(""_sd, part.isAscending ? 1 : -1);
+        }
+        return Ordering::make(directions.done());
+    }
+
+    /**
+     * Encodes 'sortKey' into a KeyString which compares with memcmp the way SortKeyComparator
+     * compares the Values. Compound sort keys are arrays with one element per component.
+     */
+    KeyString::Value encodeSortKey(const Value& sortKey) const {
+        BSONObjBuilder components;
+        const auto appendComponent = [&](const Value& component) {
+            // Missing and undefined are equivalent for sorting, but only the latter can be encoded.
+            if (component.missing()) {
+                components.appendUndefined(""_sd);
+            } else {
+                component.addToBsonObj(&components, ""_sd);
+            }
+        };
+
+        if (_sortPattern.isSingleElementKey()) {
+            appendComponent(sortKey);
+        } else {
+            for (auto&& component : sortKey.getArray()) {
+                appendComponent(component);
+            }
+        }
+
+        return KeyString::HeapBuilder(KeyString::Version::kLatestVersion,
+                                      components.done(),
+                                      *_ordering)
+            .release();
+    }
+
+    /**
+     * Restores the Value encoded by 'encodeSortKey()'. The TypeBits carried by the KeyString make
+     * this exact, except that a missing component comes back as undefined.
+     */
+    Value decodeSortKey(const KeyString::Value& encoded) const {
+        BSONObj components = KeyString::toBson(
+            encoded.getBuffer(), encoded.getSize(), *_ordering, encoded.getTypeBits());
+        if (_sortPattern.isSingleElementKey()) {
+            return Value(components.firstElement());
+        }
+
+        std::vector<Value> values;
+        values.reserve(_sortPattern.size());
+        for (auto&& component : components) {
+            values.emplace_back(component);
+        }
+        return Value(std::move(values));
+    }
+
+    DocumentSorter* makeSorter() const {
+        return DocumentSorter::make(
+            makeSortOptions(),
+            Comparator(),
+            {KeyString::Version::kLatestVersion, typename T::SorterDeserializeSettings()});
+    }
+
+    ValueSorter* makeValueSorter() const {
+        return ValueSorter::make(makeSortOptions(), ValueComparator(_sortPattern));
+    }
+
     SortOptions makeSortOptions() const {
         SortOptions opts;
         if (_stats.limit) {
@@ -189,12 +314,17 @@ private:
     }
 
     const SortPattern _sortPattern;
+    const boost::optional<Ordering> _ordering;
     const std::string _tempDir;
     const bool _diskUseAllowed;
 
     std::unique_ptr<DocumentSorter> _sorter;
     std::unique_ptr<typename DocumentSorter::Iterator> _output;
 
+    // Used instead of '_sorter' and '_output' when there is no '_ordering' to encode keys with.
+    std::unique_ptr<ValueSorter> _valueSorter;
+    std::unique_ptr<typename ValueSorter::Iterator> _valueOutput;
+
     SortStats _stats;
 
     bool _isEOF = false;
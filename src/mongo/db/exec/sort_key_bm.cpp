@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/sort_key_comparator.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kNumKeys = 100 * 1000;
+
+/**
+ * Generates sort keys shaped like those produced by SortKeyGenerator: a single Value for a one
+ * component sort pattern, or an array with one Value per component otherwise. Components
+ * alternate between numbers of different types and strings, as they would for a field of mixed
+ * type.
+ */
+std::vector<Value> makeSortKeys(size_t numComponents) {
+    std::mt19937_64 gen(1234);
+    const auto makeComponent = [&](size_t i) {
+        switch (gen() % 3) {
+            case 0:
+                return Value(static_cast<int>(gen() % 1000));
+            case 1:
+                return Value(static_cast<double>(gen() % 1000) / 7);
+            default:
+                return Value("key" + std::to_string(gen() % 1000) + std::to_string(i));
+        }
+    };
+
+    std::vector<Value> keys;
+    keys.reserve(kNumKeys);
+    for (size_t i = 0; i < kNumKeys; ++i) {
+        if (numComponents == 1) {
+            keys.push_back(makeComponent(i));
+            continue;
+        }
+        std::vector<Value> components;
+        for (size_t c = 0; c < numComponents; ++c) {
+            components.push_back(makeComponent(i));
+        }
+        keys.emplace_back(std::move(components));
+    }
+    return keys;
+}
+
+BSONObj makeSortPattern(size_t numComponents) {
+    BSONObjBuilder pattern;
+    for (size_t c = 0; c < numComponents; ++c) {
+        pattern.append("f" + std::to_string(c), c % 2 ? -1 : 1);
+    }
+    return pattern.obj();
+}
+
+KeyString::Value encodeSortKey(const Value& sortKey, const Ordering& ordering) {
+    BSONObjBuilder components;
+    if (sortKey.isArray()) {
+        for (auto&& component : sortKey.getArray()) {
+            component.addToBsonObj(&components, ""_sd);
+        }
+    } else {
+        sortKey.addToBsonObj(&components, ""_sd);
+    }
+    return KeyString::HeapBuilder(KeyString::Version::kLatestVersion, components.done(), ordering)
+        .release();
+}
+
+void BM_SortValuesWithComparator(benchmark::State& state, size_t numComponents) {
+    const auto keys = makeSortKeys(numComponents);
+    const SortKeyComparator comparator(makeSortPattern(numComponents));
+
+    for (auto _ : state) {
+        auto toSort = keys;
+        std::stable_sort(toSort.begin(), toSort.end(), [&](const Value& lhs, const Value& rhs) {
+            return comparator(lhs, rhs) < 0;
+        });
+        benchmark::DoNotOptimize(toSort.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_SortEncodedKeyStrings(benchmark::State& state, size_t numComponents) {
+    const auto keys = makeSortKeys(numComponents);
+    const auto ordering = Ordering::make(makeSortPattern(numComponents));
+
+    for (auto _ : state) {
+        // Encoding is part of the measured work, since the sort stages pay for it once per key.
+        std::vector<KeyString::Value> toSort;
+        toSort.reserve(keys.size());
+        for (auto&& key : keys) {
+            toSort.push_back(encodeSortKey(key, ordering));
+        }
+        std::stable_sort(toSort.begin(),
+                         toSort.end(),
+                         [](const KeyString::Value& lhs, const KeyString::Value& rhs) {
+                             return lhs.compare(rhs) < 0;
+                         });
+        benchmark::DoNotOptimize(toSort.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK_CAPTURE(BM_SortValuesWithComparator, SingleComponent, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SortEncodedKeyStrings, SingleComponent, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SortValuesWithComparator, ThreeComponents, 3)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SortEncodedKeyStrings, ThreeComponents, 3)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
@@ -304,4 +304,86 @@ TEST_F(SortStageDefaultTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+TEST_F(SortStageDefaultTest, SortCompoundKeyWithMixedTypesAndDirections) {
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             0,
+             "{input: [{a: 'x', b: 1}, {a: 2.5, b: 1}, {a: 2, b: 3}, {b: 1}, {a: null, b: 2}, "
+             "{a: NumberLong(2), b: 5}]}",
+             "{output: [{a: null, b: 2}, {b: 1}, {a: NumberLong(2), b: 5}, {a: 2, b: 3}, "
+             "{a: 2.5, b: 1}, {a: 'x', b: 1}]}");
+}
+
+TEST_F(SortStageDefaultTest, SortWithMoreComponentsThanAKeyStringCanEncode) {
+    // Only the last of the 33 components differs between the documents.
+    str::stream pattern;
+    str::stream prefix;
+    pattern << "{";
+    for (size_t i = 0; i < Ordering::kMaxCompoundIndexKeys; ++i) {
+        pattern << "f" << i << ": 1, ";
+        prefix << "f" << i << ": 1, ";
+    }
+    pattern << "last: -1}";
+
+    const std::string input = str::stream()
+        << "{input: [{" << std::string(prefix) << "last: 1}, {" << std::string(prefix)
+        << "last: 3}, {" << std::string(prefix) << "last: 2}]}";
+    const std::string output = str::stream()
+        << "{output: [{" << std::string(prefix) << "last: 3}, {" << std::string(prefix)
+        << "last: 2}, {" << std::string(prefix) << "last: 1}]}";
+    testWork(std::string(pattern).c_str(), nullptr, 0, input.c_str(), output.c_str());
+}
+
+TEST_F(SortStageDefaultTest, SortKeyMetadataPreservesComponentTypes) {
+    WorkingSet ws;
+    auto expCtx = make_intrusive<ExpressionContext>(opCtx(), nullptr, kNss);
+
+    auto queuedDataStage = std::make_unique<QueuedDataStage>(expCtx.get(), &ws);
+    for (auto&& obj : {BSON("a" << 1.5 << "b"
+                                << "y"),
+                       BSON("a" << 3LL << "b"
+                                << "x")}) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->doc = {SnapshotId(), Document{obj}};
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+
+    auto sortPattern = BSON("a" << -1 << "b" << 1);
+    auto sortKeyGen = std::make_unique<SortKeyGeneratorStage>(
+        expCtx, std::move(queuedDataStage), &ws, sortPattern);
+    SortStageDefault sort(expCtx,
+                          &ws,
+                          SortPattern{sortPattern, expCtx},
+                          0u,
+                          kMaxMemoryUsageBytes,
+                          true,  // addSortKeyMetadata
+                          std::move(sortKeyGen));
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    auto state = PlanStage::NEED_TIME;
+    while (state == PlanStage::NEED_TIME) {
+        state = sort.work(&id);
+    }
+
+    // The sort keys are stored encoded while sorting, but must be handed back with their original
+    // types.
+    std::vector<std::pair<BSONType, BSONType>> keyTypes;
+    while (state == PlanStage::ADVANCED) {
+        auto sortKey = ws.get(id)->metadata().getSortKey();
+        ASSERT_TRUE(sortKey.isArray());
+        ASSERT_EQ(sortKey.getArrayLength(), 2U);
+        keyTypes.emplace_back(sortKey[0].getType(), sortKey[1].getType());
+        state = sort.work(&id);
+    }
+    ASSERT_EQUALS(state, PlanStage::IS_EOF);
+
+    ASSERT_EQ(keyTypes.size(), 2U);
+    ASSERT_EQ(keyTypes[0].first, BSONType::NumberLong);
+    ASSERT_EQ(keyTypes[0].second, BSONType::String);
+    ASSERT_EQ(keyTypes[1].first, BSONType::NumberDouble);
+    ASSERT_EQ(keyTypes[1].second, BSONType::String);
+}
 }  // namespace
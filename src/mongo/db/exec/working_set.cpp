@@ -43,35 +43,41 @@ WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
-        // The free list is empty so we need to make a single new WSM to return. This relies on
-        // vector::resize being amortized O(1) for efficient allocation. Note that the free list
-        // remains empty until something is returned by a call to free().
-        WorkingSetID id = _data.size();
-        _data.resize(_data.size() + 1);
-        _data.back().nextFreeOrSelf = id;
+        // The free list is empty so we need to make a single new WSM to return. When the current
+        // chunk is full we add a chunk twice the size of the last one, which keeps allocation
+        // amortized O(1) without moving any existing members. Note that the free list remains
+        // empty until something is returned by a call to free().
+        WorkingSetID id = _size;
+        if (chunkIndex(id) == _chunks.size()) {
+            _chunks.push_back(std::make_unique<MemberHolder[]>(kFirstChunkSize << _chunks.size()));
+        }
+        ++_size;
+        holder(id).nextFreeOrSelf = id;
         return id;
     }
 
     // Pop the head off the free list and return it.
     WorkingSetID id = _freeList;
-    _freeList = _data[id].nextFreeOrSelf;
-    _data[id].nextFreeOrSelf = id;  // set to self to mark as in-use
+    MemberHolder& head = holder(id);
+    _freeList = head.nextFreeOrSelf;
+    head.nextFreeOrSelf = id;  // set to self to mark as in-use
     return id;
 }
 
 void WorkingSet::free(WorkingSetID i) {
-    MemberHolder& holder = _data[i];
-    verify(i < _data.size());            // ID has been allocated.
-    verify(holder.nextFreeOrSelf == i);  // ID currently in use.
+    verify(i < _size);  // ID has been allocated.
+    MemberHolder& memberHolder = holder(i);
+    verify(memberHolder.nextFreeOrSelf == i);  // ID currently in use.
 
     // Free resources and push this WSM to the head of the freelist.
-    holder.member.clear();
-    holder.nextFreeOrSelf = _freeList;
+    memberHolder.member.clear();
+    memberHolder.nextFreeOrSelf = _freeList;
     _freeList = i;
 }
 
 void WorkingSet::clear() {
-    _data.clear();
+    _chunks.clear();
+    _size = 0;
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
@@ -94,8 +100,8 @@ void WorkingSet::transitionToOwnedObj(WorkingSetID id) {
 }
 
 WorkingSetMember WorkingSet::extract(WorkingSetID wsid) {
-    invariant(wsid < _data.size());
-    WorkingSetMember ret = std::move(_data[wsid].member);
+    invariant(wsid < _size);
+    WorkingSetMember ret = std::move(holder(wsid).member);
     free(wsid);
     return ret;
 }
@@ -111,7 +117,9 @@ WorkingSetID WorkingSet::emplace(WorkingSetMember&& wsm) {
 //
 
 void WorkingSetMember::clear() {
-    _metadata = DocumentMetadataFields{};
+    if (_metadata) {
+        _metadata = DocumentMetadataFields{};
+    }
     keyData.clear();
     if (doc.value().hasExclusivelyOwnedStorage()) {
         // Reset the document to point to an empty BSON, which will preserve its underlying
@@ -30,6 +30,8 @@
 #pragma once
 
 #include "boost/optional.hpp"
+#include <boost/container/small_vector.hpp>
+#include <memory>
 #include <vector>
 
 #include "mongo/db/exec/document_value/document.h"
@@ -37,13 +39,21 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/platform/bits.h"
 #include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
 class IndexAccessMethod;
+struct IndexKeyDatum;
 class WorkingSetMember;
 
+/**
+ * The index keys attached to a WorkingSetMember. Only members produced by index intersection carry
+ * more than one key, so a single key is stored inline to avoid a heap allocation per index key.
+ */
+using IndexKeyDatumVector = boost::container::small_vector<IndexKeyDatum, 1>;
+
 typedef size_t WorkingSetID;
 
 /**
@@ -69,7 +79,7 @@ struct IndexKeyDatum {
      * object is populated if the element is in a provided index key.  Returns none otherwise.
      * Returning none indicates a query planning error.
      */
-    static boost::optional<BSONElement> getFieldDotted(const std::vector<IndexKeyDatum>& keyData,
+    static boost::optional<BSONElement> getFieldDotted(const IndexKeyDatumVector& keyData,
                                                        const std::string& field) {
         for (size_t i = 0; i < keyData.size(); ++i) {
             BSONObjIterator keyPatternIt(keyData[i].indexKeyPattern);
@@ -152,7 +162,7 @@ public:
 
     RecordId recordId;
     Snapshotted<Document> doc;
-    std::vector<IndexKeyDatum> keyData;
+    IndexKeyDatumVector keyData;
 
     bool hasRecordId() const;
     bool hasObj() const;
@@ -321,22 +331,22 @@ public:
      * release it.
      */
     WorkingSetMember* get(WorkingSetID i) {
-        dassert(i < _data.size());              // ID has been allocated.
-        dassert(_data[i].nextFreeOrSelf == i);  // ID currently in use.
-        return &_data[i].member;
+        dassert(i < _size);                      // ID has been allocated.
+        dassert(holder(i).nextFreeOrSelf == i);  // ID currently in use.
+        return &holder(i).member;
     }
 
     const WorkingSetMember* get(WorkingSetID i) const {
-        dassert(i < _data.size());              // ID has been allocated.
-        dassert(_data[i].nextFreeOrSelf == i);  // ID currently in use.
-        return &_data[i].member;
+        dassert(i < _size);                      // ID has been allocated.
+        dassert(holder(i).nextFreeOrSelf == i);  // ID currently in use.
+        return &holder(i).member;
     }
 
     /**
      * Returns true if WorkingSetMember with id 'i' is free.
      */
     bool isFree(WorkingSetID i) const {
-        return _data[i].nextFreeOrSelf != i;
+        return holder(i).nextFreeOrSelf != i;
     }
 
     /**
@@ -392,18 +402,41 @@ public:
 private:
     struct MemberHolder {
         // Free list link if freed. Points to self if in use.
-        WorkingSetID nextFreeOrSelf;
+        WorkingSetID nextFreeOrSelf = INVALID_ID;
 
         WorkingSetMember member;
     };
 
-    // All WorkingSetIDs are indexes into this, except for INVALID_ID.
-    // Elements are added to _freeList rather than removed when freed.
-    std::vector<MemberHolder> _data;
+    // Members live in chunks whose sizes double, starting from 'kFirstChunkSize'. Unlike a single
+    // vector, growing the working set never moves (or, since WorkingSetMember is not nothrow
+    // movable, copies) the members already allocated, and a member keeps its address for as long
+    // as its id is in use.
+    static constexpr size_t kFirstChunkSizeLog2 = 4;
+    static constexpr size_t kFirstChunkSize = size_t{1} << kFirstChunkSizeLog2;
+
+    static size_t chunkIndex(WorkingSetID i) {
+        return 63 - countLeadingZeros64(i + kFirstChunkSize) - kFirstChunkSizeLog2;
+    }
+
+    MemberHolder& holder(WorkingSetID i) {
+        const size_t chunk = chunkIndex(i);
+        return _chunks[chunk][i + kFirstChunkSize - (kFirstChunkSize << chunk)];
+    }
+
+    const MemberHolder& holder(WorkingSetID i) const {
+        const size_t chunk = chunkIndex(i);
+        return _chunks[chunk][i + kFirstChunkSize - (kFirstChunkSize << chunk)];
+    }
+
+    // All WorkingSetIDs below '_size' are indexes into '_chunks', except for INVALID_ID. Elements
+    // are added to _freeList rather than removed when freed, so they are pooled for reuse by later
+    // calls to allocate().
+    std::vector<std::unique_ptr<MemberHolder[]>> _chunks;
+    size_t _size = 0;
 
-    // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
+    // Index into _chunks, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
-    // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
+    // If _freeList == INVALID_ID, the free list is empty and all allocated elements are in use.
     WorkingSetID _freeList;
 
     // Holds IndexAccessMethods that have been registered with 'registerIndexAccessMethod()`. The
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/storage/snapshot.h"
+
+namespace mongo {
+namespace {
+
+// Produces one index key per iteration the way an index scan does, with the consumer freeing each
+// member as soon as it is returned so that the working set keeps recycling the same member.
+void BM_WorkingSetRecycleIndexKeys(benchmark::State& state) {
+    const BSONObj keyPattern = BSON("x" << 1);
+    const BSONObj key = BSON("" << 1);
+    WorkingSet ws;
+    int64_t i = 0;
+
+    for (auto _ : state) {
+        const WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->recordId = RecordId(++i);
+        member->keyData.emplace_back(keyPattern, key, 0, SnapshotId{});
+        ws.transitionToRecordIdAndIdx(id);
+        benchmark::DoNotOptimize(member);
+        ws.free(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Produces one document per iteration the way a collection scan does, freeing each member as soon
+// as it is returned.
+void BM_WorkingSetRecycleDocuments(benchmark::State& state) {
+    const BSONObj obj = BSON("_id" << 1 << "x" << 1);
+    WorkingSet ws;
+    int64_t i = 0;
+
+    for (auto _ : state) {
+        const WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->recordId = RecordId(++i);
+        member->resetDocument(SnapshotId{}, obj);
+        ws.transitionToRecordIdAndObj(id);
+        benchmark::DoNotOptimize(member);
+        ws.free(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Allocates 'state.range(0)' members that are all in use at once, as a blocking stage does, to
+// measure the cost of growing the working set.
+void BM_WorkingSetGrow(benchmark::State& state) {
+    const BSONObj keyPattern = BSON("x" << 1);
+    const BSONObj key = BSON("" << 1);
+
+    for (auto _ : state) {
+        WorkingSet ws;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            const WorkingSetID id = ws.allocate();
+            WorkingSetMember* member = ws.get(id);
+            member->recordId = RecordId(i + 1);
+            member->keyData.emplace_back(keyPattern, key, 0, SnapshotId{});
+            ws.transitionToRecordIdAndIdx(id);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_WorkingSetRecycleIndexKeys);
+BENCHMARK(BM_WorkingSetRecycleDocuments);
+BENCHMARK(BM_WorkingSetGrow)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+
+}  // namespace
+}  // namespace mongo
@@ -48,7 +48,7 @@
 namespace mongo {
 
 namespace {
-std::string indexKeyVectorDebugString(const std::vector<IndexKeyDatum>& keyData) {
+std::string indexKeyVectorDebugString(const IndexKeyDatumVector& keyData) {
     StringBuilder sb;
     sb << "[";
     if (keyData.size() > 0) {
@@ -77,7 +77,17 @@ bool WorkingSetCommon::fetch(OperationContext* opCtx,
     // state appropriately.
     invariant(member->hasRecordId());
 
-    auto record = cursor->seekExact(member->recordId);
+    return fetch(opCtx, workingSet, id, cursor->seekExact(member->recordId), ns);
+}
+
+bool WorkingSetCommon::fetch(OperationContext* opCtx,
+                             WorkingSet* workingSet,
+                             WorkingSetID id,
+                             boost::optional<Record> record,
+                             const NamespaceString& ns) {
+    WorkingSetMember* member = workingSet->get(id);
+    invariant(member->hasRecordId());
+
     if (!record) {
         // The record referenced by this index entry is gone. If the query yielded some time after
         // we first examined the index entry, then it's likely that the record was deleted while we
@@ -86,7 +96,7 @@ bool WorkingSetCommon::fetch(OperationContext* opCtx,
         // deleted.
         // One possibility is that the record was deleted by a prepared transaction, but if we are
         // not ignoring prepare conflicts, then this definitely indicates an error.
-        std::vector<IndexKeyDatum>::iterator keyDataIt;
+        IndexKeyDatumVector::iterator keyDataIt;
         if (member->getState() == WorkingSetMember::RID_AND_IDX &&
             opCtx->recoveryUnit()->getPrepareConflictBehavior() ==
                 PrepareConflictBehavior::kEnforce &&
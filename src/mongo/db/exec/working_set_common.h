@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/unowned_ptr.h"
 
 namespace mongo {
@@ -54,6 +55,16 @@ public:
                       WorkingSetID id,
                       unowned_ptr<SeekableRecordCursor> cursor,
                       const NamespaceString& ns);
+
+    /**
+     * As above, but uses 'record', which the caller has already looked up in the current snapshot,
+     * with boost::none meaning that there is no record with the member's RecordId.
+     */
+    static bool fetch(OperationContext* opCtx,
+                      WorkingSet* workingSet,
+                      WorkingSetID id,
+                      boost::optional<Record> record,
+                      const NamespaceString& ns);
 };
 
 }  // namespace mongo
@@ -313,4 +313,50 @@ TEST_F(WorkingSetFixture, WsmCanBeExtractedAndReinserted) {
     ASSERT_FALSE(emplacedWsm->metadata());
 }
 
+TEST(WorkingSetTest, MembersKeepTheirAddressWhileTheWorkingSetGrows) {
+    WorkingSet ws;
+    std::vector<std::pair<WorkingSetID, WorkingSetMember*>> members;
+    for (int i = 0; i < 1000; ++i) {
+        auto id = ws.allocate();
+        ASSERT_EQ(id, static_cast<WorkingSetID>(i));
+        auto member = ws.get(id);
+        member->recordId = RecordId{i};
+        members.emplace_back(id, member);
+    }
+
+    for (auto&& [id, member] : members) {
+        ASSERT_EQ(ws.get(id), member);
+        ASSERT_EQ(member->recordId.repr(), static_cast<int64_t>(id));
+    }
+}
+
+TEST(WorkingSetTest, FreedMembersAreReusedBeforeGrowing) {
+    WorkingSet ws;
+    std::vector<WorkingSetID> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids.push_back(ws.allocate());
+    }
+
+    // Free every other member, attaching an index key first so that we can check that a reused
+    // member comes back cleared.
+    for (size_t i = 0; i < ids.size(); i += 2) {
+        auto member = ws.get(ids[i]);
+        member->keyData.emplace_back(BSON("a" << 1), BSON("" << 1), 0u, SnapshotId{});
+        ws.transitionToRecordIdAndIdx(ids[i]);
+        ws.free(ids[i]);
+        ASSERT_TRUE(ws.isFree(ids[i]));
+    }
+
+    for (size_t i = 0; i < ids.size(); i += 2) {
+        auto id = ws.allocate();
+        ASSERT_LT(id, ids.size());
+        ASSERT_EQ(id % 2, 0u);
+        ASSERT_EQ(ws.get(id)->getState(), WorkingSetMember::INVALID);
+        ASSERT_TRUE(ws.get(id)->keyData.empty());
+    }
+
+    // The pool is exhausted, so the next allocation extends the working set.
+    ASSERT_EQ(ws.allocate(), ids.size());
+}
+
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include <utility>
 #include <vector>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/timestamp_block.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/storage/execution_context.h"
 #include "mongo/db/storage/storage_options.h"
@@ -84,11 +86,25 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
                        [](const MultikeyComponents& components) { return !components.empty(); });
 }
 
+/**
+ * Returns the format in which index build keys are spilled. The spilled data is persisted when a
+ * resumable index build is interrupted, and binaries older than 4.9 can only read it back in the
+ * v1 format. The v2 format is therefore only used once the featureCompatibilityVersion is 4.9.
+ */
+SorterChecksumVersionEnum sorterChecksumVersion() {
+    using FCVersion = ServerGlobalParams::FeatureCompatibility::Version;
+    const auto& fcv = serverGlobalParams.featureCompatibility;
+    return fcv.isVersionInitialized() && fcv.isGreaterThanOrEqualTo(FCVersion::kVersion49)
+        ? SorterChecksumVersionEnum::v2
+        : SorterChecksumVersionEnum::v1;
+}
+
 SortOptions makeSortOptions(size_t maxMemoryUsageBytes) {
     return SortOptions()
         .TempDir(storageGlobalParams.dbpath + "/_tmp")
         .ExtSortAllowed()
-        .MaxMemoryUsageBytes(maxMemoryUsageBytes);
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+        .ChecksumVersion(sorterChecksumVersion());
 }
 
 MultikeyPaths createMultikeyPaths(const std::vector<MultikeyPath>& multikeyPathsVec) {
@@ -196,6 +212,18 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
         *numInserted = 0;
     }
     // Add all new keys into the index. The RecordId for each is already encoded in the KeyString.
+    // Without a uniqueness constraint there is no duplicate key to retry, so the storage engine can
+    // apply the keys as one sorted batch.
+    if (!_descriptor->unique()) {
+        Status status = _newInterface->insertSorted(opCtx, keys, true /* dupsAllowed */);
+        if (!status.isOK())
+            return status;
+        if (numInserted) {
+            *numInserted = keys.size();
+        }
+        return Status::OK();
+    }
+
     for (const auto& keyString : keys) {
         bool unique = _descriptor->unique();
         Status status = _newInterface->insert(opCtx, keyString, !unique /* dupsAllowed */);
@@ -490,6 +518,12 @@ public:
                   const RecordId& loc,
                   const InsertDeleteOptions& options) final;
 
+    Status insert(OperationContext* opCtx,
+                  const BSONObj& obj,
+                  const RecordId& loc,
+                  const InsertDeleteOptions& options,
+                  const OnSkippedRecordFn& onSkippedRecord) final;
+
     void addToSorter(const KeyString::Value& keyString) final {
         _sorter->add(keyString, mongo::NullValue());
     }
@@ -508,9 +542,13 @@ public:
 
     Sorter::PersistedState persistDataForShutdown() final;
 
+    void mergeFrom(std::unique_ptr<BulkBuilder> other) final;
+
 private:
     void _insertMultikeyMetadataKeysIntoSorter();
 
+    void _mergeMultikeyPaths(const MultikeyPaths& multikeyPaths);
+
     Sorter* _makeSorter(
         size_t maxMemoryUsageBytes,
         boost::optional<StringData> fileName = boost::none,
@@ -519,9 +557,14 @@ private:
     Sorter::Settings _makeSorterSettings() const;
 
     IndexCatalogEntry* _indexCatalogEntry;
+    const size_t _maxMemoryUsageBytes;
     std::unique_ptr<Sorter> _sorter;
     int64_t _keysInserted = 0;
 
+    // Sorters taken over from other BulkBuilders by mergeFrom(). They are kept alive until this
+    // BulkBuilder is destroyed because the iterators they return from done() must not outlive them.
+    std::vector<std::unique_ptr<Sorter>> _mergedSorters;
+
     // Set to true if any document added to the BulkBuilder causes the index to become multikey.
     bool _isMultiKey = false;
 
@@ -544,12 +587,15 @@ std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initi
 
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(IndexCatalogEntry* index,
                                                             size_t maxMemoryUsageBytes)
-    : _indexCatalogEntry(index), _sorter(_makeSorter(maxMemoryUsageBytes)) {}
+    : _indexCatalogEntry(index),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _sorter(_makeSorter(maxMemoryUsageBytes)) {}
 
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(IndexCatalogEntry* index,
                                                             size_t maxMemoryUsageBytes,
                                                             const IndexStateInfo& stateInfo)
     : _indexCatalogEntry(index),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
       _sorter(_makeSorter(maxMemoryUsageBytes, stateInfo.getFileName(), stateInfo.getRanges())),
       _keysInserted(stateInfo.getNumKeys().value_or(0)),
       _isMultiKey(stateInfo.getIsMultikey()),
@@ -559,6 +605,18 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
                                                           const BSONObj& obj,
                                                           const RecordId& loc,
                                                           const InsertDeleteOptions& options) {
+    return insert(opCtx, obj, loc, options, [&](const RecordId& skippedLoc) {
+        _indexCatalogEntry->indexBuildInterceptor()->getSkippedRecordTracker()->record(opCtx,
+                                                                                      skippedLoc);
+    });
+}
+
+Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(
+    OperationContext* opCtx,
+    const BSONObj& obj,
+    const RecordId& loc,
+    const InsertDeleteOptions& options,
+    const OnSkippedRecordFn& onSkippedRecord) {
     auto& executionCtx = StorageExecutionContext::get(opCtx);
 
     auto keys = executionCtx.keys();
@@ -586,25 +644,14 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
                                 "error"_attr = status,
                                 "loc"_attr = loc,
                                 "obj"_attr = redact(obj));
-                    interceptor->getSkippedRecordTracker()->record(opCtx, loc);
+                    onSkippedRecord(loc);
                 }
             });
     } catch (...) {
         return exceptionToStatus();
     }
 
-    if (!multikeyPaths->empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = *multikeyPaths;
-        } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths->size());
-            for (size_t i = 0; i < multikeyPaths->size(); ++i) {
-                _indexMultikeyPaths[i].insert(boost::container::ordered_unique_range_t(),
-                                              (*multikeyPaths)[i].begin(),
-                                              (*multikeyPaths)[i].end());
-            }
-        }
-    }
+    _mergeMultikeyPaths(*multikeyPaths);
 
     for (const auto& keyString : *keys) {
         _sorter->add(keyString, mongo::NullValue());
@@ -629,7 +676,17 @@ bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
     _insertMultikeyMetadataKeysIntoSorter();
-    return _sorter->done();
+    if (_mergedSorters.empty()) {
+        return _sorter->done();
+    }
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iters;
+    iters.emplace_back(_sorter->done());
+    for (auto& sorter : _mergedSorters) {
+        iters.emplace_back(sorter->done());
+    }
+    return Sorter::Iterator::merge(
+        iters, makeSortOptions(_maxMemoryUsageBytes), BtreeExternalSortComparison());
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
@@ -639,9 +696,84 @@ int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
 AbstractIndexAccessMethod::BulkBuilder::Sorter::PersistedState
 AbstractIndexAccessMethod::BulkBuilderImpl::persistDataForShutdown() {
     _insertMultikeyMetadataKeysIntoSorter();
+
+    // Copies the keys persisted by a Sorter into 'target'. The Sorter may already have been
+    // finalized by done(), so its keys are read back from the data it persists.
+    auto copyKeys = [&](const Sorter::PersistedState& state, Sorter* target) {
+        std::unique_ptr<Sorter> persisted(
+            _makeSorter(_maxMemoryUsageBytes, StringData(state.fileName), state.ranges));
+        std::unique_ptr<Sorter::Iterator> it(persisted->done());
+        while (it->more()) {
+            target->add(it->next().first, mongo::NullValue());
+        }
+    };
+
+    if (!_mergedSorters.empty()) {
+        // A resumed index build restores a single Sorter, so the keys of all of our Sorters are
+        // copied into a new one before it is persisted.
+        std::unique_ptr<Sorter> combined(_makeSorter(_maxMemoryUsageBytes));
+        copyKeys(_sorter->persistDataForShutdown(), combined.get());
+        for (auto& sorter : _mergedSorters) {
+            copyKeys(sorter->persistDataForShutdown(), combined.get());
+        }
+        _mergedSorters.clear();
+        _sorter = std::move(combined);
+    }
+
+    auto state = _sorter->persistDataForShutdown();
+    if (sorterChecksumVersion() == SorterChecksumVersionEnum::v2 ||
+        std::none_of(state.ranges.begin(), state.ranges.end(), [](const SorterRange& range) {
+            return range.getChecksumVersion() == SorterChecksumVersionEnum::v2;
+        })) {
+        return state;
+    }
+
+    // The featureCompatibilityVersion was lowered after some keys were spilled in the v2 format,
+    // so they are rewritten in the v1 format for a downgraded binary to resume the build.
+    std::unique_ptr<Sorter> rewritten(_makeSorter(_maxMemoryUsageBytes));
+    copyKeys(state, rewritten.get());
+    _sorter = std::move(rewritten);
     return _sorter->persistDataForShutdown();
 }
 
+void AbstractIndexAccessMethod::BulkBuilderImpl::mergeFrom(std::unique_ptr<BulkBuilder> other) {
+    auto otherImpl = checked_cast<BulkBuilderImpl*>(other.get());
+    invariant(otherImpl->_indexCatalogEntry == _indexCatalogEntry);
+
+    _keysInserted += otherImpl->_keysInserted;
+    _isMultiKey = _isMultiKey || otherImpl->_isMultiKey;
+    _mergeMultikeyPaths(otherImpl->_indexMultikeyPaths);
+
+    // Multikey metadata keys are deduplicated across builders so that they are only inserted into
+    // the index once.
+    _multikeyMetadataKeys.insert(otherImpl->_multikeyMetadataKeys.begin(),
+                                 otherImpl->_multikeyMetadataKeys.end());
+
+    _mergedSorters.push_back(std::move(otherImpl->_sorter));
+    for (auto& sorter : otherImpl->_mergedSorters) {
+        _mergedSorters.push_back(std::move(sorter));
+    }
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::_mergeMultikeyPaths(
+    const MultikeyPaths& multikeyPaths) {
+    if (multikeyPaths.empty()) {
+        return;
+    }
+
+    if (_indexMultikeyPaths.empty()) {
+        _indexMultikeyPaths = multikeyPaths;
+        return;
+    }
+
+    invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
+    for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+        _indexMultikeyPaths[i].insert(boost::container::ordered_unique_range_t(),
+                                      multikeyPaths[i].begin(),
+                                      multikeyPaths[i].end());
+    }
+}
+
 void AbstractIndexAccessMethod::BulkBuilderImpl::_insertMultikeyMetadataKeysIntoSorter() {
     for (const auto& keyString : _multikeyMetadataKeys) {
         _sorter->add(keyString, mongo::NullValue());
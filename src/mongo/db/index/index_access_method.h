@@ -248,6 +248,20 @@ public:
                               const RecordId& loc,
                               const InsertDeleteOptions& options) = 0;
 
+        using OnSkippedRecordFn = std::function<void(const RecordId& loc)>;
+
+        /**
+         * Like insert(), except that a document whose key generation error was suppressed is
+         * passed to 'onSkippedRecord' instead of being recorded by the index build's
+         * SkippedRecordTracker. Recording it writes to a temporary table, so this allows keys to be
+         * generated by threads which do not hold the locks required for writes.
+         */
+        virtual Status insert(OperationContext* opCtx,
+                              const BSONObj& obj,
+                              const RecordId& loc,
+                              const InsertDeleteOptions& options,
+                              const OnSkippedRecordFn& onSkippedRecord) = 0;
+
         /**
          * Inserts the keyString directly into the sorter. No additional logic (related to multikey
          * paths, etc.) is performed.
@@ -274,6 +288,14 @@ public:
          * state of the underlying Sorter.
          */
         virtual Sorter::PersistedState persistDataForShutdown() = 0;
+
+        /**
+         * Takes over the keys, key count and multikey information accumulated by 'other', which
+         * must have been created by initiateBulk() on the same index and must not have been
+         * finalized. The keys of 'other' are merged with those of this BulkBuilder by done(), or
+         * copied into this BulkBuilder's Sorter by persistDataForShutdown().
+         */
+        virtual void mergeFrom(std::unique_ptr<BulkBuilder> other) = 0;
     };
 
     /**
@@ -33,19 +33,26 @@
 
 #include "mongo/db/introspect.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/introspect_gen.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/metadata/client_metadata.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -54,6 +61,201 @@ using std::endl;
 using std::string;
 using std::unique_ptr;
 
+namespace {
+
+Counter64 asyncEntriesQueued;
+Counter64 asyncEntriesDropped;
+Counter64 asyncEntriesWritten;
+Counter64 asyncEntriesFailed;
+Counter64 asyncBatchesWritten;
+
+ServerStatusMetricField<Counter64> asyncEntriesQueuedDisplay("profiler.asyncWrites.queued",
+                                                             &asyncEntriesQueued);
+ServerStatusMetricField<Counter64> asyncEntriesDroppedDisplay("profiler.asyncWrites.dropped",
+                                                              &asyncEntriesDropped);
+ServerStatusMetricField<Counter64> asyncEntriesWrittenDisplay("profiler.asyncWrites.written",
+                                                              &asyncEntriesWritten);
+ServerStatusMetricField<Counter64> asyncEntriesFailedDisplay("profiler.asyncWrites.failed",
+                                                             &asyncEntriesFailed);
+ServerStatusMetricField<Counter64> asyncBatchesWrittenDisplay("profiler.asyncWrites.batches",
+                                                              &asyncBatchesWritten);
+
+/**
+ * Inserts a batch of profiler entries into the system.profile collection of 'dbName', creating
+ * the collection if necessary. The caller must not participate in flow control.
+ */
+void insertProfileEntries(OperationContext* opCtx,
+                          const std::string& dbName,
+                          std::vector<InsertStatement>::const_iterator begin,
+                          std::vector<InsertStatement>::const_iterator end) {
+    const auto dbProfilingNS = NamespaceString(dbName, "system.profile");
+    writeConflictRetry(opCtx, "insertProfileEntries", dbProfilingNS.ns(), [&] {
+        AutoGetCollection autoColl(opCtx, dbProfilingNS, MODE_IX);
+        Database* const db = autoColl.getDb();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Database " << dbName << " no longer exists",
+                db);
+
+        uassertStatusOK(createProfileCollection(opCtx, db));
+        auto coll =
+            CollectionCatalog::get(opCtx)->lookupCollectionByNamespace(opCtx, dbProfilingNS);
+
+        WriteUnitOfWork wuow(opCtx);
+        OpDebug* const nullOpDebug = nullptr;
+        uassertStatusOK(coll->insertDocuments(opCtx, begin, end, nullOpDebug, false));
+        wuow.commit();
+    });
+}
+
+/**
+ * Buffers profiler entries in a bounded queue so that profiled operations do not have to write to
+ * system.profile themselves. A single background thread, started on first use, drains the queue
+ * and inserts the entries for each database in batches of up to 'profilerAsyncWriteBatchSize'
+ * documents. Entries which would overflow the queue are dropped rather than blocking the profiled
+ * operation.
+ */
+class ProfileWriter {
+public:
+    static ProfileWriter& get(ServiceContext* serviceContext);
+
+    ~ProfileWriter() {
+        shutdown();
+    }
+
+    /**
+     * Hands 'entry' to the background writer. Returns false if the entry was dropped because the
+     * buffer was full or the writer has been shut down.
+     */
+    bool enqueue(ServiceContext* serviceContext, std::string dbName, BSONObj entry) {
+        _startIfNeeded(serviceContext);
+        try {
+            if (_pipe.producer.tryPush({std::move(dbName), std::move(entry)})) {
+                asyncEntriesQueued.increment();
+                return true;
+            }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+        }
+        asyncEntriesDropped.increment();
+        return false;
+    }
+
+    /**
+     * Stops accepting new entries, waits for the buffered entries to be written and joins the
+     * background thread.
+     */
+    void shutdown() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_inShutdown) {
+                return;
+            }
+            _inShutdown = true;
+        }
+
+        _pipe.producer.close();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+private:
+    struct Entry {
+        std::string dbName;
+        BSONObj obj;
+    };
+
+    struct CostFunction {
+        size_t operator()(const Entry& entry) const {
+            return entry.dbName.size() + entry.obj.objsize();
+        }
+    };
+
+    using Queue = MultiProducerSingleConsumerQueue<Entry, CostFunction>;
+
+    static Queue::Options _makeQueueOptions() {
+        Queue::Options options;
+        options.maxQueueDepth = gProfilerAsyncWriteBufferSizeBytes;
+        return options;
+    }
+
+    void _startIfNeeded(ServiceContext* serviceContext) {
+        if (MONGO_likely(_started.load())) {
+            return;
+        }
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_started.load() || _inShutdown) {
+            return;
+        }
+        _thread = stdx::thread([this, serviceContext, consumer = std::move(_pipe.consumer)] {
+            _run(serviceContext, consumer);
+        });
+        _started.store(true);
+    }
+
+    void _run(ServiceContext* serviceContext, const Queue::Consumer& consumer) {
+        Client::initThread("ProfileWriter", serviceContext, nullptr);
+
+        while (true) {
+            std::deque<Entry> entries;
+            try {
+                entries = consumer.popMany().first;
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+                // The producer end was closed and every buffered entry has been written.
+                return;
+            }
+
+            stdx::unordered_map<std::string, std::vector<InsertStatement>> entriesByDb;
+            for (auto&& entry : entries) {
+                entriesByDb[entry.dbName].emplace_back(std::move(entry.obj));
+            }
+
+            auto opCtx = cc().makeOperationContext();
+            // The system.profile collection is non-replicated, so writes to it do not cause
+            // replication lag. As such, they should be excluded from Flow Control.
+            opCtx->setShouldParticipateInFlowControl(false);
+            // Entries buffered before shutdown should still be written out.
+            UninterruptibleLockGuard noInterrupt(opCtx->lockState());
+
+            const size_t batchSize = gProfilerAsyncWriteBatchSize.load();
+            for (const auto& [dbName, statements] : entriesByDb) {
+                for (auto begin = statements.begin(); begin != statements.end();) {
+                    auto end = begin + std::min<size_t>(batchSize, statements.end() - begin);
+                    try {
+                        insertProfileEntries(opCtx.get(), dbName, begin, end);
+                        asyncEntriesWritten.increment(end - begin);
+                        asyncBatchesWritten.increment();
+                    } catch (const DBException& ex) {
+                        asyncEntriesFailed.increment(end - begin);
+                        LOGV2_DEBUG(5034800,
+                                    1,
+                                    "Failed to write buffered profiler entries",
+                                    "db"_attr = dbName,
+                                    "numEntries"_attr = end - begin,
+                                    "error"_attr = redact(ex));
+                    }
+                    begin = end;
+                }
+            }
+        }
+    }
+
+    Mutex _mutex = MONGO_MAKE_LATCH("ProfileWriter::_mutex");
+    AtomicWord<bool> _started{false};
+    bool _inShutdown = false;
+
+    Queue::Pipe _pipe{_makeQueueOptions()};
+    stdx::thread _thread;
+};
+
+const auto getProfileWriter = ServiceContext::declareDecoration<ProfileWriter>();
+
+ProfileWriter& ProfileWriter::get(ServiceContext* serviceContext) {
+    return getProfileWriter(serviceContext);
+}
+
+}  // namespace
+
 void profile(OperationContext* opCtx, NetworkOp op) {
     // Initialize with 1kb at start in order to avoid realloc later
     BufBuilder profileBufBuilder(1024);
@@ -90,7 +292,13 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     const BSONObj p = b.done();
 
-    const string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
+    string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
+
+    if (gProfilerAsyncWrites.load()) {
+        auto serviceContext = opCtx->getServiceContext();
+        ProfileWriter::get(serviceContext).enqueue(serviceContext, std::move(dbName), p.getOwned());
+        return;
+    }
 
     auto origFlowControl = opCtx->shouldParticipateInFlowControl();
 
@@ -156,6 +364,10 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 }
 
 
+void shutdownProfileWriter(ServiceContext* serviceContext) {
+    ProfileWriter::get(serviceContext).shutdown();
+}
+
 Status createProfileCollection(OperationContext* opCtx, Database* db) {
     invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_IX));
     invariant(!opCtx->shouldParticipateInFlowControl());
@@ -36,12 +36,19 @@ namespace mongo {
 
 class Database;
 class OperationContext;
+class ServiceContext;
 
 /**
  * Invoked when database profile is enabled.
  */
 void profile(OperationContext* opCtx, NetworkOp op);
 
+/**
+ * Writes out any profiler entries buffered because of 'profilerAsyncWrites' and stops the
+ * background thread which inserts them. Entries profiled afterwards are dropped.
+ */
+void shutdownProfileWriter(ServiceContext* serviceContext);
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
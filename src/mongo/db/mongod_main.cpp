@@ -1305,6 +1305,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     LOGV2(4784928, "Shutting down the TTL monitor");
     shutdownTTLMonitor(serviceContext);
 
+    LOGV2(5034801, "Shutting down the profile writer");
+    shutdownProfileWriter(serviceContext);
+
     // We should always be able to acquire the global lock at shutdown.
     // An OperationContext is not necessary to call lockGlobal() during shutdown, as it's only used
     // to check that lockGlobal() is not called after a transaction timestamp has been set.
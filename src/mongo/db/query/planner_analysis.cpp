@@ -40,6 +40,10 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/indexability.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/logv2/log.h"
@@ -561,6 +565,153 @@ bool canUseSimpleSort(const QuerySolutionNode& solnRoot,
         && !splitLimitedSortEligible;
 }
 
+/**
+ * Returns true if 'expr' is a leaf over its own path for which the bounds builder can generate
+ * bounds on a btree index. Only such predicates may be passed to
+ * IndexBoundsBuilder::canUseCoveredMatching(), which fails on any other predicate.
+ */
+bool isBoundsGeneratingLeaf(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::GEO:
+        case MatchExpression::GEO_NEAR:
+        case MatchExpression::TEXT:
+        case MatchExpression::ELEM_MATCH_VALUE:
+            return false;
+        default:
+            return Indexability::nodeCanUseIndexOnOwnField(expr);
+    }
+}
+
+/**
+ * Returns true if 'expr' is an equality, range or $in predicate which compares against an array.
+ */
+bool isComparisonWithArray(const MatchExpression* expr) {
+    if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        return static_cast<const ComparisonMatchExpression*>(expr)->getData().type() ==
+            BSONType::Array;
+    }
+    if (MatchExpression::MATCH_IN == expr->matchType()) {
+        const auto& equalities = static_cast<const InMatchExpression*>(expr)->getEqualities();
+        return std::any_of(equalities.begin(), equalities.end(), [](BSONElement elt) {
+            return elt.type() == BSONType::Array;
+        });
+    }
+    return false;
+}
+
+/**
+ * Returns true if 'expr' can be evaluated against the index keys produced by 'ixn' with the same
+ * result as against the full document. Logical AND and OR nodes are allowed as long as all of their
+ * children qualify; every other node must be a bounds generating predicate over a path which the
+ * index provides exactly, and which the bounds builder deems safe for covered matching.
+ */
+bool isFilterCoveredByIndexScan(const MatchExpression* expr, const IndexScanNode& ixn) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!isFilterCoveredByIndexScan(expr->getChild(i), ixn)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::NOT: {
+            // A negation is covered only if it wraps a single covered leaf, e.g. {a: {$ne: 1}}. As
+            // in QueryPlannerIXSelect, negations whose bounds can't be inverted are rejected
+            // before they reach the bounds builder.
+            const auto* child = expr->getChild(0);
+            if (!Indexability::isBoundsGeneratingNot(expr) || !isBoundsGeneratingLeaf(child)) {
+                return false;
+            }
+            switch (child->matchType()) {
+                case MatchExpression::REGEX:
+                case MatchExpression::MOD:
+                case MatchExpression::TYPE_OPERATOR:
+                    return false;
+                case MatchExpression::EXISTS:
+                    // {$exists: false} can never be answered by a sparse index.
+                    if (ixn.index.sparse) {
+                        return false;
+                    }
+                    break;
+                case MatchExpression::MATCH_IN:
+                    if (!static_cast<const InMatchExpression*>(child)->getRegexes().empty()) {
+                        return false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            return !isComparisonWithArray(child) && ixn.hasField(child->path().toString()) &&
+                IndexBoundsBuilder::canUseCoveredMatching(expr, ixn.index);
+        }
+        default:
+            break;
+    }
+
+    // Predicates with no path, such as $expr or $where, can never be answered from the index keys,
+    // and neither can predicates such as $size or $bitsAllSet for which no bounds are generated.
+    // Note that hasField() is false for multikey paths and for fields with collation-encoded keys.
+    return isBoundsGeneratingLeaf(expr) && ixn.hasField(expr->path().toString()) &&
+        IndexBoundsBuilder::canUseCoveredMatching(expr, ixn.index);
+}
+
+/**
+ * Attempts to defer the FETCH at the root of 'solnRoot' until after a limited blocking sort. This
+ * applies when 'solnRoot' is a FETCH over an IXSCAN, the index provides every field of 'sortObj',
+ * and the FETCH filter (if any) can be evaluated against the index keys. The filter is then moved
+ * onto the IXSCAN, so the sort runs over index keys and record ids, and only the documents which
+ * survive the limit need to be fetched.
+ *
+ * Returns the new root of the tree. On success this is the unfetched IXSCAN; the caller is
+ * expected to add the sort, and analyzeDataAccess() will restore the FETCH above it.
+ */
+QuerySolutionNode* tryDeferFetchPastLimitedSort(const BSONObj& sortObj,
+                                                QuerySolutionNode* solnRoot) {
+    if (!internalQueryPlannerEnableSortLateMaterialization.load() ||
+        !isFetchNodeWithIndexScanChild(solnRoot)) {
+        return solnRoot;
+    }
+
+    auto fetch = static_cast<FetchNode*>(solnRoot);
+    auto ixn = static_cast<IndexScanNode*>(fetch->children[0]);
+    if (INDEX_BTREE != ixn->index.type) {
+        return solnRoot;
+    }
+
+    const bool sortIsCovered = std::all_of(sortObj.begin(), sortObj.end(), [ixn](BSONElement e) {
+        return ixn->hasField(e.fieldName());
+    });
+    if (!sortIsCovered) {
+        return solnRoot;
+    }
+
+    if (fetch->filter) {
+        // The slot-based execution engine cannot yet evaluate a filter attached to an index scan.
+        if (internalQueryEnableSlotBasedExecutionEngine.load() ||
+            !isFilterCoveredByIndexScan(fetch->filter.get(), *ixn)) {
+            return solnRoot;
+        }
+        if (ixn->filter) {
+            auto andExpr = std::make_unique<AndMatchExpression>();
+            andExpr->add(ixn->filter.release());
+            andExpr->add(fetch->filter.release());
+            ixn->filter = std::move(andExpr);
+        } else {
+            ixn->filter = std::move(fetch->filter);
+        }
+    }
+
+    LOGV2_DEBUG(5034700,
+                5,
+                "Deferring fetch until after limited sort",
+                "indexScan"_attr = redact(ixn->toString()));
+
+    fetch->children.clear();
+    delete fetch;
+    return ixn;
+}
+
 }  // namespace
 
 // static
@@ -806,6 +957,12 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
 
     // If we're here, we need to add a sort stage.
 
+    // A limited sort only returns a few of its inputs, so when the sort and any residual filter
+    // can be answered from the index keys it is cheaper to fetch after sorting than before.
+    if (qr.getLimit() || qr.getNToReturn()) {
+        solnRoot = tryDeferFetchPastLimitedSort(sortObj, solnRoot);
+    }
+
     if (!solnRoot->fetched()) {
         const bool sortIsCovered =
             std::all_of(sortObj.begin(), sortObj.end(), [solnRoot](BSONElement e) {
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
 #include "mongo/unittest/unittest.h"
@@ -847,6 +848,138 @@ TEST_F(QueryPlannerTest, SortSkipSoftLimit) {
         "{cscan: {dir: 1}}}}}}}}");
 }
 
+//
+// Late materialization of limited sorts over index scans
+//
+
+TEST_F(QueryPlannerTest, LimitedSortDefersFetchWhenFilterIsCoveredOnMultikeyIndex) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+
+    // Only 'c' is multikey, so the residual filter on 'b' can be evaluated against the index keys.
+    MultikeyPaths multikeyPaths{{}, {}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1), multikeyPaths);
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {a: {$gt: 1}, b: /foo/}, sort: {b: 1}, limit: 3}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: "
+        "{sort: {pattern: {b: 1}, limit: 3, type: 'default', node: "
+        "{ixscan: {pattern: {a: 1, b: 1, c: 1}, filter: {b: /foo/}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitedSortDefersFetchForHintedWholeIndexScan) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {b: {$gt: 5}}, sort: {b: 1}, hint: {a: 1, b: 1}, limit: 2}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: "
+        "{sort: {pattern: {b: 1}, limit: 2, type: 'default', node: "
+        "{ixscan: {pattern: {a: 1, b: 1}, filter: {b: {$gt: 5}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitedSortMustFetchFirstWhenFilterIsOnMultikeyPath) {
+    // 'c' is multikey, so the filter on 'c' must be evaluated against the full document.
+    MultikeyPaths multikeyPaths{{}, {}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1), multikeyPaths);
+
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {c: {$gt: 5}}, sort: {b: 1}, "
+                 "hint: {a: 1, b: 1, c: 1}, limit: 2}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 2, type: 'simple', node: "
+        "{fetch: {filter: {c: {$gt: 5}}, node: {ixscan: {pattern: {a: 1, b: 1, c: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, UnlimitedSortDoesNotDeferFetch) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {b: {$gt: 5}}, sort: {b: 1}, hint: {a: 1, b: 1}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 0, type: 'simple', node: "
+        "{fetch: {filter: {b: {$gt: 5}}, node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitedSortDoesNotDeferFetchWhenKnobIsDisabled) {
+    auto defaultValue = internalQueryPlannerEnableSortLateMaterialization.load();
+    ON_BLOCK_EXIT([&] { internalQueryPlannerEnableSortLateMaterialization.store(defaultValue); });
+    internalQueryPlannerEnableSortLateMaterialization.store(false);
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {b: {$gt: 5}}, sort: {b: 1}, hint: {a: 1, b: 1}, limit: 2}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 2, type: 'simple', node: "
+        "{fetch: {filter: {b: {$gt: 5}}, node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitedSortMustFetchFirstWhenFilterCannotGenerateBounds) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    // None of these predicates can be translated into index bounds, including the negations whose
+    // bounds can't be inverted, so they must be evaluated against the full document.
+    for (auto&& predicate : {"{$size: 2}",
+                             "{$bitsAllSet: 3}",
+                             "{$bitsAnyClear: [0, 1]}",
+                             "{$_internalSchemaMinLength: 2}",
+                             "{$geoWithin: {$box: [[0, 0], [1, 1]]}}",
+                             "{$not: {$size: 2}}",
+                             "{$not: /foo/}",
+                             "{$not: {$mod: [2, 0]}}",
+                             "{$nin: [/foo/, 1]}",
+                             "{$ne: [1, 2]}"}) {
+        clearState();
+        const std::string filter = str::stream() << "{b: " << predicate << "}";
+        runQueryAsCommand(fromjson(str::stream()
+                                   << "{find: 'testns', filter: " << filter
+                                   << ", sort: {b: 1}, hint: {a: 1, b: 1}, limit: 2}"));
+
+        assertNumSolutions(1U);
+        assertSolutionExists(str::stream()
+                             << "{sort: {pattern: {b: 1}, limit: 2, type: 'simple', node: "
+                                "{fetch: {filter: "
+                             << filter << ", node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}");
+    }
+}
+
+TEST_F(QueryPlannerTest, LimitedSortMustFetchFirstWhenResidualFilterIsSize) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {a: {$gt: 1}, b: {$size: 2}}, sort: {b: 1}, limit: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 1, type: 'simple', node: "
+        "{fetch: {filter: {b: {$size: 2}}, node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitedSortDefersFetchWhenFilterIsCoveredNegation) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {b: {$ne: 5}}, sort: {b: 1}, hint: {a: 1, b: 1}, limit: 2}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: "
+        "{sort: {pattern: {b: 1}, limit: 2, type: 'default', node: "
+        "{ixscan: {pattern: {a: 1, b: 1}, filter: {b: {$ne: 5}}}}}}}}");
+}
+
 // Push project behind sort even when there is a skip between them.
 TEST_F(QueryPlannerTest, PushProjectBehindSortWithSkipBetween) {
     runQueryAsCommand(fromjson(R"({
@@ -78,9 +78,11 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/transaction_coordinator_factory.h"
 #include "mongo/db/service_entry_point_common.h"
+#include "mongo/db/service_entry_point_common_gen.h"
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/stats/api_version_metrics.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/db/stats/server_read_concern_metrics.h"
 #include "mongo/db/stats/top.h"
@@ -99,10 +101,13 @@
 #include "mongo/rpc/op_msg.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/transport/hello_metrics.h"
+#include "mongo/transport/message_buffer_pool.h"
 #include "mongo/transport/session.h"
+#include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/text.h"
 
 namespace mongo {
 
@@ -130,6 +135,45 @@ namespace {
 
 using namespace fmt::literals;
 
+/**
+ * Decides how the operation competes with others for storage engine tickets when they run out.
+ * Heartbeat-like hello commands and internal clients go first, clients listed in
+ * 'ticketAdmissionLowPriorityClients' go last, and clients are otherwise distinguished by their
+ * application name, or else their user, so that one of them cannot take every ticket.
+ */
+void setTicketAdmission(OperationContext* opCtx,
+                        StringData appName,
+                        bool isInternalClient,
+                        bool isHello) {
+    auto& admission = TicketAdmission::get(opCtx);
+
+    std::string user;
+    auto userNames = AuthorizationSession::get(opCtx->getClient())->getAuthenticatedUserNames();
+    if (userNames.more()) {
+        user = userNames.next().getFullName();
+    }
+    admission.tenant = !appName.empty() ? appName.toString() : user;
+
+    if (isInternalClient || isHello) {
+        admission.priority = TicketAdmission::Priority::kHigh;
+        return;
+    }
+
+    admission.priority = TicketAdmission::Priority::kNormal;
+    const std::string lowPriorityClients = gTicketAdmissionLowPriorityClients.get();
+    if (lowPriorityClients.empty()) {
+        return;
+    }
+    StringSplitter splitter(lowPriorityClients.c_str(), ",");
+    while (splitter.more()) {
+        const std::string name = splitter.next();
+        if ((!appName.empty() && name == appName) || (!user.empty() && name == user)) {
+            admission.priority = TicketAdmission::Priority::kLow;
+            return;
+        }
+    }
+}
+
 /*
  * Allows for the very complex handleRequest function to be decomposed into parts.
  * It also provides the infrastructure to futurize the process of executing commands.
@@ -1316,10 +1360,12 @@ Future<void> ExecCommandDatabase::_initiateCommand() try {
 
     auto& apiParams = APIParameters::get(opCtx);
     auto& apiVersionMetrics = APIVersionMetrics::get(opCtx->getServiceContext());
+    std::string appName;
     if (auto clientMetadata = ClientMetadata::get(client)) {
-        auto appName = clientMetadata->getApplicationName().toString();
+        appName = clientMetadata->getApplicationName().toString();
         apiVersionMetrics.update(appName, apiParams);
     }
+    setTicketAdmission(opCtx, appName, _isInternalClient(), isHello());
 
     sleepMillisAfterCommandExecutionBegins.execute([&](const BSONObj& data) {
         auto numMillis = data["millis"].numberInt();
@@ -1845,8 +1891,14 @@ DbResponse makeCommandResponse(std::shared_ptr<HandleRequest::ExecutionContext>
 }
 
 Future<DbResponse> receivedCommands(std::shared_ptr<HandleRequest::ExecutionContext> execContext) {
-    execContext->setReplyBuilder(
-        rpc::makeReplyBuilder(rpc::protocolForMessage(execContext->getMessage())));
+    // Build the reply in a buffer recycled from an earlier message on the same session, if any.
+    SharedBuffer replyBuffer;
+    if (const auto& session = execContext->session()) {
+        replyBuffer = transport::MessageBufferPool::get(session).allocate(
+            BufBuilder::kDefaultInitSizeBytes);
+    }
+    execContext->setReplyBuilder(rpc::makeReplyBuilder(
+        rpc::protocolForMessage(execContext->getMessage()), std::move(replyBuffer)));
     return parseCommand(execContext)
         .then([execContext]() { return executeCommand(std::move(execContext)); })
         .onError([execContext](Status status) {
@@ -2275,6 +2327,32 @@ Future<void> HandleRequest::startOperation() try {
     return ex.toStatus();
 }
 
+/**
+ * Adds the costs of the completed operation to the statistics for its query shape, if it has one.
+ * A getMore is attributed to the shape of the operation which created its cursor.
+ */
+void recordQueryShapeStats(OperationContext* opCtx, CurOp& currentOp) {
+    const auto& debug = currentOp.debug();
+    if (!debug.queryHash || !opCtx->shouldIncrementLatencyStats()) {
+        return;
+    }
+
+    QueryShapeStats::Execution execution;
+    execution.nss = currentOp.getNSS();
+    execution.queryHash = *debug.queryHash;
+    execution.planCacheKey = debug.planCacheKey;
+    execution.isGetMore = debug.logicalOp == LogicalOp::opGetMore;
+    if (!execution.isGetMore) {
+        execution.command = currentOp.opDescription();
+    }
+    execution.latency = currentOp.elapsedTimeExcludingPauses();
+    execution.keysExamined = debug.additiveMetrics.keysExamined.value_or(0);
+    execution.docsExamined = debug.additiveMetrics.docsExamined.value_or(0);
+    execution.nreturned = std::max(debug.nreturned, 0LL);
+    execution.bytesReturned = std::max(debug.responseLength, 0);
+    QueryShapeStats::get(opCtx).record(execution);
+}
+
 Future<void> HandleRequest::completeOperation() try {
     auto opCtx = executionContext->getOpCtx();
     auto& currentOp = executionContext->currentOp();
@@ -2294,6 +2372,8 @@ Future<void> HandleRequest::completeOperation() try {
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
 
+    recordQueryShapeStats(opCtx, currentOp);
+
     if (shouldProfile) {
         // Performance profiling is on
         if (opCtx->lockState()->isReadLocked()) {
@@ -49,7 +49,8 @@
 #include "mongo/db/sorter/sorter.h"
 
 #include <boost/filesystem/operations.hpp>
-#include <snappy.h>
+#include <exception>
+#include <functional>
 #include <vector>
 
 #include "mongo/base/string_data.h"
@@ -61,6 +62,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/str.h"
@@ -142,6 +144,82 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+// Runs shorter than this many elements per thread are not worth handing to another thread.
+const size_t kMinParallelSortChunkLength = 16 * 1024;
+
+/**
+ * Runs each of 'tasks' to completion, all but the first on a thread of its own, and rethrows the
+ * first exception raised by any of them once every task has finished.
+ */
+template <typename Task>
+void runConcurrently(std::vector<Task>& tasks) {
+    std::vector<std::exception_ptr> errors(tasks.size());
+    std::vector<stdx::thread> threads;
+    threads.reserve(tasks.size());
+    for (size_t i = 1; i < tasks.size(); ++i) {
+        threads.emplace_back([&, i] {
+            try {
+                tasks[i]();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    try {
+        tasks.front()();
+    } catch (...) {
+        errors.front() = std::current_exception();
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (auto&& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * Stably sorts 'data' using up to 'maxThreads' threads. The range is cut into contiguous chunks
+ * which are sorted concurrently and then merged pairwise, each round of merges also running
+ * concurrently. Since both std::stable_sort and std::inplace_merge are stable and chunks are only
+ * ever merged with their neighbours, the result is identical to a single std::stable_sort.
+ */
+template <typename Container, typename Less>
+void parallelStableSort(Container& data, const Less& less, size_t maxThreads) {
+    const size_t numChunks = std::min(maxThreads, data.size() / kMinParallelSortChunkLength);
+    if (numChunks <= 1) {
+        std::stable_sort(data.begin(), data.end(), less);
+        return;
+    }
+
+    std::vector<typename Container::iterator> bounds;
+    bounds.reserve(numChunks + 1);
+    for (size_t i = 0; i <= numChunks; ++i) {
+        bounds.push_back(data.begin() + data.size() * i / numChunks);
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < numChunks; ++i) {
+        tasks.push_back([&, i] { std::stable_sort(bounds[i], bounds[i + 1], less); });
+    }
+    runConcurrently(tasks);
+
+    for (size_t width = 1; width < numChunks; width *= 2) {
+        tasks.clear();
+        for (size_t i = 0; i + width < numChunks; i += 2 * width) {
+            const auto first = bounds[i];
+            const auto middle = bounds[i + width];
+            const auto last = bounds[std::min(i + 2 * width, numChunks)];
+            tasks.push_back([=, &less] { std::inplace_merge(first, middle, last, less); });
+        }
+        runConcurrently(tasks);
+    }
+}
+
 /**
  * Returns results from sorted in-memory storage.
  */
@@ -197,13 +275,15 @@ public:
                  std::streampos fileStartOffset,
                  std::streampos fileEndOffset,
                  const Settings& settings,
-                 const uint32_t checksum)
+                 const uint32_t checksum,
+                 SorterChecksumVersionEnum checksumVersion)
         : _settings(settings),
           _done(false),
           _fileFullPath(fileFullPath),
           _fileStartOffset(fileStartOffset),
           _fileEndOffset(fileEndOffset),
-          _originalChecksum(checksum) {
+          _originalChecksum(checksum),
+          _checksumVersion(checksumVersion) {
         uassert(16815,
                 str::stream() << "unexpected empty file: " << _fileFullPath,
                 boost::filesystem::file_size(_fileFullPath) != 0);
@@ -262,18 +342,25 @@ public:
         auto first = Key::deserializeForSorter(*_bufferReader, _settings.first);
         auto second = Value::deserializeForSorter(*_bufferReader, _settings.second);
 
-        // The difference of _bufferReader's position before and after reading the data
-        // will provide the length of the data that was just read.
-        const char* endOfNewData = static_cast<const char*>(_bufferReader->pos());
+        // Ranges in the v2 format are checksummed a whole block at a time as they are read.
+        if (_checksumVersion == SorterChecksumVersionEnum::v1) {
+            // The difference of _bufferReader's position before and after reading the data
+            // will provide the length of the data that was just read.
+            const char* endOfNewData = static_cast<const char*>(_bufferReader->pos());
 
-        _afterReadChecksum =
-            addDataToChecksum(startOfNewData, endOfNewData - startOfNewData, _afterReadChecksum);
+            _afterReadChecksum = addDataToChecksum(
+                startOfNewData, endOfNewData - startOfNewData, _afterReadChecksum);
+        }
 
         return Data(std::move(first), std::move(second));
     }
 
     SorterRange getRange() const {
-        return {_fileStartOffset, _fileEndOffset, _originalChecksum};
+        SorterRange range{_fileStartOffset, _fileEndOffset, _originalChecksum};
+        // Leave the field out of v1 ranges so that binaries which predate it can still parse them.
+        if (_checksumVersion != SorterChecksumVersionEnum::v1)
+            range.setChecksumVersion(_checksumVersion);
+        return range;
     }
 
 private:
@@ -297,8 +384,11 @@ private:
         if (_done)
             return;
 
-        // negative size means compressed
+        // negative size means compressed, in the v1 format only
         const bool compressed = rawSize < 0;
+        uassert(5034905,
+                str::stream() << "invalid block size in file \"" << _fileFullPath << "\"",
+                !compressed || _checksumVersion == SorterChecksumVersionEnum::v1);
         int32_t blockSize = std::abs(rawSize);
 
         _buffer.reset(new char[blockSize]);
@@ -321,25 +411,24 @@ private:
             _buffer.swap(out);
         }
 
+        if (_checksumVersion == SorterChecksumVersionEnum::v2) {
+            // The block records its own codec, and its checksum is verified while decoding.
+            size_t decodedSize;
+            uint32_t blockChecksum;
+            _buffer = decodeSpillBlock(_buffer.get(), blockSize, &decodedSize, &blockChecksum);
+            _bufferReader.reset(new BufReader(_buffer.get(), decodedSize));
+            _afterReadChecksum = addBlockToChecksum(_afterReadChecksum, blockChecksum);
+            return;
+        }
+
         if (!compressed) {
             _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
             return;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
-
-        size_t uncompressedSize;
-        uassert(17061,
-                "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
-
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
-        uassert(17062,
-                "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
-
         // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
+        size_t uncompressedSize;
+        _buffer = uncompressV1SpillBlock(_buffer.get(), blockSize, &uncompressedSize);
         _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
     }
 
@@ -390,12 +479,20 @@ private:
     // to disk. This is not modified, and is only used for comparison against _afterReadChecksum
     // when the FileIterator is exhausted to ensure no data corruption.
     const uint32_t _originalChecksum;
+
+    // The format of the blocks in the range and of the checksum computed over them.
+    const SorterChecksumVersionEnum _checksumVersion;
 };
 
 /**
  * Merge-sorts results from 0 or more FileIterators, all of which should be iterating over sorted
  * ranges within the same file. This class is given the data source file name upon construction and
  * is responsible for deleting the data source file upon destruction.
+ *
+ * The inputs are merged with a tournament tree of losers. Each internal node remembers the input
+ * that lost the match played there, so replacing the winner only replays the matches on the path
+ * from its leaf to the root: exactly ceil(log2(k)) comparisons per result, compared to the up to
+ * 2*log2(k) of a binary heap sift-down.
  */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -409,39 +506,37 @@ public:
         : _opts(opts),
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
-          _greater(comp) {
+          _comp(comp) {
         for (size_t i = 0; i < iters.size(); i++) {
             iters[i]->openSource();
             if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                _streams.push_back(std::make_unique<Stream>(iters[i]->next(), iters[i]));
             } else {
                 iters[i]->closeSource();
             }
         }
 
-        if (_heap.empty()) {
+        _numLiveStreams = _streams.size();
+        if (_streams.empty()) {
             _remaining = 0;
             return;
         }
 
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
+        _tree.resize(_streams.size());
+        _tree[0] = _playSubtree(1);
     }
 
     ~MergeIterator() {
         // Clear the remaining Stream objects to close the file handles. Some systems will error
         // closing the file if any file handles are still open.
-        _current.reset();
-        _heap.clear();
+        _streams.clear();
     }
 
     void openSource() {}
     void closeSource() {}
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 && (_first || _numLiveStreams > 1 || _streams[_tree[0]]->more()))
             return true;
 
         _remaining = 0;
@@ -455,21 +550,19 @@ public:
 
         if (_first) {
             _first = false;
-            return _current->current();
+            return _streams[_tree[0]]->current();
         }
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        const size_t winner = _tree[0];
+        if (!_streams[winner]->advance()) {
+            // Destroying the exhausted Stream closes its source right away.
+            _streams[winner].reset();
+            _numLiveStreams--;
+            verify(_numLiveStreams > 0);
         }
+        _replay(winner);
 
-        return _current->current();
+        return _streams[_tree[0]]->current();
     }
 
 
@@ -483,8 +576,7 @@ private:
      */
     class Stream {
     public:
-        Stream(size_t fileNum, const Data& first, std::shared_ptr<Input> rest)
-            : fileNum(fileNum), _current(first), _rest(rest) {}
+        Stream(const Data& first, std::shared_ptr<Input> rest) : _current(first), _rest(rest) {}
 
         ~Stream() {
             _rest->closeSource();
@@ -504,37 +596,70 @@ private:
             return true;
         }
 
-        const size_t fileNum;
-
     private:
         Data _current;
         std::shared_ptr<Input> _rest;
     };
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
-    public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
-
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+    /**
+     * Returns true if the current value of stream 'lhs' should be returned before that of stream
+     * 'rhs'. Exhausted streams lose against everything, and ties are broken by the position of the
+     * stream among the inputs to keep the merge stable.
+     */
+    bool _beats(size_t lhs, size_t rhs) const {
+        if (!_streams[lhs])
+            return false;
+        if (!_streams[rhs])
+            return true;
+
+        dassertCompIsSane(_comp, _streams[lhs]->current(), _streams[rhs]->current());
+        int ret = _comp(_streams[lhs]->current(), _streams[rhs]->current());
+        if (ret)
+            return ret < 0;
+
+        return lhs < rhs;
+    }
+
+    /**
+     * Plays every match of the subtree rooted at 'node', recording the loser of each in '_tree',
+     * and returns the winning stream. Nodes [1, k) are internal and nodes [k, 2k) are the leaves
+     * holding the k streams, so the children of node n are always 2n and 2n + 1.
+     */
+    size_t _playSubtree(size_t node) {
+        const size_t numStreams = _streams.size();
+        if (node >= numStreams)
+            return node - numStreams;
+
+        const size_t left = _playSubtree(2 * node);
+        const size_t right = _playSubtree(2 * node + 1);
+        if (_beats(left, right)) {
+            _tree[node] = right;
+            return left;
         }
+        _tree[node] = left;
+        return right;
+    }
 
-    private:
-        const Comparator _comp;
-    };
+    /**
+     * Replays the matches between the leaf of 'stream', whose current value has changed, and the
+     * root, leaving the new overall winner in _tree[0].
+     */
+    void _replay(size_t stream) {
+        size_t winner = stream;
+        for (size_t node = (stream + _streams.size()) / 2; node > 0; node /= 2) {
+            if (_beats(_tree[node], winner))
+                std::swap(_tree[node], winner);
+        }
+        _tree[0] = winner;
+    }
 
     SortOptions _opts;
     unsigned long long _remaining;
     bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
+    const Comparator _comp;
+    std::vector<std::unique_ptr<Stream>> _streams;  // Exhausted streams are reset to null.
+    size_t _numLiveStreams = 0;
+    std::vector<size_t> _tree;  // _tree[0] is the winner, every other node holds a loser.
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -574,7 +699,9 @@ public:
                                range.getStartOffset(),
                                range.getEndOffset(),
                                this->_settings,
-                               range.getChecksum());
+                               range.getChecksum(),
+                               range.getChecksumVersion().value_or(
+                                   SorterChecksumVersionEnum::v1));
                        });
     }
 
@@ -636,7 +763,7 @@ private:
 
     void sort() {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        parallelStableSort(_data, less, this->_opts.parallelSortThreads);
         this->_numSorted += _data.size();
     }
 
@@ -1021,6 +1148,9 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
                                                const std::streampos fileStartOffset,
                                                const Settings& settings)
     : _settings(settings),
+      _compressor(opts.spillCompressor),
+      _compressionLevel(opts.spillCompressionLevel),
+      _checksumVersion(opts.checksumVersion),
       _fileFullPath(fileFullPath),
       // The file descriptor is positioned at the end of a file when opened in append mode, but
       // _file.tellp() is not initialized on all systems to reflect this. Therefore, we must also
@@ -1052,18 +1182,16 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
 
 template <typename Key, typename Value>
 void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value& val) {
-
-    // Offset that points to the place in the buffer where a new data object will be stored.
-    int _nextObjPos = _buffer.len();
-
-    // Add serialized key and value to the buffer.
+    // Add serialized key and value to the buffer. In the v2 format the checksum is computed a
+    // block at a time as the buffer is spilled.
+    const int startOfNewData = _buffer.len();
     key.serializeForSorter(_buffer);
     val.serializeForSorter(_buffer);
 
-    // Serializing the key and value grows the buffer, but _buffer.buf() still points to the
-    // beginning. Use _buffer.len() to determine portion of buffer containing new datum.
-    _checksum =
-        addDataToChecksum(_buffer.buf() + _nextObjPos, _buffer.len() - _nextObjPos, _checksum);
+    if (_checksumVersion == SorterChecksumVersionEnum::v1) {
+        _checksum = addDataToChecksum(
+            _buffer.buf() + startOfNewData, _buffer.len() - startOfNewData, _checksum);
+    }
 
     if (_buffer.len() > 64 * 1024)
         spill();
@@ -1071,20 +1199,26 @@ void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value&
 
 template <typename Key, typename Value>
 void SortedFileWriter<Key, Value>::spill() {
+    if (_buffer.len() == 0)
+        return;
+
     int32_t size = _buffer.len();
     char* outBuffer = _buffer.buf();
 
-    if (size == 0)
-        return;
-
-    std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
-    verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
+    std::string encoded;
+    bool v1Compressed = false;
+    if (_checksumVersion == SorterChecksumVersionEnum::v2) {
+        const uint32_t blockChecksum =
+            sorter::encodeSpillBlock(_compressor, _compressionLevel, outBuffer, size, &encoded);
+        _checksum = sorter::addBlockToChecksum(_checksum, blockChecksum);
+    } else {
+        v1Compressed = sorter::compressV1SpillBlock(outBuffer, size, &encoded);
+    }
+    verify(encoded.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
-    const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
-    if (shouldCompress) {
-        size = compressed.size();
-        outBuffer = const_cast<char*>(compressed.data());
+    if (_checksumVersion == SorterChecksumVersionEnum::v2 || v1Compressed) {
+        size = encoded.size();
+        outBuffer = const_cast<char*>(encoded.data());
     }
 
     std::unique_ptr<char[]> out;
@@ -1104,8 +1238,11 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
-    // negative size means compressed
-    size = shouldCompress ? -size : size;
+    // A v2 block records its own codec, so its size is always positive. A v1 block is negated when
+    // compressed.
+    if (v1Compressed)
+        size = -size;
+
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
         _file.write(outBuffer, std::abs(size));
@@ -1132,8 +1269,12 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _fileEndOffset = currentFileOffset < _fileStartOffset ? _fileStartOffset : currentFileOffset;
     _file.close();
 
-    return new sorter::FileIterator<Key, Value>(
-        _fileFullPath, _fileStartOffset, _fileEndOffset, _settings, _checksum);
+    return new sorter::FileIterator<Key, Value>(_fileFullPath,
+                                                _fileStartOffset,
+                                                _fileEndOffset,
+                                                _settings,
+                                                _checksum,
+                                                _checksumVersion);
 }
 
 //
@@ -39,6 +39,8 @@
 #include <vector>
 
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/sorter/sorter_codec.h"
+#include "mongo/db/sorter/sorter_codec_gen.h"
 #include "mongo/db/sorter/sorter_gen.h"
 #include "mongo/util/bufreader.h"
 
@@ -108,7 +110,30 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // Upper bound on the number of threads used to sort an in-memory run of an unlimited sort
+    // before it is returned or spilled. Defaults to the 'internalSorterParallelSortThreads' server
+    // parameter. Small runs are always sorted on the calling thread.
+    size_t parallelSortThreads;
+
+    // Codec used to compress the blocks spilled to disk, and its level for codecs which have
+    // levels. Default to the 'sorterSpillCompressor' and 'sorterSpillZstdCompressionLevel' server
+    // parameters. Spill files record the codec of each block, so readers need not be told.
+    SorterCompressorEnum spillCompressor;
+    int spillCompressionLevel;
+
+    // Format of the sorted data ranges written when spilling. Ranges which outlive the process,
+    // such as those of a resumable index build, must use v1 unless every binary which might read
+    // them back understands v2. The v1 format ignores 'spillCompressor' and always uses snappy.
+    SorterChecksumVersionEnum checksumVersion;
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          parallelSortThreads(gInternalSorterParallelSortThreads.load()),
+          spillCompressor(sorter::defaultSpillCompressor()),
+          spillCompressionLevel(gSorterSpillZstdCompressionLevel.load()),
+          checksumVersion(SorterChecksumVersionEnum::v2) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -131,6 +156,22 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& ParallelSortThreads(size_t newParallelSortThreads) {
+        parallelSortThreads = newParallelSortThreads;
+        return *this;
+    }
+
+    SortOptions& SpillCompressor(SorterCompressorEnum newSpillCompressor, int newLevel = 1) {
+        spillCompressor = newSpillCompressor;
+        spillCompressionLevel = newLevel;
+        return *this;
+    }
+
+    SortOptions& ChecksumVersion(SorterChecksumVersionEnum newChecksumVersion) {
+        checksumVersion = newChecksumVersion;
+        return *this;
+    }
 };
 
 /**
@@ -332,12 +373,16 @@ private:
     void spill();
 
     const Settings _settings;
+    const SorterCompressorEnum _compressor;
+    const int _compressionLevel;
+    const SorterChecksumVersionEnum _checksumVersion;
     std::string _fileFullPath;
     std::ofstream _file;
     BufBuilder _buffer;
 
-    // Keeps track of the hash of all data objects spilled to disk. Passed to the FileIterator
-    // to ensure data has not been corrupted after reading from disk.
+    // Keeps track of the checksums of all data spilled to disk, a block at a time in the v2 format
+    // and an object at a time in the v1 format. Passed to the FileIterator to ensure data has not
+    // been corrupted after reading from disk.
     uint32_t _checksum = 0;
 
     // Tracks where in the file we started and finished writing the sorted data range so that the
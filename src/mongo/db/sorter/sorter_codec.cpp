@@ -0,0 +1,246 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_codec.h"
+
+#include <algorithm>
+#include <limits>
+#include <snappy.h>
+#include <zstd.h>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/config.h"
+#include "mongo/db/sorter/sorter_codec_gen.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+#ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
+#include <wiredtiger.h>
+#endif
+
+namespace mongo {
+namespace sorter {
+namespace {
+
+// The codec tags written to spill files. These are persisted and must never be renumbered.
+enum class BlockCodec : uint8_t {
+    kNone = 0,
+    kSnappy = 1,
+    kZstd = 2,
+};
+
+// Every payload starts with the codec tag, the uncompressed length and the CRC32C of the
+// uncompressed data.
+constexpr size_t kCodecOffset = 0;
+constexpr size_t kUncompressedSizeOffset = kCodecOffset + sizeof(uint8_t);
+constexpr size_t kChecksumOffset = kUncompressedSizeOffset + sizeof(uint32_t);
+constexpr size_t kHeaderSize = kChecksumOffset + sizeof(uint32_t);
+
+#ifndef MONGO_CONFIG_WIREDTIGER_ENABLED
+/**
+ * Table for the bytewise software CRC32C used when WiredTiger's hardware accelerated
+ * implementation is not compiled in.
+ */
+struct Crc32cTable {
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+            }
+            entries[i] = crc;
+        }
+    }
+
+    uint32_t entries[256];
+};
+#endif
+
+std::unique_ptr<char[]> snappyUncompress(const char* data, size_t size, size_t* outSize) {
+    dassert(snappy::IsValidCompressedBuffer(data, size));
+
+    uassert(17061,
+            "couldn't get uncompressed length",
+            snappy::GetUncompressedLength(data, size, outSize));
+
+    std::unique_ptr<char[]> out(new char[*outSize]);
+    uassert(17062, "decompression failed", snappy::RawUncompress(data, size, out.get()));
+    return out;
+}
+
+}  // namespace
+
+Status validateSpillCompressor(const std::string& value) {
+    try {
+        SorterCompressor_parse(IDLParserErrorContext("sorterSpillCompressor"), value);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+    return Status::OK();
+}
+
+SorterCompressorEnum defaultSpillCompressor() {
+    // The parameter can only be set at startup, so it is parsed once.
+    static const SorterCompressorEnum compressor =
+        SorterCompressor_parse(IDLParserErrorContext("sorterSpillCompressor"),
+                               gSorterSpillCompressor);
+    return compressor;
+}
+
+uint32_t crc32c(const void* data, size_t size) {
+#ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
+    static const auto hardwareCrc32c = wiredtiger_crc32c_func();
+    return hardwareCrc32c(data, size);
+#else
+    static const Crc32cTable table;
+    uint32_t crc = 0xFFFFFFFF;
+    for (auto p = static_cast<const uint8_t*>(data); size--; ++p) {
+        crc = (crc >> 8) ^ table.entries[(crc ^ *p) & 0xFF];
+    }
+    return ~crc;
+#endif
+}
+
+uint32_t addBlockToChecksum(uint32_t checksum, uint32_t blockChecksum) {
+    char buf[2 * sizeof(uint32_t)];
+    DataView(buf).write<LittleEndian<uint32_t>>(checksum, 0);
+    DataView(buf).write<LittleEndian<uint32_t>>(blockChecksum, sizeof(uint32_t));
+    return crc32c(buf, sizeof(buf));
+}
+
+uint32_t encodeSpillBlock(SorterCompressorEnum compressor,
+                          int level,
+                          const char* data,
+                          size_t size,
+                          std::string* out) {
+    invariant(size <= std::numeric_limits<uint32_t>::max());
+
+    BlockCodec codec = BlockCodec::kNone;
+    size_t compressedSize = 0;
+    switch (compressor) {
+        case SorterCompressorEnum::kNone:
+            break;
+        case SorterCompressorEnum::kSnappy:
+            out->resize(kHeaderSize + snappy::MaxCompressedLength(size));
+            snappy::RawCompress(data, size, &(*out)[kHeaderSize], &compressedSize);
+            codec = BlockCodec::kSnappy;
+            break;
+        case SorterCompressorEnum::kZstd:
+            out->resize(kHeaderSize + ZSTD_compressBound(size));
+            compressedSize =
+                ZSTD_compress(&(*out)[kHeaderSize], out->size() - kHeaderSize, data, size, level);
+            uassert(5034900,
+                    str::stream() << "Failed to compress data: "
+                                  << ZSTD_getErrorName(compressedSize),
+                    !ZSTD_isError(compressedSize));
+            codec = BlockCodec::kZstd;
+            break;
+    }
+
+    // Only keep the compressed form if it is worth decompressing on the way back.
+    if (codec == BlockCodec::kNone || compressedSize >= size / 10 * 9) {
+        codec = BlockCodec::kNone;
+        out->resize(kHeaderSize);
+        out->append(data, size);
+    } else {
+        out->resize(kHeaderSize + compressedSize);
+    }
+
+    const uint32_t blockChecksum = crc32c(data, size);
+    DataView header(&(*out)[0]);
+    header.write<uint8_t>(static_cast<uint8_t>(codec), kCodecOffset);
+    header.write<LittleEndian<uint32_t>>(size, kUncompressedSizeOffset);
+    header.write<LittleEndian<uint32_t>>(blockChecksum, kChecksumOffset);
+    return blockChecksum;
+}
+
+std::unique_ptr<char[]> decodeSpillBlock(const char* data,
+                                         size_t size,
+                                         size_t* outSize,
+                                         uint32_t* blockChecksum) {
+    uassert(5034901, "Sorter spill file block is too short", size >= kHeaderSize);
+
+    ConstDataView header(data);
+    const auto codec = static_cast<BlockCodec>(header.read<uint8_t>(kCodecOffset));
+    const size_t uncompressedSize = header.read<LittleEndian<uint32_t>>(kUncompressedSizeOffset);
+    *blockChecksum = header.read<LittleEndian<uint32_t>>(kChecksumOffset);
+
+    const char* payload = data + kHeaderSize;
+    const size_t payloadSize = size - kHeaderSize;
+
+    std::unique_ptr<char[]> out;
+    switch (codec) {
+        case BlockCodec::kNone:
+            *outSize = payloadSize;
+            out.reset(new char[payloadSize]);
+            std::copy(payload, payload + payloadSize, out.get());
+            break;
+        case BlockCodec::kSnappy:
+            out = snappyUncompress(payload, payloadSize, outSize);
+            break;
+        case BlockCodec::kZstd: {
+            out.reset(new char[uncompressedSize]);
+            *outSize = ZSTD_decompress(out.get(), uncompressedSize, payload, payloadSize);
+            uassert(5034902,
+                    str::stream() << "Failed to decompress data: " << ZSTD_getErrorName(*outSize),
+                    !ZSTD_isError(*outSize));
+            break;
+        }
+        default:
+            uasserted(5034903,
+                      str::stream() << "Unknown Sorter spill file block codec: "
+                                    << static_cast<int>(codec));
+    }
+
+    if (*outSize != uncompressedSize || crc32c(out.get(), *outSize) != *blockChecksum) {
+        fassert(5034904,
+                Status(ErrorCodes::Error::ChecksumMismatch,
+                       "Data read from disk does not match what was written to disk. Possible "
+                       "corruption of data."));
+    }
+    return out;
+}
+
+bool compressV1SpillBlock(const char* data, size_t size, std::string* out) {
+    snappy::Compress(data, size, out);
+    if (out->size() < size / 10 * 9)
+        return true;
+    out->clear();
+    return false;
+}
+
+std::unique_ptr<char[]> uncompressV1SpillBlock(const char* data, size_t size, size_t* outSize) {
+    return snappyUncompress(data, size, outSize);
+}
+
+}  // namespace sorter
+}  // namespace mongo
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+enum class SorterCompressorEnum : std::int32_t;
+
+namespace sorter {
+
+/**
+ * Validator for the 'sorterSpillCompressor' server parameter.
+ */
+Status validateSpillCompressor(const std::string& value);
+
+/**
+ * Returns the codec selected by the 'sorterSpillCompressor' server parameter.
+ */
+SorterCompressorEnum defaultSpillCompressor();
+
+/**
+ * Returns the CRC32C of 'size' bytes at 'data'. Uses the hardware instruction when the platform
+ * provides one.
+ */
+uint32_t crc32c(const void* data, size_t size);
+
+/**
+ * Folds the checksum of one block into the running checksum of a sorted data range.
+ */
+uint32_t addBlockToChecksum(uint32_t checksum, uint32_t blockChecksum);
+
+/**
+ * Encodes 'size' bytes at 'data' as the payload of a spill file block, replacing the contents of
+ * 'out'. The data is compressed with 'compressor', at 'level' for codecs which have levels, unless
+ * that would save less than 10%. The payload starts with a header recording the codec actually
+ * used, the uncompressed length and its CRC32C, which is returned.
+ */
+uint32_t encodeSpillBlock(SorterCompressorEnum compressor,
+                          int level,
+                          const char* data,
+                          size_t size,
+                          std::string* out);
+
+/**
+ * Decodes a payload produced by encodeSpillBlock(), verifying its checksum. Returns the data,
+ * setting 'outSize' to its length and 'blockChecksum' to its CRC32C.
+ */
+std::unique_ptr<char[]> decodeSpillBlock(const char* data,
+                                         size_t size,
+                                         size_t* outSize,
+                                         uint32_t* blockChecksum);
+
+/**
+ * Compresses 'size' bytes at 'data' with snappy as the payload of a spill file block in the v1
+ * format, replacing the contents of 'out'. Returns false, leaving 'out' empty, if that would save
+ * less than 10%, in which case the block is written uncompressed.
+ */
+bool compressV1SpillBlock(const char* data, size_t size, std::string* out);
+
+/**
+ * Uncompresses the payload of a compressed spill file block written in the v1 format, where every
+ * compressed block used snappy and recorded no header of its own.
+ */
+std::unique_ptr<char[]> uncompressV1SpillBlock(const char* data, size_t size, size_t* outSize);
+
+}  // namespace sorter
+}  // namespace mongo
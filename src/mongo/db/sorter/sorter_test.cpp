@@ -34,6 +34,7 @@
 #include <boost/filesystem.hpp>
 #include <fstream>
 #include <memory>
+#include <snappy.h>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/static_assert.h"
@@ -222,6 +223,10 @@ std::shared_ptr<IWIterator> makeInMemIterator(const int (&array)[N]) {
     return std::make_shared<sorter::InMemIterator<IntWrapper, IntWrapper>>(vec);
 }
 
+std::shared_ptr<IWIterator> makeInMemIterator(const std::vector<IWPair>& vec) {
+    return std::make_shared<sorter::InMemIterator<IntWrapper, IntWrapper>>(vec);
+}
+
 template <typename IteratorPtr, int N>
 std::shared_ptr<IWIterator> mergeIterators(IteratorPtr (&array)[N],
                                            Direction Dir = ASC,
@@ -305,6 +310,33 @@ public:
 
             ASSERT_TRUE(boost::filesystem::remove(fileName));
         }
+        // every codec, over enough repetitive data for many compressible blocks
+        std::vector<IWPair> expected;
+        for (int i = 0; i < 100 * 1000; i++)
+            expected.push_back(IWPair(i / 1000, 0));
+        for (auto compressor : {SorterCompressorEnum::kNone,
+                                SorterCompressorEnum::kSnappy,
+                                SorterCompressorEnum::kZstd}) {
+            std::string fileName = opts.tempDir + "/" + nextFileName();
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(
+                SortOptions(opts).SpillCompressor(compressor, 3), fileName, 0);
+            for (auto&& pair : expected)
+                sorter.addAlreadySorted(pair.first, pair.second);
+
+            std::shared_ptr<IWIterator> iter(sorter.done());
+            const auto range = iter->getRange();
+            ASSERT(range.getChecksumVersion() == SorterChecksumVersionEnum::v2);
+            ASSERT_ITERATORS_EQUIVALENT(iter, makeInMemIterator(expected));
+
+            const auto fileSize = boost::filesystem::file_size(fileName);
+            if (compressor == SorterCompressorEnum::kNone) {
+                ASSERT_GT(fileSize, expected.size() * sizeof(IWPair));
+            } else {
+                ASSERT_LT(fileSize, expected.size() * sizeof(IWPair) / 4);
+            }
+
+            ASSERT_TRUE(boost::filesystem::remove(fileName));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
@@ -359,9 +391,74 @@ public:
                 mergeIterators(iterators, ASC, SortOptions().Limit(10)),
                 std::make_shared<LimitIterator>(10, std::make_shared<IntIterator>(0, 20, 1)));
         }
+        {  // test many sources of different lengths with equal keys, which must stay stable
+            const int kNumSources = 13;
+            std::vector<std::shared_ptr<IWIterator>> vec;
+            std::vector<IWPair> expected;
+            for (int i = 0; i < kNumSources; i++) {
+                std::vector<IWPair> source;
+                for (int key = 0; key < 2 * i + 1; key++)
+                    source.push_back(IWPair(key, i));
+                vec.push_back(makeInMemIterator(source));
+            }
+            for (int key = 0; key < 2 * kNumSources - 1; key++) {
+                for (int i = (key + 1) / 2; i < kNumSources; i++)
+                    expected.push_back(IWPair(key, i));
+            }
+
+            ASSERT_ITERATORS_EQUIVALENT(
+                std::shared_ptr<IWIterator>(IWIterator::merge(vec, SortOptions(), IWComparator())),
+                makeInMemIterator(expected));
+        }
     }
 };
 
+class ParallelSortTests {
+public:
+    void run() {
+        unittest::TempDir tempDir("parallelSortTests");
+        const SortOptions opts = SortOptions().ParallelSortThreads(4);
+
+        // Many duplicate keys, with values recording the insertion order. A stable sort must keep
+        // equal keys in insertion order, which ASSERT_ITERATORS_EQUIVALENT checks via the values.
+        std::vector<IWPair> input;
+        for (int i = 0; i < kNumItems; i++)
+            input.push_back(IWPair(i * 31 % 97, i));
+
+        for (Direction dir : {ASC, DESC}) {
+            std::vector<IWPair> expected = input;
+            std::stable_sort(expected.begin(), expected.end(), [&](const auto& a, const auto& b) {
+                return IWComparator(dir)(a, b) < 0;
+            });
+
+            {  // in memory
+                std::unique_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator(dir)));
+                for (auto&& pair : input)
+                    sorter->add(pair.first, pair.second);
+                ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter->done()),
+                                            makeInMemIterator(expected));
+                ASSERT_EQ(sorter->numSorted(), input.size());
+            }
+            {  // spilled runs, each large enough to be sorted on several threads
+                const SortOptions spillOpts =
+                    SortOptions(opts).TempDir(tempDir.path()).ExtSortAllowed().MaxMemoryUsageBytes(
+                        kNumItems * sizeof(IWPair) / 3);
+                std::unique_ptr<IWSorter> sorter(IWSorter::make(spillOpts, IWComparator(dir)));
+                for (auto&& pair : input)
+                    sorter->add(pair.first, pair.second);
+                ASSERT_GT(sorter->numSpills(), 1U);
+                ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter->done()),
+                                            makeInMemIterator(expected));
+            }
+        }
+
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+
+private:
+    static constexpr int kNumItems = 400 * 1000;
+};
+
 namespace SorterTests {
 class Basic {
 public:
@@ -662,6 +759,7 @@ public:
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
         add<MergeIteratorTests>();
+        add<ParallelSortTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
         add<SorterTests::Dupes>();
@@ -864,6 +962,72 @@ TEST_F(SorterMakeFromExistingRangesTest, RoundTrip) {
     }
 }
 
+TEST_F(SorterMakeFromExistingRangesTest, V1Range) {
+    unittest::TempDir tempDir(_agent.getSuiteName() + "_" + _agent.getTestName());
+
+    // Write a range in the format used before blocks recorded their own codec: a snappy block
+    // marked by a negative size, and a MurmurHash3 checksum accumulated over each object.
+    BufBuilder raw;
+    uint32_t checksum = 0;
+    for (int i = 0; i < 1000; i++) {
+        const int start = raw.len();
+        IntWrapper(i).serializeForSorter(raw);
+        IntWrapper(-i).serializeForSorter(raw);
+        checksum = addDataToChecksum(raw.buf() + start, raw.len() - start, checksum);
+    }
+    std::string compressed;
+    snappy::Compress(raw.buf(), raw.len(), &compressed);
+    const int32_t size = -static_cast<int32_t>(compressed.size());
+
+    auto tempFilePath = boost::filesystem::path(tempDir.path()) / "v1_sorter_file";
+    {
+        std::ofstream ofs(tempFilePath.string(), std::ios::binary);
+        ASSERT(ofs) << "failed to create temporary file: " << tempFilePath.string();
+        ofs.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        ofs.write(compressed.data(), compressed.size());
+    }
+
+    // Ranges persisted by older versions do not have a checksumVersion.
+    std::vector<SorterRange> ranges{
+        {0, static_cast<long long>(sizeof(size) + compressed.size()), checksum}};
+    auto fileName = tempFilePath.filename().string();
+    auto opts = SortOptions().ExtSortAllowed().TempDir(tempDir.path());
+    auto sorter = std::unique_ptr<IWSorter>(
+        IWSorter::makeFromExistingRanges(fileName, ranges, opts, IWComparator(ASC)));
+
+    // Reading the range to the end also verifies its checksum when the source is closed.
+    ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter->done()),
+                                std::make_shared<IntIterator>(0, 1000));
+}
+
+TEST_F(SorterMakeFromExistingRangesTest, V1RangeWrittenForDowngrade) {
+    unittest::TempDir tempDir(_agent.getSuiteName() + "_" + _agent.getTestName());
+    auto opts = SortOptions()
+                    .ExtSortAllowed()
+                    .TempDir(tempDir.path())
+                    .ChecksumVersion(SorterChecksumVersionEnum::v1);
+
+    // Enough repetitive data for several compressible blocks, so that both block sizes are used.
+    auto fileName = std::string("v1_sorter_file");
+    SortedFileWriter<IntWrapper, IntWrapper> writer(opts, opts.tempDir + "/" + fileName, 0);
+    for (int i = 0; i < 100 * 1000; i++)
+        writer.addAlreadySorted(i / 1000, 0);
+    std::unique_ptr<IWIterator> written(writer.done());
+
+    // Binaries which predate v2 reject ranges recording a checksumVersion.
+    const auto range = written->getRange();
+    ASSERT_FALSE(range.getChecksumVersion());
+    ASSERT_FALSE(range.toBSON().hasField(SorterRange::kChecksumVersionFieldName));
+
+    std::vector<IWPair> expected;
+    for (int i = 0; i < 100 * 1000; i++)
+        expected.push_back(IWPair(i / 1000, 0));
+    auto sorter = std::unique_ptr<IWSorter>(
+        IWSorter::makeFromExistingRanges(fileName, {range}, opts, IWComparator(ASC)));
+    ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter->done()),
+                                makeInMemIterator(expected));
+}
+
 }  // namespace
 }  // namespace sorter
 }  // namespace mongo
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+namespace {
+
+const auto getQueryShapeStats = ServiceContext::declareDecoration<QueryShapeStats>();
+
+// Commands larger than this are not retained as the representative command of their shape, to
+// keep the memory used by each entry small.
+constexpr int kMaxRepresentativeCommandBytes = 4 * 1024;
+
+long long getLatencyBucketLowerBound(size_t bucket) {
+    return bucket == 0 ? 0 : 1LL << (bucket - 1);
+}
+
+}  // namespace
+
+QueryShapeStats& QueryShapeStats::get(ServiceContext* svcCtx) {
+    return getQueryShapeStats(svcCtx);
+}
+
+QueryShapeStats& QueryShapeStats::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+size_t QueryShapeStats::getLatencyBucket(Microseconds latency) {
+    const auto micros = durationCount<Microseconds>(latency);
+    if (micros <= 0) {
+        return 0;
+    }
+    const size_t bucket = 64 - countLeadingZeros64(micros);
+    return std::min(bucket, kNumLatencyBuckets - 1);
+}
+
+void QueryShapeStats::record(const Execution& execution) {
+    const auto capacity = static_cast<size_t>(internalQueryShapeStatsCapacity.load());
+    if (capacity == 0) {
+        return;
+    }
+    const size_t stripeCapacity = (capacity + kNumStripes - 1) / kNumStripes;
+
+    Key key{execution.nss, execution.queryHash};
+    const auto now = Date_t::now();
+    auto& stripe = _stripes[execution.queryHash % kNumStripes];
+
+    stdx::lock_guard<Mutex> lk(stripe.mutex);
+    auto it = stripe.entries.find(key);
+    if (it == stripe.entries.end()) {
+        // Make room for the new shape by evicting the least recently executed ones. There may be
+        // more than one to evict if the capacity was lowered since the stripe was filled.
+        while (stripe.entries.size() >= stripeCapacity) {
+            auto oldest = std::min_element(
+                stripe.entries.begin(), stripe.entries.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.second.lastSeen < rhs.second.lastSeen;
+                });
+            stripe.entries.erase(oldest);
+            ++stripe.numEvictions;
+        }
+        it = stripe.entries.emplace(std::move(key), Entry{}).first;
+        it->second.firstSeen = now;
+    }
+
+    auto& entry = it->second;
+    entry.lastSeen = now;
+    if (execution.planCacheKey) {
+        entry.planCacheKey = execution.planCacheKey;
+    }
+    if (execution.isGetMore) {
+        ++entry.getMoreCount;
+    } else {
+        ++entry.execCount;
+        if (entry.representativeCommand.isEmpty() &&
+            execution.command.objsize() <= kMaxRepresentativeCommandBytes) {
+            entry.representativeCommand = execution.command.getOwned();
+        }
+    }
+
+    const auto micros = durationCount<Microseconds>(execution.latency);
+    entry.totalMicros += micros;
+    entry.maxMicros = std::max(entry.maxMicros, micros);
+    ++entry.latencyBuckets[getLatencyBucket(execution.latency)];
+
+    entry.keysExamined += execution.keysExamined;
+    entry.docsExamined += execution.docsExamined;
+    entry.nreturned += execution.nreturned;
+    entry.bytesReturned += execution.bytesReturned;
+}
+
+std::vector<BSONObj> QueryShapeStats::getStats() const {
+    std::vector<BSONObj> stats;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<Mutex> lk(stripe.mutex);
+        for (auto&& [key, entry] : stripe.entries) {
+            BSONObjBuilder builder;
+            entry.append(key, &builder);
+            stats.push_back(builder.obj());
+        }
+    }
+    return stats;
+}
+
+void QueryShapeStats::clear() {
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<Mutex> lk(stripe.mutex);
+        stripe.entries.clear();
+    }
+}
+
+size_t QueryShapeStats::size() const {
+    size_t size = 0;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<Mutex> lk(stripe.mutex);
+        size += stripe.entries.size();
+    }
+    return size;
+}
+
+long long QueryShapeStats::numEvictions() const {
+    long long numEvictions = 0;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<Mutex> lk(stripe.mutex);
+        numEvictions += stripe.numEvictions;
+    }
+    return numEvictions;
+}
+
+void QueryShapeStats::Entry::append(const Key& key, BSONObjBuilder* builder) const {
+    builder->append("ns", key.nss.ns());
+    builder->append("queryHash", zeroPaddedHex(key.queryHash));
+    if (planCacheKey) {
+        builder->append("planCacheKey", zeroPaddedHex(*planCacheKey));
+    }
+    builder->append("representativeCommand", representativeCommand);
+    builder->append("firstSeen", firstSeen);
+    builder->append("lastSeen", lastSeen);
+    builder->append("execCount", execCount);
+    builder->append("getMoreCount", getMoreCount);
+
+    BSONObjBuilder latencyBuilder(builder->subobjStart("latency"));
+    latencyBuilder.append("totalMicros", totalMicros);
+    latencyBuilder.append("maxMicros", maxMicros);
+    BSONArrayBuilder histogramBuilder(latencyBuilder.subarrayStart("histogram"));
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+        // Only report non-empty buckets, to keep the output small.
+        if (latencyBuckets[i] == 0) {
+            continue;
+        }
+        BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+        entryBuilder.append("micros", getLatencyBucketLowerBound(i));
+        entryBuilder.append("count", latencyBuckets[i]);
+    }
+    histogramBuilder.doneFast();
+    latencyBuilder.doneFast();
+
+    builder->append("keysExamined", keysExamined);
+    builder->append("docsExamined", docsExamined);
+    builder->append("nreturned", nreturned);
+    builder->append("bytesReturned", bytesReturned);
+}
+
+}  // namespace mongo
@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * QueryShapeStats accumulates execution statistics per query shape, so that the most expensive
+ * shapes can be identified without enabling the profiler. A shape is identified by its namespace
+ * and its query hash, which is the hash of the stable portion of the PlanCacheKey.
+ *
+ * The store is bounded by the 'internalQueryShapeStatsCapacity' knob. Entries are spread across a
+ * fixed number of independently locked stripes so that concurrent operations on different shapes
+ * rarely contend, and each stripe holds an equal share of the capacity (rounded up). When a stripe
+ * is full, the shape which was least recently executed is evicted.
+ */
+class QueryShapeStats {
+public:
+    static constexpr size_t kNumStripes = 16;
+
+    // Latencies are bucketed by powers of two microseconds. Bucket 0 holds executions which took
+    // no measurable time, and bucket i > 0 holds latencies in [2^(i-1), 2^i) microseconds, except
+    // that the last bucket has no upper bound.
+    static constexpr size_t kNumLatencyBuckets = 32;
+
+    static QueryShapeStats& get(ServiceContext* svcCtx);
+    static QueryShapeStats& get(OperationContext* opCtx);
+
+    /**
+     * Describes a completed execution of an operation with a query shape.
+     */
+    struct Execution {
+        NamespaceString nss;
+        uint32_t queryHash = 0;
+        boost::optional<uint32_t> planCacheKey;
+
+        // True for a getMore on a cursor created by an operation with this shape. Its costs are
+        // added to the shape, but it does not count as a separate execution.
+        bool isGetMore = false;
+
+        // The command which produced this execution. Only retained for the first non-getMore
+        // execution of each shape.
+        BSONObj command;
+
+        Microseconds latency{0};
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    /**
+     * Adds 'execution' to the statistics for its shape, creating an entry if necessary. Does
+     * nothing when the capacity knob is zero.
+     */
+    void record(const Execution& execution);
+
+    /**
+     * Returns one document per shape, in no particular order.
+     */
+    std::vector<BSONObj> getStats() const;
+
+    /**
+     * Removes every entry.
+     */
+    void clear();
+
+    /**
+     * Returns the number of shapes currently tracked.
+     */
+    size_t size() const;
+
+    /**
+     * Returns the number of shapes evicted to make room for new ones.
+     */
+    long long numEvictions() const;
+
+    /**
+     * Returns the index of the latency bucket for 'latency'.
+     */
+    static size_t getLatencyBucket(Microseconds latency);
+
+private:
+    struct Key {
+        bool operator==(const Key& other) const {
+            return queryHash == other.queryHash && nss == other.nss;
+        }
+
+        template <typename H>
+        friend H AbslHashValue(H h, const Key& key) {
+            return H::combine(std::move(h), key.nss, key.queryHash);
+        }
+
+        NamespaceString nss;
+        uint32_t queryHash;
+    };
+
+    struct Entry {
+        void append(const Key& key, BSONObjBuilder* builder) const;
+
+        boost::optional<uint32_t> planCacheKey;
+        BSONObj representativeCommand;
+        Date_t firstSeen;
+        Date_t lastSeen;
+
+        long long execCount = 0;
+        long long getMoreCount = 0;
+        long long totalMicros = 0;
+        long long maxMicros = 0;
+        std::array<long long, kNumLatencyBuckets> latencyBuckets{};
+
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    struct Stripe {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("QueryShapeStats::Stripe::mutex");
+        stdx::unordered_map<Key, Entry> entries;
+        long long numEvictions = 0;
+    };
+
+    std::array<Stripe, kNumStripes> _stripes;
+};
+
+}  // namespace mongo
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/stats/query_shape_stats.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+QueryShapeStats::Execution makeExecution(StringData ns, uint32_t queryHash) {
+    QueryShapeStats::Execution execution;
+    execution.nss = NamespaceString(ns);
+    execution.queryHash = queryHash;
+    execution.planCacheKey = queryHash + 1;
+    execution.command = BSON("find"
+                             << "coll"
+                             << "filter" << BSON("a" << 1));
+    execution.latency = Microseconds(100);
+    execution.keysExamined = 10;
+    execution.docsExamined = 5;
+    execution.nreturned = 2;
+    execution.bytesReturned = 300;
+    return execution;
+}
+
+TEST(QueryShapeStatsTest, AccumulatesExecutionsOfTheSameShape) {
+    QueryShapeStats stats;
+    auto execution = makeExecution("test.coll", 42);
+    stats.record(execution);
+    execution.latency = Microseconds(3000);
+    stats.record(execution);
+
+    auto results = stats.getStats();
+    ASSERT_EQ(results.size(), 1U);
+    const auto& entry = results[0];
+    ASSERT_EQ(entry["ns"].str(), "test.coll");
+    ASSERT_EQ(entry["queryHash"].str(), "0000002A");
+    ASSERT_EQ(entry["planCacheKey"].str(), "0000002B");
+    ASSERT_BSONOBJ_EQ(entry["representativeCommand"].Obj(), execution.command);
+    ASSERT_EQ(entry["execCount"].numberLong(), 2);
+    ASSERT_EQ(entry["getMoreCount"].numberLong(), 0);
+    ASSERT_EQ(entry["keysExamined"].numberLong(), 20);
+    ASSERT_EQ(entry["docsExamined"].numberLong(), 10);
+    ASSERT_EQ(entry["nreturned"].numberLong(), 4);
+    ASSERT_EQ(entry["bytesReturned"].numberLong(), 600);
+
+    const auto latency = entry["latency"].Obj();
+    ASSERT_EQ(latency["totalMicros"].numberLong(), 3100);
+    ASSERT_EQ(latency["maxMicros"].numberLong(), 3000);
+    ASSERT_BSONOBJ_EQ(latency["histogram"].Obj(),
+                      BSON_ARRAY(BSON("micros" << 64LL << "count" << 1LL)
+                                 << BSON("micros" << 2048LL << "count" << 1LL)));
+}
+
+TEST(QueryShapeStatsTest, GetMoresAddCostsButNotExecutions) {
+    QueryShapeStats stats;
+    stats.record(makeExecution("test.coll", 7));
+
+    auto getMore = makeExecution("test.coll", 7);
+    getMore.isGetMore = true;
+    getMore.command = BSONObj();
+    stats.record(getMore);
+
+    auto results = stats.getStats();
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_EQ(results[0]["execCount"].numberLong(), 1);
+    ASSERT_EQ(results[0]["getMoreCount"].numberLong(), 1);
+    ASSERT_EQ(results[0]["nreturned"].numberLong(), 4);
+    ASSERT_FALSE(results[0]["representativeCommand"].Obj().isEmpty());
+}
+
+TEST(QueryShapeStatsTest, SameShapeOnDifferentNamespacesIsTrackedSeparately) {
+    QueryShapeStats stats;
+    stats.record(makeExecution("test.a", 7));
+    stats.record(makeExecution("test.b", 7));
+    stats.record(makeExecution("test.a", 8));
+    ASSERT_EQ(stats.size(), 3U);
+
+    stats.clear();
+    ASSERT_EQ(stats.size(), 0U);
+    ASSERT_TRUE(stats.getStats().empty());
+}
+
+TEST(QueryShapeStatsTest, EvictsLeastRecentlyExecutedShapeWhenFull) {
+    auto defaultCapacity = internalQueryShapeStatsCapacity.load();
+    ON_BLOCK_EXIT([&] { internalQueryShapeStatsCapacity.store(defaultCapacity); });
+    // One entry per stripe.
+    internalQueryShapeStatsCapacity.store(QueryShapeStats::kNumStripes);
+
+    // All of these hashes map to the same stripe.
+    QueryShapeStats stats;
+    stats.record(makeExecution("test.coll", 0));
+    stats.record(makeExecution("test.coll", QueryShapeStats::kNumStripes));
+    stats.record(makeExecution("test.coll", 2 * QueryShapeStats::kNumStripes));
+
+    auto results = stats.getStats();
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_EQ(results[0]["queryHash"].str(), "00000020");
+    ASSERT_EQ(stats.numEvictions(), 2);
+
+    // A shape on another stripe does not evict anything.
+    stats.record(makeExecution("test.coll", 1));
+    ASSERT_EQ(stats.size(), 2U);
+    ASSERT_EQ(stats.numEvictions(), 2);
+}
+
+TEST(QueryShapeStatsTest, ZeroCapacityDisablesCollection) {
+    auto defaultCapacity = internalQueryShapeStatsCapacity.load();
+    ON_BLOCK_EXIT([&] { internalQueryShapeStatsCapacity.store(defaultCapacity); });
+    internalQueryShapeStatsCapacity.store(0);
+
+    QueryShapeStats stats;
+    stats.record(makeExecution("test.coll", 1));
+    ASSERT_EQ(stats.size(), 0U);
+}
+
+TEST(QueryShapeStatsTest, LatencyBuckets) {
+    ASSERT_EQ(QueryShapeStats::getLatencyBucket(Microseconds(0)), 0U);
+    ASSERT_EQ(QueryShapeStats::getLatencyBucket(Microseconds(1)), 1U);
+    ASSERT_EQ(QueryShapeStats::getLatencyBucket(Microseconds(2)), 2U);
+    ASSERT_EQ(QueryShapeStats::getLatencyBucket(Microseconds(3)), 2U);
+    ASSERT_EQ(QueryShapeStats::getLatencyBucket(Microseconds(4)), 3U);
+    ASSERT_EQ(QueryShapeStats::getLatencyBucket(Microseconds(1LL << 40)),
+              QueryShapeStats::kNumLatencyBuckets - 1);
+}
+
+}  // namespace
+}  // namespace mongo
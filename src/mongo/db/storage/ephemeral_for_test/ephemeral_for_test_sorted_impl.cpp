@@ -439,6 +439,9 @@ public:
         const KeyString::Value& keyStringValue) override;
     virtual boost::optional<IndexKeyEntry> seekExact(const KeyString::Value& keyStringValue,
                                                      RequestedInfo) override;
+    virtual void setSeekBatch(std::vector<SeekRange> ranges) override;
+    virtual boost::optional<IndexKeyEntry> seekNextInBatch(RequestedInfo parts) override;
+    virtual size_t keysExaminedInSeekBatch() const override;
     virtual void save() override;
     virtual void restore() override;
     virtual void detachFromOperationContext() override;
@@ -485,6 +488,10 @@ private:
 
 protected:
     bool advanceNext();
+    // This returns the key the cursor is on if it is in the ident, regardless of the end position.
+    const std::string* keyInIdent();
+    // This counts the entry the cursor just moved onto towards keysExaminedInSeekBatch().
+    void countKeyExaminedInSeekBatch(bool returned);
     // This is a helper function to check if the cursor was explicitly set by the user or not.
     bool endPosSet();
     // This is a helper function for seek.
@@ -521,6 +528,13 @@ protected:
     // The next two are the same as above.
     std::string _KSForIdentStart;
     std::string _KSForIdentEnd;
+    // These store the ranges submitted by setSeekBatch() and the next one to seek to.
+    std::vector<SeekRange> _seekBatch;
+    size_t _seekBatchPos = 0;
+    // These store the number of entries moved onto since setSeekBatch() and the key of the entry
+    // past the end of the last range, so that it is counted once if it starts the next range.
+    size_t _keysExaminedInSeekBatch = 0;
+    std::string _seekBatchStopKey;
 };
 
 // Cursor
@@ -559,8 +573,10 @@ bool CursorBase<CursorImpl>::advanceNext() {
         if (_lastMoveWasRestore) {
             _lastMoveWasRestore = false;
         } else {
-            if (advanceNextInternal())
+            if (advanceNextInternal()) {
+                countKeyExaminedInSeekBatch(true);
                 return true;
+            }
 
             // We basically just check to make sure the cursor is in the ident.
             if (_forward && checkCursorValid()) {
@@ -572,6 +588,7 @@ bool CursorBase<CursorImpl>::advanceNext() {
             // that the cursor is still in the ident after advancing.
             if (!checkCursorValid()) {
                 _atEOF = true;
+                countKeyExaminedInSeekBatch(false);
                 return false;
             }
         }
@@ -581,10 +598,39 @@ bool CursorBase<CursorImpl>::advanceNext() {
     }
 
     finishAdvanceNext();
+    countKeyExaminedInSeekBatch(true);
 
     return true;
 }
 
+template <class CursorImpl>
+const std::string* CursorBase<CursorImpl>::keyInIdent() {
+    if (_forward) {
+        if (_forwardIt == _workingCopy->end() || _forwardIt->first.compare(_KSForIdentEnd) > 0)
+            return nullptr;
+        return &_forwardIt->first;
+    }
+    if (_reverseIt == _workingCopy->rend() || _reverseIt->first.compare(_KSForIdentStart) < 0)
+        return nullptr;
+    return &_reverseIt->first;
+}
+
+template <class CursorImpl>
+void CursorBase<CursorImpl>::countKeyExaminedInSeekBatch(bool returned) {
+    if (_seekBatch.empty())
+        return;
+    if (returned) {
+        ++_keysExaminedInSeekBatch;
+        return;
+    }
+    // The cursor stopped past the end of a range. It only looked at an entry if it didn't run off
+    // the end of the ident.
+    if (const std::string* key = keyInIdent()) {
+        ++_keysExaminedInSeekBatch;
+        _seekBatchStopKey = *key;
+    }
+}
+
 // This function checks whether or not the cursor end position was set by the user or not.
 template <class CursorImpl>
 bool CursorBase<CursorImpl>::endPosSet() {
@@ -741,6 +787,40 @@ boost::optional<IndexKeyEntry> CursorBase<CursorImpl>::seekExact(
     return IndexKeyEntry(std::move(bson), ksEntry->loc);
 }
 
+template <class CursorImpl>
+void CursorBase<CursorImpl>::setSeekBatch(std::vector<SeekRange> ranges) {
+    _seekBatch = std::move(ranges);
+    _seekBatchPos = 0;
+    _keysExaminedInSeekBatch = 0;
+    _seekBatchStopKey.clear();
+}
+
+template <class CursorImpl>
+boost::optional<IndexKeyEntry> CursorBase<CursorImpl>::seekNextInBatch(RequestedInfo parts) {
+    invariant(_seekBatchPos < _seekBatch.size());
+    const SeekRange& range = _seekBatch[_seekBatchPos];
+    setEndPosition(range.endKey, range.endInclusive);
+    auto entry = seek(range.seekKey, parts);
+
+    // Only move on to the next range once the seek has succeeded, so that a caller retrying after a
+    // WriteConflictException seeks to the same range again.
+    ++_seekBatchPos;
+
+    // The entry past the end of the previous range was already counted when the cursor stopped on
+    // it.
+    const std::string* key = keyInIdent();
+    if (!key || *key != _seekBatchStopKey) {
+        _seekBatchStopKey.clear();
+        countKeyExaminedInSeekBatch(entry.has_value());
+    }
+    return entry;
+}
+
+template <class CursorImpl>
+size_t CursorBase<CursorImpl>::keysExaminedInSeekBatch() const {
+    return _keysExaminedInSeekBatch;
+}
+
 template <class CursorImpl>
 void CursorBase<CursorImpl>::save() {
     _atEOF = false;
@@ -33,9 +33,14 @@
 
 #include "mongo/db/storage/key_string.h"
 
+#include <algorithm>
 #include <cmath>
 #include <type_traits>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -241,15 +246,56 @@ const uint8_t kGreater = 254;
 // some utility functions
 namespace {
 
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. Works a vector register, and then
+ * a word, at a time before falling back to single bytes for the tail. 'dst' may be equal to 'src',
+ * but the ranges must not otherwise overlap.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+
+#if defined(_M_AMD64) || defined(__amd64__)
+    const __m128i allOnes = _mm_set1_epi8(-1);
+    for (; end - input >= 16; input += 16, output += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_xor_si128(chunk, allOnes));
+    }
+#endif
+
+    for (; end - input >= 8; input += 8, output += 8) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+    }
+
     while (input != end) {
         *output++ = ~(*input++);
     }
 }
 
+/**
+ * Reads an unsigned integer stored big-endian in the next 'bytes' bytes, where 'bytes' is at most
+ * 8, with a single load rather than shifting in one byte at a time.
+ */
+uint64_t readBigEndianInteger(BufReader* reader, size_t bytes, bool inverted) {
+    invariant(bytes <= sizeof(uint64_t));
+    if (bytes == 0)
+        return 0;
+
+    uint64_t value = 0;
+    memcpy(reinterpret_cast<char*>(&value) + sizeof(value) - bytes, reader->skip(bytes), bytes);
+    value = endian::bigToNative(value);
+    if (inverted) {
+        value = ~value;
+        if (bytes < sizeof(uint64_t))
+            value &= (uint64_t(1) << (bytes * 8)) - 1;
+    }
+    return value;
+}
+
 template <typename T>
 T readType(BufReader* reader, bool inverted) {
     MONGO_STATIC_ASSERT(std::is_integral<T>::value);
@@ -296,10 +342,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     keyStringAssert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -326,9 +370,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
+    memcpy_flipBits(&out[0], out.data(), out.size());
 
     return out;
 }
@@ -1718,14 +1760,8 @@ void toBsonValue(uint8_t ctype,
         case CType::kNumericPositive8ByteInt: {
             const uint8_t originalType = typeBits->readNumeric();
 
-            uint64_t encodedIntegerPart = 0;
-            {
-                size_t intBytesRemaining = CType::numBytesForInt(ctype);
-                while (intBytesRemaining--) {
-                    encodedIntegerPart =
-                        (encodedIntegerPart << 8) | readType<uint8_t>(reader, inverted);
-                }
-            }
+            const uint64_t encodedIntegerPart =
+                readBigEndianInteger(reader, CType::numBytesForInt(ctype), inverted);
 
             const bool haveFractionalPart = (encodedIntegerPart & 1);
             int64_t integerPart = encodedIntegerPart >> 1;
@@ -1773,11 +1809,8 @@ void toBsonValue(uint8_t ctype,
                 if (isNegative) {
                     doubleBits |= (1ULL << 63);  // sign bit
                 }
-                for (size_t i = 0; i < fractionalBytes; i++) {
-                    // fold in the fractional bytes
-                    const uint64_t byte = readType<uint8_t>(reader, inverted);
-                    doubleBits |= (byte << ((fractionalBytes - i - 1) * 8));
-                }
+                // fold in the fractional bytes
+                doubleBits |= readBigEndianInteger(reader, fractionalBytes, inverted);
 
                 double number;
                 memcpy(&number, &doubleBits, sizeof(number));
@@ -1789,9 +1822,10 @@ void toBsonValue(uint8_t ctype,
             // Start with integer part, and read until we have a full 8 bytes worth of data.
             const size_t fracBytes = 8 - CType::numBytesForInt(ctype);
             uint64_t encodedFraction = integerPart;
-
-            for (int fracBytesRemaining = fracBytes; fracBytesRemaining; fracBytesRemaining--)
-                encodedFraction = (encodedFraction << 8) | readType<uint8_t>(reader, inverted);
+            if (fracBytes) {
+                encodedFraction = (encodedFraction << (fracBytes * 8)) |
+                    readBigEndianInteger(reader, fracBytes, inverted);
+            }
 
             // Zero out the DCM and convert the whole binary fraction
             double bin = static_cast<double>(encodedFraction & ~3ULL) * kInvPow256[fracBytes];
@@ -2053,14 +2087,8 @@ void filterKeyFromKeyString(uint8_t ctype, BufReader* reader, bool inverted, Ver
         case CType::kNumericPositive6ByteInt:
         case CType::kNumericPositive7ByteInt:
         case CType::kNumericPositive8ByteInt: {
-            uint64_t encodedIntegerPart = 0;
-            {
-                size_t intBytesRemaining = CType::numBytesForInt(ctype);
-                while (intBytesRemaining--) {
-                    encodedIntegerPart =
-                        (encodedIntegerPart << 8) | readType<uint8_t>(reader, inverted);
-                }
-            }
+            const uint64_t encodedIntegerPart =
+                readBigEndianInteger(reader, CType::numBytesForInt(ctype), inverted);
 
             const bool haveFractionalPart = (encodedIntegerPart & 1);
             int64_t integerPart = encodedIntegerPart >> 1;
@@ -2075,10 +2103,8 @@ void filterKeyFromKeyString(uint8_t ctype, BufReader* reader, bool inverted, Ver
                 const size_t fractionalBits = (52 - exponent);
                 const size_t fractionalBytes = (fractionalBits + 7) / 8;
 
-                for (size_t i = 0; i < fractionalBytes; i++) {
-                    // fold in the fractional bytes
-                    reader->skip(sizeof(std::uint8_t));
-                }
+                // skip over the fractional bytes
+                reader->skip(fractionalBytes);
                 break;
             }
 
@@ -2086,9 +2112,10 @@ void filterKeyFromKeyString(uint8_t ctype, BufReader* reader, bool inverted, Ver
             // Start with integer part, and read until we have a full 8 bytes worth of data.
             const size_t fracBytes = 8 - CType::numBytesForInt(ctype);
             uint64_t encodedFraction = integerPart;
-
-            for (int fracBytesRemaining = fracBytes; fracBytesRemaining; fracBytesRemaining--)
-                encodedFraction = (encodedFraction << 8) | readType<uint8_t>(reader, inverted);
+            if (fracBytes) {
+                encodedFraction = (encodedFraction << (fracBytes * 8)) |
+                    readBigEndianInteger(reader, fracBytes, inverted);
+            }
 
             // The two lsb's are the DCM, except for the 8-byte case, where it's already known
             DecimalContinuationMarker dcm = fracBytes
@@ -2320,9 +2347,27 @@ void TypeBits::appendDecimalExponent(uint8_t storedExponentBits) {
         appendBit((storedExponentBits >> bitPos) & 1);
 }
 
+bool TypeBits::hasSamePrefix(const TypeBits& other, uint32_t numBits) const {
+    const auto bitAt = [](const TypeBits& typeBits, uint32_t bit) -> uint8_t {
+        const uint32_t byte = bit / 8;
+        if (typeBits._isAllZeros || byte >= typeBits.getDataBufferLen())
+            return 0;
+        return (typeBits.getDataBuffer()[byte] >> (bit % 8)) & 1;
+    };
+
+    for (uint32_t bit = 0; bit < numBits; ++bit) {
+        if (bitAt(*this, bit) != bitAt(other, bit))
+            return false;
+    }
+    return true;
+}
+
 uint8_t TypeBits::Reader::readBit() {
-    if (_typeBits._isAllZeros)
+    if (_typeBits._isAllZeros) {
+        // Keep counting, so that getCurrentBit() is the same whether or not the bits were stored.
+        _curBit++;
         return 0;
+    }
 
     const uint32_t byte = _curBit / 8;
     const uint8_t offsetInByte = _curBit % 8;
@@ -2434,6 +2479,60 @@ BSONObj toBson(const char* buffer, size_t len, Ordering ord, const TypeBits& typ
     return toBsonSafe(buffer, len, ord, typeBits);
 }
 
+BSONObj PrefixDecoder::decode(const char* buffer, size_t len, const TypeBits& typeBits) {
+    // Find the leading fields which were encoded identically in the previous key. Decoding a field
+    // depends only on its bytes and the type bits it consumes, so those can be copied as they are.
+    size_t numSharedFields = 0;
+    if (!_prevFieldEnds.empty() && _prevTypeBits.version == typeBits.version) {
+        const size_t maxShared = std::min(len, _prevKey.size());
+        const size_t sharedBytes =
+            std::mismatch(buffer, buffer + maxShared, _prevKey.data()).first - buffer;
+        while (numSharedFields < _prevFieldEnds.size() &&
+               _prevFieldEnds[numSharedFields].keyOffset <= sharedBytes) {
+            ++numSharedFields;
+        }
+        while (numSharedFields > 0 &&
+               !typeBits.hasSamePrefix(_prevTypeBits,
+                                       _prevFieldEnds[numSharedFields - 1].typeBitsOffset)) {
+            --numSharedFields;
+        }
+    }
+
+    BSONObjBuilder builder;
+    BSONObjIterator prevFields(_prevObj);
+    for (size_t i = 0; i < numSharedFields; ++i) {
+        builder.append(prevFields.next());
+    }
+    _prevFieldEnds.resize(numSharedFields);
+
+    BufReader reader(buffer, len);
+    uint32_t startBit = 0;
+    if (numSharedFields > 0) {
+        reader.skip(_prevFieldEnds.back().keyOffset);
+        startBit = _prevFieldEnds.back().typeBitsOffset;
+    }
+    TypeBits::Reader typeBitsReader(typeBits, startBit);
+
+    // The rest of the key is decoded as in toBsonSafe(), noting where each field ends.
+    for (int i = numSharedFields; reader.remaining(); i++) {
+        const bool invert = (_ord.get(i) == -1);
+        uint8_t ctype = readType<uint8_t>(&reader, invert);
+        if (ctype == kLess || ctype == kGreater) {
+            ctype = readType<uint8_t>(&reader, invert);
+        }
+
+        if (ctype == kEnd)
+            break;
+        toBsonValue(ctype, &reader, &typeBitsReader, invert, typeBits.version, &(builder << ""), 1);
+        _prevFieldEnds.push_back({reader.offset(), typeBitsReader.getCurrentBit()});
+    }
+
+    _prevKey.assign(buffer, len);
+    _prevTypeBits = typeBits;
+    _prevObj = builder.obj();
+    return _prevObj;
+}
+
 BSONObj toBson(StringData data, Ordering ord, const TypeBits& typeBits) {
     return toBson(data.rawData(), data.size(), ord, typeBits);
 }
@@ -30,6 +30,8 @@
 #pragma once
 
 #include <limits>
+#include <string>
+#include <vector>
 
 #include <absl/hash/hash.h>
 
@@ -167,6 +169,12 @@ public:
         return !_isAllZeros && getDataBufferLen() > kMaxBytesForShortEncoding;
     }
 
+    /**
+     * Returns true if the first 'numBits' bits of this and 'other' are the same. Bits past the end
+     * of either buffer are treated as zeros, as they are when read.
+     */
+    bool hasSamePrefix(const TypeBits& other, uint32_t numBits) const;
+
     //
     // Everything below is only for use by KeyString::Builder.
     //
@@ -235,7 +243,15 @@ public:
         /**
          * Passed in TypeBits must outlive this Reader instance.
          */
-        explicit Reader(const TypeBits& typeBits) : _curBit(0), _typeBits(typeBits) {}
+        explicit Reader(const TypeBits& typeBits, uint32_t startBit = 0)
+            : _curBit(startBit), _typeBits(typeBits) {}
+
+        /**
+         * Returns the number of bits consumed so far, including those before 'startBit'.
+         */
+        uint32_t getCurrentBit() const {
+            return _curBit;
+        }
 
         uint8_t readStringLike() {
             return readBit();
@@ -945,6 +961,37 @@ BSONObj toBson(const T& keyString, Ordering ord) noexcept {
     return toBson(keyString.getBuffer(), keyString.getSize(), ord, keyString.getTypeBits());
 }
 
+/**
+ * Decodes a stream of KeyStrings with the same Ordering, such as the consecutive entries returned
+ * by an index cursor, into BSONObjs. Neighbouring keys in a compound index often share their
+ * leading fields, so the decoder remembers where each field of the previous key ended in both the
+ * key bytes and the TypeBits, and copies the leading fields whose encoding is unchanged from the
+ * previous BSONObj instead of decoding them again.
+ */
+class PrefixDecoder {
+public:
+    explicit PrefixDecoder(Ordering ord) : _ord(ord) {}
+
+    /**
+     * Returns the same BSONObj as toBson(buffer, len, ord, typeBits).
+     */
+    BSONObj decode(const char* buffer, size_t len, const TypeBits& typeBits);
+
+private:
+    // Where a top-level field of the previous key ended.
+    struct FieldEnd {
+        size_t keyOffset;
+        uint32_t typeBitsOffset;
+    };
+
+    const Ordering _ord;
+
+    std::string _prevKey;
+    TypeBits _prevTypeBits{Version::kLatestVersion};
+    BSONObj _prevObj;
+    std::vector<FieldEnd> _prevFieldEnds;
+};
+
 /**
  * Decodes a RecordId from the end of a buffer.
  */
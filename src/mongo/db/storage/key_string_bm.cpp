@@ -48,6 +48,7 @@ const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
+const Ordering ONE_DESCENDING = Ordering::make(BSON("a" << -1));
 
 struct BsonsAndKeyStrings {
     int bsonSize = 0;
@@ -63,6 +64,7 @@ enum BsonValueType {
     INT,
     DOUBLE,
     STRING,
+    STRING_WITH_NULS,
     ARRAY,
     DECIMAL,
 };
@@ -79,6 +81,14 @@ BSONObj generateBson(BsonValueType bsonValueType) {
             return BSON("" << expReal(gen));
         case STRING:
             return BSON("" << std::string(expDist(gen) * kStrLenMultiplier, 'x'));
+        case STRING_WITH_NULS: {
+            // Every NUL byte must be escaped when encoding and unescaped when decoding.
+            std::string str(expDist(gen) * kStrLenMultiplier, 'x');
+            for (size_t i = 0; i < str.size(); i += 10) {
+                str[i] = '\0';
+            }
+            return BSON("" << str);
+        }
         case ARRAY: {
             const int arrLen = expDist(gen) * kArrLenMultiplier;
             BSONArrayBuilder bab;
@@ -97,13 +107,14 @@ BSONObj generateBson(BsonValueType bsonValueType) {
 }
 
 static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType,
-                                                     KeyString::Version version) {
+                                                     KeyString::Version version,
+                                                     const Ordering& ordering = ALL_ASCENDING) {
     BsonsAndKeyStrings result;
     result.bsonSize = 0;
     result.keystringSize = 0;
     for (int i = 0; i < kSampleSize; i++) {
         BSONObj bson = generateBson(bsonValueType);
-        KeyString::Builder ks(version, bson, ALL_ASCENDING);
+        KeyString::Builder ks(version, bson, ordering);
         result.bsonSize += bson.objsize();
         result.keystringSize += ks.getSize();
         result.bsons[i] = bson;
@@ -121,12 +132,14 @@ static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType
 
 void BM_BSONToKeyString(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        const Ordering& ordering = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ordering);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (auto bson : bsonsAndKeyStrings.bsons) {
-            benchmark::DoNotOptimize(KeyString::Builder(version, bson, ALL_ASCENDING));
+            benchmark::DoNotOptimize(KeyString::Builder(version, bson, ordering));
         }
     }
     state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.bsonSize);
@@ -135,8 +148,10 @@ void BM_BSONToKeyString(benchmark::State& state,
 
 void BM_KeyStringToBSON(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        const Ordering& ordering = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ordering);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (size_t i = 0; i < kSampleSize; i++) {
@@ -144,7 +159,7 @@ void BM_KeyStringToBSON(benchmark::State& state,
             benchmark::DoNotOptimize(
                 KeyString::toBson(bsonsAndKeyStrings.keystrings[i].get(),
                                   bsonsAndKeyStrings.keystringLens[i],
-                                  ALL_ASCENDING,
+                                  ordering,
                                   KeyString::TypeBits::fromBuffer(version, &buf)));
         }
     }
@@ -207,6 +222,34 @@ void BM_KeyStringStackBuilderCopy(benchmark::State& state, BsonValueType bsonTyp
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+/**
+ * Decodes the keys of a compound index in index order, where neighbouring keys share their leading
+ * fields, either independently or with a PrefixDecoder.
+ */
+void BM_CompoundKeyStringsToBSON(benchmark::State& state, bool usePrefixDecoder) {
+    const auto version = KeyString::Version::kLatestVersion;
+    std::vector<KeyString::Value> keys;
+    for (int i = 0; i < kSampleSize; i++) {
+        BSONObj bson = BSON("" << i / 100 << "" << std::string(40, 'a' + i / 50 % 26) << ""
+                               << "category" << "" << i);
+        keys.push_back(KeyString::HeapBuilder(version, bson, ALL_ASCENDING).release());
+    }
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        KeyString::PrefixDecoder decoder(ALL_ASCENDING);
+        for (auto&& key : keys) {
+            if (usePrefixDecoder) {
+                benchmark::DoNotOptimize(
+                    decoder.decode(key.getBuffer(), key.getSize(), key.getTypeBits()));
+            } else {
+                benchmark::DoNotOptimize(KeyString::toBson(key, ALL_ASCENDING));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kSampleSize);
+}
+
 BENCHMARK_CAPTURE(BM_KeyStringValueAssign, Int, INT);
 BENCHMARK_CAPTURE(BM_KeyStringValueAssign, Double, DOUBLE);
 BENCHMARK_CAPTURE(BM_KeyStringValueAssign, Decimal, DECIMAL);
@@ -234,6 +277,18 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_StringWithNuls, KeyString::Version::V1, STRING_WITH_NULS);
+BENCHMARK_CAPTURE(
+    BM_BSONToKeyString, V1_Int_Descending, KeyString::Version::V1, INT, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_BSONToKeyString, V1_Double_Descending, KeyString::Version::V1, DOUBLE, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_BSONToKeyString, V1_String_Descending, KeyString::Version::V1, STRING, ONE_DESCENDING);
+BENCHMARK_CAPTURE(BM_BSONToKeyString,
+                  V1_StringWithNuls_Descending,
+                  KeyString::Version::V1,
+                  STRING_WITH_NULS,
+                  ONE_DESCENDING);
 
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Int, KeyString::Version::V1, INT);
@@ -244,6 +299,21 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_StringWithNuls, KeyString::Version::V1, STRING_WITH_NULS);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Int_Descending, KeyString::Version::V1, INT, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Double_Descending, KeyString::Version::V1, DOUBLE, ONE_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_String_Descending, KeyString::Version::V1, STRING, ONE_DESCENDING);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON,
+                  V1_StringWithNuls_Descending,
+                  KeyString::Version::V1,
+                  STRING_WITH_NULS,
+                  ONE_DESCENDING);
+
+BENCHMARK_CAPTURE(BM_CompoundKeyStringsToBSON, ToBson, false);
+BENCHMARK_CAPTURE(BM_CompoundKeyStringsToBSON, PrefixDecoder, true);
 
 }  // namespace
 }  // namespace mongo
@@ -471,6 +471,88 @@ TEST_F(KeyStringBuilderTest, Undef1) {
     ROUNDTRIP(version, BSON("" << BSONUndefined));
 }
 
+TEST_F(KeyStringBuilderTest, StringsAcrossBlockBoundaries) {
+    // Inverted strings are flipped a vector register and then a word at a time, so cover every
+    // length around those widths, with and without bytes that have to be escaped.
+    for (size_t len = 0; len <= 40; ++len) {
+        std::string plain;
+        std::string withNulsAndFFs;
+        for (size_t i = 0; i < len; ++i) {
+            plain += static_cast<char>('a' + i % 26);
+            withNulsAndFFs += static_cast<char>(i % 3 == 0 ? '\0' : (i % 3 == 1 ? '\xff' : 'z'));
+        }
+        ROUNDTRIP(version, BSON("" << plain));
+        ROUNDTRIP(version, BSON("" << withNulsAndFFs));
+        ROUNDTRIP(version, BSON("" << BSONSymbol(withNulsAndFFs)));
+        ROUNDTRIP(version, BSON("" << BSONCode(withNulsAndFFs)));
+        ROUNDTRIP(version, BSON("" << BSONBinData(plain.data(), plain.size(), BinDataGeneral)));
+    }
+}
+
+TEST_F(KeyStringBuilderTest, PrefixDecoderMatchesToBson) {
+    const auto keys = {
+        BSON("" << 1 << ""
+                << "aaa"
+                << "" << 1.5),
+        BSON("" << 1 << ""
+                << "aaa"
+                << "" << 2),
+        BSON("" << 1 << ""
+                << "aab"
+                << "" << 2),
+        // Same bytes as before for the first field, but different TypeBits.
+        BSON("" << 1.0 << ""
+                << "aab"
+                << "" << 2),
+        BSON("" << 1LL << ""
+                << "aab"
+                << "" << 2LL),
+        BSON("" << 1LL << "" << BSONSymbol("aab") << "" << 2LL),
+        BSON("" << 2 << "" << BSON("x" << 1) << "" << BSONNULL),
+        BSON("" << 2 << "" << BSON("x" << 1) << "" << Decimal128("0.0")),
+        BSON("" << 2 << "" << BSON("x" << 1) << "" << Decimal128("-0")),
+        BSON("" << 2 << "" << BSON_ARRAY(1 << 2) << "" << Decimal128("-0")),
+        BSON("" << 2),
+        BSON("" << 2 << "" << BSON_ARRAY(1 << 2) << "" << Decimal128("-0")),
+    };
+
+    for (auto&& ordering : {ALL_ASCENDING,
+                            ONE_DESCENDING,
+                            Ordering::make(BSON("a" << 1 << "b" << -1 << "c" << -1))}) {
+        KeyString::PrefixDecoder decoder(ordering);
+        for (auto&& key : keys) {
+            for (auto&& withRecordId : {false, true}) {
+                KeyString::Builder ks = withRecordId
+                    ? KeyString::Builder(version, key, ordering, RecordId(17))
+                    : KeyString::Builder(version, key, ordering);
+                const BSONObj decoded =
+                    decoder.decode(ks.getBuffer(), ks.getSize(), ks.getTypeBits());
+                const BSONObj expected =
+                    KeyString::toBson(ks.getBuffer(), ks.getSize(), ordering, ks.getTypeBits());
+                ASSERT_BSONOBJ_EQ(decoded, expected);
+                ASSERT(decoded.binaryEqual(expected));
+                ASSERT(decoded.binaryEqual(key));
+            }
+        }
+    }
+}
+
+TEST_F(KeyStringBuilderTest, NumbersOfEveryIntegerWidth) {
+    // The integer part of a number is stored in as few bytes as it needs, and decoded with a
+    // single load of that many bytes.
+    for (int bits = 0; bits < 63; ++bits) {
+        const long long n = 1LL << bits;
+        for (long long value : {n - 1, n, n + 1, -n}) {
+            ROUNDTRIP(version, BSON("" << value));
+            ROUNDTRIP(version, BSON("" << static_cast<double>(value)));
+            if (bits < 52) {
+                ROUNDTRIP(version, BSON("" << static_cast<double>(value) + 0.25));
+                ROUNDTRIP(version, BSON("" << static_cast<double>(value) - 0.75));
+            }
+        }
+    }
+}
+
 TEST_F(KeyStringBuilderTest, NumberLong0) {
     double d = (1ll << 52) - 1;
     long long ll = static_cast<long long>(d);
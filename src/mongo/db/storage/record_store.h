@@ -29,6 +29,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #include <boost/optional.hpp>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -173,6 +177,35 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Looks up every id in 'ids', as if by seekExact(). On return, (*out)[i] holds the Record for
+     * ids[i], or boost::none if there is no such Record. The returned Records own their data.
+     *
+     * The ids may be in any order, such as the order they were found in an index. They are looked
+     * up in RecordId order, so that a batch of ids clustered in the RecordStore is read mostly
+     * sequentially rather than with a random seek per id.
+     *
+     * The resulting position of the cursor is unspecified.
+     */
+    virtual void fetchBatch(const std::vector<RecordId>& ids,
+                            std::vector<boost::optional<Record>>* out) {
+        out->clear();
+        out->resize(ids.size());
+
+        std::vector<size_t> order(ids.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return ids[lhs] < ids[rhs];
+        });
+
+        for (size_t i : order) {
+            if (auto record = seekExact(ids[i])) {
+                record->data.makeOwned();
+                (*out)[i] = std::move(record);
+            }
+        }
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
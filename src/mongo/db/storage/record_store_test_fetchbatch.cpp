@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/record_store_test_harness.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Fetch a batch of ids in an arbitrary order, including ids of deleted records, an id which was
+// never used, and a repeated id. Each result must line up with the id it was asked for.
+TEST(RecordStoreTestHarness, FetchBatchReturnsRecordsInRequestedOrder) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    std::unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 50;
+    std::vector<RecordId> ids;
+    std::vector<std::string> datas;
+    for (int i = 0; i < nToInsert; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        const std::string data = "record " + std::to_string(i);
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        uow.commit();
+
+        ids.push_back(res.getValue());
+        datas.push_back(data);
+    }
+
+    // Delete every seventh record.
+    std::vector<bool> deleted(nToInsert, false);
+    for (int i = 0; i < nToInsert; i += 7) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), ids[i]);
+        uow.commit();
+        deleted[i] = true;
+    }
+
+    std::vector<int> requested(nToInsert);
+    std::iota(requested.begin(), requested.end(), 0);
+    requested.push_back(3);
+    std::shuffle(requested.begin(), requested.end(), std::mt19937(0));
+
+    std::vector<RecordId> batch;
+    for (int i : requested) {
+        batch.push_back(ids[i]);
+    }
+    const RecordId neverUsed(std::max_element(ids.begin(), ids.end())->repr() + 1000);
+    batch.push_back(neverUsed);
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursor = rs->getCursor(opCtx.get());
+    std::vector<boost::optional<Record>> records;
+    cursor->fetchBatch(batch, &records);
+
+    ASSERT_EQUALS(batch.size(), records.size());
+    for (size_t j = 0; j < requested.size(); j++) {
+        const int i = requested[j];
+        if (deleted[i]) {
+            ASSERT_FALSE(records[j]);
+            continue;
+        }
+        ASSERT(records[j]);
+        ASSERT_EQUALS(ids[i], records[j]->id);
+        ASSERT_EQUALS(datas[i], records[j]->data.data());
+        ASSERT(records[j]->data.isOwned());
+    }
+    ASSERT_FALSE(records.back());
+
+    // The cursor can still be used to seek after a batch.
+    auto record = cursor->seekExact(ids[1]);
+    ASSERT(record);
+    ASSERT_EQUALS(datas[1], record->data.data());
+}
+
+}  // namespace
+}  // namespace mongo
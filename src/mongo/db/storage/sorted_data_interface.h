@@ -30,6 +30,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -95,6 +96,23 @@ public:
                           const KeyString::Value& keyString,
                           bool dupsAllowed) = 0;
 
+    /**
+     * Inserts each of 'keys' in order, as if by insert(), stopping at the first failure.
+     *
+     * Implementations may override this to apply the whole batch through a single cursor which,
+     * since the keys are sorted, only ever moves forward through the index.
+     */
+    virtual Status insertSorted(OperationContext* opCtx,
+                                const KeyStringSet& keys,
+                                bool dupsAllowed) {
+        for (const auto& keyString : keys) {
+            Status status = insert(opCtx, keyString, dupsAllowed);
+            if (!status.isOK())
+                return status;
+        }
+        return Status::OK();
+    }
+
     /**
      * Remove the entry from the index with the specified KeyString, which must have a RecordId
      * appended to the end.
@@ -303,6 +321,52 @@ public:
         virtual boost::optional<IndexKeyEntry> seekExact(const KeyString::Value& keyString,
                                                          RequestedInfo parts = kKeyAndLoc) = 0;
 
+        //
+        // Batched seeking
+        //
+
+        /**
+         * One range of a batched seek. Seeking to it is equivalent to calling
+         * setEndPosition(endKey, endInclusive) followed by seek(seekKey).
+         */
+        struct SeekRange {
+            KeyString::Value seekKey;
+            BSONObj endKey;
+            bool endInclusive;
+        };
+
+        /**
+         * Submits a batch of ranges that subsequent calls to seekNextInBatch() visit one at a time,
+         * in order. The ranges must be sorted in the direction of the cursor and must not overlap.
+         * Submitting a batch replaces any batch that has not been fully consumed.
+         *
+         * Knowing up front that the seeks move monotonically through the index lets
+         * implementations reuse the current position when the next range starts close to where
+         * the previous one ended, rather than repositioning from the root of the index.
+         */
+        virtual void setSeekBatch(std::vector<SeekRange> ranges) = 0;
+
+        /**
+         * Positions the cursor on the next range of the batch submitted by setSeekBatch() and
+         * returns the first entry in it, or boost::none if the range is empty. Callers iterate the
+         * rest of the range with next(). It is illegal to call this once every range in the batch
+         * has been consumed. If this throws, the range is not consumed, and the next call seeks to
+         * it again.
+         *
+         * Any other seek, or a call to setEndPosition(), between two calls to this method is
+         * allowed but forfeits the reuse of the position between ranges.
+         */
+        virtual boost::optional<IndexKeyEntry> seekNextInBatch(
+            RequestedInfo parts = kKeyAndLoc) = 0;
+
+        /**
+         * Returns the number of index entries the cursor has moved onto since the last call to
+         * setSeekBatch(), whether or not they were returned. This includes the entry just past
+         * the end of each range, which the cursor has to look at to know the range is exhausted.
+         * An entry that ends one range and is also the first entry of the next is counted once.
+         */
+        virtual size_t keysExaminedInSeekBatch() const = 0;
+
         //
         // Saving and restoring state
         //
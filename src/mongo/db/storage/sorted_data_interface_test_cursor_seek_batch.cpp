@@ -0,0 +1,249 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/storage/sorted_data_interface_test_harness.h"
+
+#include <memory>
+
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using SeekRange = SortedDataInterface::Cursor::SeekRange;
+
+// Returns a range covering all entries with keys between 'start' and 'end', where 'start' comes
+// first in the direction of the cursor.
+SeekRange makeRange(SortedDataInterface* sorted, BSONObj start, BSONObj end, bool forward) {
+    return {makeKeyStringForSeek(sorted, start, forward, true), end, true};
+}
+
+// Tests that each range of the batch returns exactly the entries within it, including ranges that
+// are empty or whose first entry is the one just past the end of the previous range.
+void testSeekBatch_Ranges(bool unique, bool forward) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(unique,
+                                                        /*partial=*/false,
+                                                        {
+                                                            {key1, loc1},
+                                                            {key2, loc1},
+                                                            // No key3.
+                                                            {key4, loc1},
+                                                            {key5, loc1},
+                                                            {key6, loc1},
+                                                        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), forward);
+
+    std::vector<SeekRange> ranges;
+    if (forward) {
+        ranges.push_back(makeRange(sorted.get(), key1, key1, forward));
+        ranges.push_back(makeRange(sorted.get(), key2, key2, forward));
+        ranges.push_back(makeRange(sorted.get(), key3, key3, forward));
+        ranges.push_back(makeRange(sorted.get(), key4, key5, forward));
+    } else {
+        ranges.push_back(makeRange(sorted.get(), key6, key6, forward));
+        ranges.push_back(makeRange(sorted.get(), key5, key5, forward));
+        ranges.push_back(makeRange(sorted.get(), key3, key3, forward));
+        ranges.push_back(makeRange(sorted.get(), key2, key1, forward));
+    }
+    cursor->setSeekBatch(std::move(ranges));
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(forward ? key1 : key6, loc1));
+    ASSERT_EQ(cursor->next(), boost::none);
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(forward ? key2 : key5, loc1));
+    ASSERT_EQ(cursor->next(), boost::none);
+
+    ASSERT_EQ(cursor->seekNextInBatch(), boost::none);
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(forward ? key4 : key2, loc1));
+    ASSERT_EQ(cursor->next(), IndexKeyEntry(forward ? key5 : key1, loc1));
+    ASSERT_EQ(cursor->next(), boost::none);
+
+    // Every entry is looked at exactly once, including those that were only past the end of a
+    // range.
+    ASSERT_EQ(cursor->keysExaminedInSeekBatch(), 5U);
+}
+TEST(SortedDataInterface, SeekBatch_Ranges_Unique_Forward) {
+    testSeekBatch_Ranges(true, true);
+}
+TEST(SortedDataInterface, SeekBatch_Ranges_Unique_Reverse) {
+    testSeekBatch_Ranges(true, false);
+}
+TEST(SortedDataInterface, SeekBatch_Ranges_Standard_Forward) {
+    testSeekBatch_Ranges(false, true);
+}
+TEST(SortedDataInterface, SeekBatch_Ranges_Standard_Reverse) {
+    testSeekBatch_Ranges(false, false);
+}
+
+// Tests that ranges past the end of the index are empty once the cursor has run off the end.
+void testSeekBatch_PastEndOfIndex(bool unique, bool forward) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(unique,
+                                                        /*partial=*/false,
+                                                        {
+                                                            {key2, loc1},
+                                                            {key3, loc1},
+                                                        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), forward);
+
+    std::vector<SeekRange> ranges;
+    if (forward) {
+        ranges.push_back(makeRange(sorted.get(), key3, key4, forward));
+        ranges.push_back(makeRange(sorted.get(), key5, key5, forward));
+        ranges.push_back(makeRange(sorted.get(), key6, key6, forward));
+    } else {
+        ranges.push_back(makeRange(sorted.get(), key2, key1, forward));
+        ranges.push_back(makeRange(sorted.get(), key0, key0, forward));
+    }
+    const auto numRanges = ranges.size();
+    cursor->setSeekBatch(std::move(ranges));
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(forward ? key3 : key2, loc1));
+    ASSERT_EQ(cursor->next(), boost::none);
+    for (size_t i = 1; i < numRanges; ++i) {
+        ASSERT_EQ(cursor->seekNextInBatch(), boost::none);
+    }
+    ASSERT_EQ(cursor->keysExaminedInSeekBatch(), 1U);
+}
+TEST(SortedDataInterface, SeekBatch_PastEndOfIndex_Unique_Forward) {
+    testSeekBatch_PastEndOfIndex(true, true);
+}
+TEST(SortedDataInterface, SeekBatch_PastEndOfIndex_Unique_Reverse) {
+    testSeekBatch_PastEndOfIndex(true, false);
+}
+TEST(SortedDataInterface, SeekBatch_PastEndOfIndex_Standard_Forward) {
+    testSeekBatch_PastEndOfIndex(false, true);
+}
+TEST(SortedDataInterface, SeekBatch_PastEndOfIndex_Standard_Reverse) {
+    testSeekBatch_PastEndOfIndex(false, false);
+}
+
+// Tests that saving and restoring the cursor between ranges doesn't lose or repeat entries, even
+// when the entry the cursor was parked on is removed in the meantime.
+void testSeekBatch_SaveRestoreBetweenRanges(bool unique, bool forward) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(unique,
+                                                        /*partial=*/false,
+                                                        {
+                                                            {key1, loc1},
+                                                            {key2, loc1},
+                                                            {key3, loc1},
+                                                        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), forward);
+
+    std::vector<SeekRange> ranges;
+    if (forward) {
+        ranges.push_back(makeRange(sorted.get(), key1, key1, forward));
+        ranges.push_back(makeRange(sorted.get(), key2, key2, forward));
+        ranges.push_back(makeRange(sorted.get(), key3, key3, forward));
+    } else {
+        ranges.push_back(makeRange(sorted.get(), key3, key3, forward));
+        ranges.push_back(makeRange(sorted.get(), key2, key2, forward));
+        ranges.push_back(makeRange(sorted.get(), key1, key1, forward));
+    }
+    cursor->setSeekBatch(std::move(ranges));
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(forward ? key1 : key3, loc1));
+    ASSERT_EQ(cursor->next(), boost::none);
+
+    cursor->saveUnpositioned();
+    removeFromIndex(opCtx, sorted, {{key2, loc1}});
+    cursor->restore();
+
+    ASSERT_EQ(cursor->seekNextInBatch(), boost::none);
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(forward ? key3 : key1, loc1));
+    ASSERT_EQ(cursor->next(), boost::none);
+    ASSERT_EQ(cursor->keysExaminedInSeekBatch(), 3U);
+}
+TEST(SortedDataInterface, SeekBatch_SaveRestoreBetweenRanges_Unique_Forward) {
+    testSeekBatch_SaveRestoreBetweenRanges(true, true);
+}
+TEST(SortedDataInterface, SeekBatch_SaveRestoreBetweenRanges_Unique_Reverse) {
+    testSeekBatch_SaveRestoreBetweenRanges(true, false);
+}
+TEST(SortedDataInterface, SeekBatch_SaveRestoreBetweenRanges_Standard_Forward) {
+    testSeekBatch_SaveRestoreBetweenRanges(false, true);
+}
+TEST(SortedDataInterface, SeekBatch_SaveRestoreBetweenRanges_Standard_Reverse) {
+    testSeekBatch_SaveRestoreBetweenRanges(false, false);
+}
+
+// Tests that every duplicate of a key is returned for each range. Doesn't make sense for unique
+// indexes.
+void testSeekBatch_Dups(bool forward) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(/*unique=*/false,
+                                                        /*partial=*/false,
+                                                        {
+                                                            {key1, loc1},
+                                                            {key1, loc2},
+                                                            {key2, loc1},
+                                                            {key2, loc2},
+                                                        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), forward);
+
+    const auto& firstKey = forward ? key1 : key2;
+    const auto& secondKey = forward ? key2 : key1;
+    const auto& firstLoc = forward ? loc1 : loc2;
+    const auto& secondLoc = forward ? loc2 : loc1;
+
+    std::vector<SeekRange> ranges;
+    ranges.push_back(makeRange(sorted.get(), firstKey, firstKey, forward));
+    ranges.push_back(makeRange(sorted.get(), secondKey, secondKey, forward));
+    cursor->setSeekBatch(std::move(ranges));
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(firstKey, firstLoc));
+    ASSERT_EQ(cursor->next(), IndexKeyEntry(firstKey, secondLoc));
+    ASSERT_EQ(cursor->next(), boost::none);
+
+    ASSERT_EQ(cursor->seekNextInBatch(), IndexKeyEntry(secondKey, firstLoc));
+    ASSERT_EQ(cursor->next(), IndexKeyEntry(secondKey, secondLoc));
+    ASSERT_EQ(cursor->next(), boost::none);
+    ASSERT_EQ(cursor->keysExaminedInSeekBatch(), 4U);
+}
+TEST(SortedDataInterface, SeekBatch_Dups_Forward) {
+    testSeekBatch_Dups(true);
+}
+TEST(SortedDataInterface, SeekBatch_Dups_Reverse) {
+    testSeekBatch_Dups(false);
+}
+
+}  // namespace
+}  // namespace mongo
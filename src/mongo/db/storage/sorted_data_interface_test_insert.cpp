@@ -716,5 +716,78 @@ TEST(SortedDataInterface, InsertReservedRecordId) {
     ASSERT_EQUALS(1, sorted->numEntries(opCtx.get()));
 }
 
+// Insert a sorted batch of keys and verify that a cursor returns all of them in order.
+TEST(SortedDataInterface, InsertSorted) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/false, /*partial=*/false));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->insert(opCtx.get(), makeKeyString(sorted.get(), key2, loc1), true));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            const KeyStringSet keys{makeKeyString(sorted.get(), key3, loc3),
+                                    makeKeyString(sorted.get(), key1, loc2),
+                                    makeKeyString(sorted.get(), key2, loc2),
+                                    makeKeyString(sorted.get(), key4, loc1)};
+            ASSERT_OK(sorted->insertSorted(opCtx.get(), keys, true));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(5, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(makeKeyStringForSeek(sorted.get(), BSONObj(), true, true)),
+                  IndexKeyEntry(key1, loc2));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key2, loc1));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key2, loc2));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key3, loc3));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key4, loc1));
+        ASSERT_EQ(cursor->next(), boost::none);
+    }
+}
+
+// A sorted batch containing a duplicate for a unique index stops at the duplicate.
+TEST(SortedDataInterface, InsertSortedWithDuplicateIntoUnique) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/true, /*partial=*/false));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->insert(opCtx.get(), makeKeyString(sorted.get(), key2, loc1), false));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        const KeyStringSet keys{makeKeyString(sorted.get(), key1, loc2),
+                                makeKeyString(sorted.get(), key2, loc2),
+                                makeKeyString(sorted.get(), key3, loc2)};
+        ASSERT_EQUALS(ErrorCodes::DuplicateKey, sorted->insertSorted(opCtx.get(), keys, false));
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(1, sorted->numEntries(opCtx.get()));
+    }
+}
+
 }  // namespace
 }  // namespace mongo
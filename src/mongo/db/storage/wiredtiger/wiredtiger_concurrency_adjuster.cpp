@@ -0,0 +1,297 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_concurrency_adjuster.h"
+
+#include <algorithm>
+#include <wiredtiger.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+
+namespace mongo {
+namespace {
+
+// The cache is treated as under pressure once it is this full, which is where WiredTiger's
+// default eviction trigger makes application threads help with eviction.
+constexpr double kCacheFullFraction = 0.95;
+
+}  // namespace
+
+WiredTigerConcurrencyAdjuster::Decision WiredTigerConcurrencyAdjuster::Controller::decide(
+    const Sample& sample, int minTickets, int maxTickets) {
+    _lastAdmitted = sample.admitted;
+    _lastWaitMicrosPerOp = sample.admitted > 0 ? sample.waitMicros / sample.admitted : 0;
+
+    maxTickets = std::max(minTickets, maxTickets);
+    auto clamp = [&](int tickets) { return std::clamp(tickets, minTickets, maxTickets); };
+    const int step = std::max(1, sample.tickets / 8);
+
+    auto stopProbing = [&] {
+        _direction = 0;
+        _baselineAdmitted.reset();
+    };
+
+    // Starts, or continues, a probe in 'direction', or the other one if the pool is already at
+    // the bound in that direction.
+    auto probe = [&](int direction) {
+        int tickets = clamp(sample.tickets + direction * step);
+        if (tickets == sample.tickets) {
+            direction = -direction;
+            tickets = clamp(sample.tickets + direction * step);
+        }
+        if (tickets == sample.tickets) {
+            stopProbing();
+            return _record(Action::kHold, sample.tickets);
+        }
+        _direction = direction;
+        _baselineAdmitted = sample.admitted;
+        _baselineTickets = sample.tickets;
+        return _record(direction > 0 ? Action::kIncrease : Action::kDecrease, tickets);
+    };
+
+    if (sample.cachePressure) {
+        stopProbing();
+        _pauseIntervals = kPauseIntervals;
+        return _record(Action::kBackOff,
+                       clamp(sample.tickets - std::max(1, sample.tickets / 4)));
+    }
+
+    if (clamp(sample.tickets) != sample.tickets) {
+        // The bounds changed, or the pool was resized by hand.
+        stopProbing();
+        return _record(sample.tickets < minTickets ? Action::kIncrease : Action::kDecrease,
+                       clamp(sample.tickets));
+    }
+
+    if (_pauseIntervals > 0 || !sample.saturated) {
+        // Throughput is not limited by the pool size when nothing queues, so there is nothing to
+        // learn from probing.
+        _pauseIntervals = std::max(_pauseIntervals - 1, 0);
+        stopProbing();
+        return _record(Action::kHold, sample.tickets);
+    }
+
+    if (_direction == 0) {
+        return probe(_nextDirection);
+    }
+
+    const long long baseline = *_baselineAdmitted;
+    const bool improved = sample.admitted > baseline * (1 + kSignificantChange);
+    const bool worse = sample.admitted < baseline * (1 - kSignificantChange);
+
+    // Keep going while more tickets raise throughput, or fewer tickets cost nothing.
+    if (improved || (_direction < 0 && !worse)) {
+        return probe(_direction);
+    }
+
+    const int tickets = clamp(_baselineTickets);
+    _nextDirection = -_direction;
+    _pauseIntervals = kPauseIntervals;
+    stopProbing();
+    return _record(Action::kRevert, tickets);
+}
+
+WiredTigerConcurrencyAdjuster::Decision WiredTigerConcurrencyAdjuster::Controller::_record(
+    Action action, int tickets) {
+    switch (action) {
+        case Action::kHold:
+            break;
+        case Action::kIncrease:
+            _numIncreases++;
+            break;
+        case Action::kDecrease:
+            _numDecreases++;
+            break;
+        case Action::kRevert:
+            _numReverts++;
+            break;
+        case Action::kBackOff:
+            _numBackOffs++;
+            break;
+    }
+    _lastAction = action;
+    _lastTickets = tickets;
+    return {action, tickets};
+}
+
+void WiredTigerConcurrencyAdjuster::Controller::appendStats(BSONObjBuilder* builder) const {
+    builder->append("lastAction", static_cast<int>(_lastAction));
+    builder->append("tickets", _lastTickets);
+    builder->append("lastAdmitted", _lastAdmitted);
+    builder->append("lastWaitMicrosPerOp", _lastWaitMicrosPerOp);
+    builder->append("increases", _numIncreases);
+    builder->append("decreases", _numDecreases);
+    builder->append("reverts", _numReverts);
+    builder->append("backOffs", _numBackOffs);
+}
+
+WiredTigerConcurrencyAdjuster::WiredTigerConcurrencyAdjuster(WiredTigerSessionCache* sessionCache,
+                                                             TicketHolder* readTickets,
+                                                             TicketHolder* writeTickets)
+    : _sessionCache(sessionCache), _read("read", readTickets), _write("write", writeTickets) {}
+
+WiredTigerConcurrencyAdjuster::~WiredTigerConcurrencyAdjuster() {
+    haltThread();
+}
+
+void WiredTigerConcurrencyAdjuster::startThread() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(!_isRunning);
+    _shuttingDown.store(false);
+    _thread = stdx::thread(&WiredTigerConcurrencyAdjuster::_adjustLoop, this);
+    _isRunning = true;
+}
+
+void WiredTigerConcurrencyAdjuster::haltThread() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_isRunning) {
+            return;
+        }
+        _shuttingDown.store(true);
+        _isRunning = false;
+        _shutdownCV.notify_one();
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void WiredTigerConcurrencyAdjuster::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    BSONObjBuilder adjusterBuilder(builder->subobjStart("concurrencyAdjustment"));
+    adjusterBuilder.append("enabled", gWiredTigerConcurrencyAdjustment.load());
+    for (const Pool* pool : {&_read, &_write}) {
+        BSONObjBuilder poolBuilder(adjusterBuilder.subobjStart(pool->name));
+        pool->controller.appendStats(&poolBuilder);
+    }
+}
+
+void WiredTigerConcurrencyAdjuster::_adjustLoop() {
+    Client::initThread("WTConcurrencyAdjuster");
+    LOGV2_DEBUG(5035002, 1, "Starting the WiredTiger concurrency adjuster thread");
+
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            const Milliseconds interval(gWiredTigerConcurrencyAdjustmentIntervalMillis.load());
+            _shutdownCV.wait_for(
+                lk, interval.toSystemDuration(), [&] { return _shuttingDown.load(); });
+        }
+        if (_shuttingDown.load()) {
+            break;
+        }
+
+        if (!gWiredTigerConcurrencyAdjustment.load()) {
+            // Keep the counters current, so that the first interval after the adjustment is
+            // enabled is measured on its own.
+            stdx::lock_guard<Latch> lk(_mutex);
+            for (Pool* pool : {&_read, &_write}) {
+                pool->lastTotals = pool->tickets->getTotals();
+            }
+            continue;
+        }
+
+        const bool cachePressure = _sampleCachePressure();
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (Pool* pool : {&_read, &_write}) {
+            _adjust(pool, cachePressure);
+        }
+    }
+
+    LOGV2_DEBUG(5035003, 1, "Stopping the WiredTiger concurrency adjuster thread");
+}
+
+bool WiredTigerConcurrencyAdjuster::_sampleCachePressure() {
+    auto session = _sessionCache->getSession();
+    auto getStat = [&](int key) -> long long {
+        auto result = WiredTigerUtil::getStatisticsValue(
+            session->getSession(), "statistics:", "statistics=(fast)", key);
+        return result.isOK() ? result.getValue() : 0;
+    };
+
+    const long long appEvictions = getStat(WT_STAT_CONN_CACHE_EVICTION_APP);
+    const bool evicted = _lastAppEvictions >= 0 && appEvictions > _lastAppEvictions;
+    _lastAppEvictions = appEvictions;
+
+    const long long bytesInUse = getStat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+    const long long bytesMax = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    return evicted || (bytesMax > 0 && bytesInUse > bytesMax * kCacheFullFraction);
+}
+
+void WiredTigerConcurrencyAdjuster::_adjust(Pool* pool, bool cachePressure) {
+    const auto totals = pool->tickets->getTotals();
+
+    Sample sample;
+    sample.tickets = pool->tickets->outof();
+    sample.admitted = totals.admitted - pool->lastTotals.admitted;
+    sample.waitMicros = totals.totalWaitMicros - pool->lastTotals.totalWaitMicros;
+    sample.saturated = totals.waiting > 0 || sample.waitMicros > 0;
+    sample.cachePressure = cachePressure;
+    pool->lastTotals = totals;
+
+    const auto decision =
+        pool->controller.decide(sample,
+                                gWiredTigerConcurrencyAdjustmentMinTransactions.load(),
+                                gWiredTigerConcurrencyAdjustmentMaxTransactions.load());
+    if (decision.tickets == sample.tickets) {
+        return;
+    }
+
+    LOGV2_DEBUG(5035004,
+                1,
+                "Adjusting the number of concurrent transactions",
+                "pool"_attr = pool->name,
+                "action"_attr = static_cast<int>(decision.action),
+                "from"_attr = sample.tickets,
+                "to"_attr = decision.tickets,
+                "admitted"_attr = sample.admitted,
+                "waitMicros"_attr = sample.waitMicros);
+    auto status = pool->tickets->resize(decision.tickets);
+    if (!status.isOK()) {
+        LOGV2_WARNING(5035005,
+                      "Failed to adjust the number of concurrent transactions",
+                      "pool"_attr = pool->name,
+                      "error"_attr = status);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/ticketholder.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class WiredTigerSessionCache;
+
+/**
+ * Resizes the read and write ticket pools, instead of leaving them at their configured sizes, so
+ * that the number of concurrent storage transactions tracks what the machine can actually
+ * sustain.
+ *
+ * A background thread started by startThread() samples, once per interval, how many tickets were
+ * handed out and whether operations had to queue for them, along with whether WiredTiger is
+ * making application threads evict pages. Each pool has its own Controller, which climbs towards
+ * the ticket count with the highest throughput and backs off whenever the cache is under
+ * pressure, since more concurrency then only adds to the eviction work.
+ *
+ * Every decision is reported by appendStats(), which is part of serverStatus and so is captured
+ * by FTDC.
+ */
+class WiredTigerConcurrencyAdjuster {
+    WiredTigerConcurrencyAdjuster(const WiredTigerConcurrencyAdjuster&) = delete;
+    WiredTigerConcurrencyAdjuster& operator=(const WiredTigerConcurrencyAdjuster&) = delete;
+
+public:
+    // The values are reported in serverStatus, so must not change.
+    enum class Action {
+        // Keep the current number of tickets.
+        kHold = 0,
+        // Probe for more throughput with more tickets.
+        kIncrease = 1,
+        // Probe for the same throughput with fewer tickets.
+        kDecrease = 2,
+        // The last probe did not pay off, go back to the ticket count it started from.
+        kRevert = 3,
+        // The cache is under pressure, cut the number of tickets.
+        kBackOff = 4,
+    };
+
+    /**
+     * What happened to one ticket pool over an interval.
+     */
+    struct Sample {
+        int tickets = 0;
+        long long admitted = 0;
+        long long waitMicros = 0;
+        // Operations queued for tickets, so the pool size limited throughput.
+        bool saturated = false;
+        bool cachePressure = false;
+    };
+
+    struct Decision {
+        Action action;
+        int tickets;
+    };
+
+    /**
+     * Decides the size of one ticket pool. The pool only grows while operations are queueing for
+     * tickets and a larger size keeps raising throughput, and it keeps shrinking for as long as
+     * doing so does not lower throughput. A probe which did not pay off is undone, and the next
+     * probe, after a pause, goes the other way.
+     */
+    class Controller {
+    public:
+        // Throughput changes smaller than this fraction are treated as noise.
+        static constexpr double kSignificantChange = 0.05;
+        // Intervals to wait after a revert or a back off before probing again.
+        static constexpr int kPauseIntervals = 3;
+
+        Decision decide(const Sample& sample, int minTickets, int maxTickets);
+
+        void appendStats(BSONObjBuilder* builder) const;
+
+    private:
+        Decision _record(Action action, int tickets);
+
+        // The direction of the probe in progress, +1 for more tickets and -1 for fewer, or 0.
+        int _direction = 0;
+        int _nextDirection = 1;
+        // Throughput before the probe in progress and the ticket count it was measured at.
+        boost::optional<long long> _baselineAdmitted;
+        int _baselineTickets = 0;
+        int _pauseIntervals = 0;
+
+        Action _lastAction = Action::kHold;
+        int _lastTickets = 0;
+        long long _lastAdmitted = 0;
+        long long _lastWaitMicrosPerOp = 0;
+        long long _numIncreases = 0;
+        long long _numDecreases = 0;
+        long long _numReverts = 0;
+        long long _numBackOffs = 0;
+    };
+
+    WiredTigerConcurrencyAdjuster(WiredTigerSessionCache* sessionCache,
+                                  TicketHolder* readTickets,
+                                  TicketHolder* writeTickets);
+    ~WiredTigerConcurrencyAdjuster();
+
+    void startThread();
+    void haltThread();
+
+    /**
+     * Appends a "concurrencyAdjustment" subobject with the last decision for each pool and how
+     * many of each kind have been made.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Pool {
+        Pool(StringData name, TicketHolder* tickets) : name(name), tickets(tickets) {}
+
+        const StringData name;
+        TicketHolder* const tickets;
+        TicketHolder::Totals lastTotals;
+        Controller controller;
+    };
+
+    void _adjustLoop();
+
+    /**
+     * Returns whether application threads evicted pages since the last call, or the cache is
+     * close to full.
+     */
+    bool _sampleCachePressure();
+
+    void _adjust(Pool* pool, bool cachePressure);
+
+    WiredTigerSessionCache* const _sessionCache;
+
+    stdx::thread _thread;
+
+    AtomicWord<bool> _shuttingDown{false};
+
+    // Protects the state below.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerConcurrencyAdjuster::_mutex");
+
+    // Signaled when the thread should stop.
+    stdx::condition_variable _shutdownCV;
+
+    bool _isRunning = false;
+    Pool _read;
+    Pool _write;
+
+    // Only used by the background thread. -1 until the first sample.
+    long long _lastAppEvictions = -1;
+};
+
+}  // namespace mongo
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_concurrency_adjuster.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Action = WiredTigerConcurrencyAdjuster::Action;
+using Controller = WiredTigerConcurrencyAdjuster::Controller;
+using Sample = WiredTigerConcurrencyAdjuster::Sample;
+
+constexpr int kMinTickets = 16;
+constexpr int kMaxTickets = 512;
+
+Sample makeSample(int tickets, long long admitted, bool saturated = true) {
+    Sample sample;
+    sample.tickets = tickets;
+    sample.admitted = admitted;
+    sample.saturated = saturated;
+    return sample;
+}
+
+// A workload whose throughput grows with concurrency up to 'knee' transactions and is flat after.
+long long throughputWithKnee(int tickets, int knee) {
+    return std::min(tickets, knee) * 100LL;
+}
+
+TEST(WiredTigerConcurrencyAdjusterTest, HoldsWhenNothingQueues) {
+    Controller controller;
+    for (int i = 0; i < 10; i++) {
+        auto decision =
+            controller.decide(makeSample(128, 1000, false), kMinTickets, kMaxTickets);
+        ASSERT(decision.action == Action::kHold);
+        ASSERT_EQ(decision.tickets, 128);
+    }
+}
+
+TEST(WiredTigerConcurrencyAdjusterTest, KeepsGrowingWhileThroughputImproves) {
+    Controller controller;
+    int tickets = 32;
+    for (int i = 0; i < 5; i++) {
+        auto decision = controller.decide(
+            makeSample(tickets, throughputWithKnee(tickets, 1000)), kMinTickets, kMaxTickets);
+        ASSERT(decision.action == Action::kIncrease);
+        ASSERT_GT(decision.tickets, tickets);
+        tickets = decision.tickets;
+    }
+}
+
+TEST(WiredTigerConcurrencyAdjusterTest, RevertsProbeWhichDoesNotPayOff) {
+    Controller controller;
+    auto decision = controller.decide(makeSample(128, 6400), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kIncrease);
+    const int probed = decision.tickets;
+
+    decision = controller.decide(makeSample(probed, 6400), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kRevert);
+    ASSERT_EQ(decision.tickets, 128);
+
+    // After a pause, the next probe goes the other way.
+    for (int i = 0; i < Controller::kPauseIntervals; i++) {
+        decision = controller.decide(makeSample(128, 6400), kMinTickets, kMaxTickets);
+        ASSERT(decision.action == Action::kHold);
+    }
+    decision = controller.decide(makeSample(128, 6400), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kDecrease);
+    ASSERT_LT(decision.tickets, 128);
+}
+
+TEST(WiredTigerConcurrencyAdjusterTest, ConvergesOnThroughputKnee) {
+    Controller controller;
+    const int knee = 64;
+    int tickets = 128;
+    for (int i = 0; i < 200; i++) {
+        auto decision = controller.decide(
+            makeSample(tickets, throughputWithKnee(tickets, knee)), kMinTickets, kMaxTickets);
+        tickets = decision.tickets;
+    }
+    ASSERT_GTE(tickets, knee * 7 / 8);
+    ASSERT_LTE(tickets, knee * 5 / 4);
+
+    BSONObjBuilder builder;
+    controller.appendStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_GT(stats["decreases"].numberLong(), 0);
+    ASSERT_GT(stats["reverts"].numberLong(), 0);
+}
+
+TEST(WiredTigerConcurrencyAdjusterTest, BacksOffUnderCachePressure) {
+    Controller controller;
+    auto sample = makeSample(128, 6400);
+    sample.cachePressure = true;
+    auto decision = controller.decide(sample, kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kBackOff);
+    ASSERT_EQ(decision.tickets, 96);
+
+    // Never below the minimum.
+    sample.tickets = kMinTickets;
+    decision = controller.decide(sample, kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kBackOff);
+    ASSERT_EQ(decision.tickets, kMinTickets);
+
+    // Probing waits for the cache to recover.
+    decision = controller.decide(makeSample(96, 6400), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kHold);
+}
+
+TEST(WiredTigerConcurrencyAdjusterTest, MovesIntoBounds) {
+    Controller controller;
+    auto decision = controller.decide(makeSample(1000, 6400, false), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kDecrease);
+    ASSERT_EQ(decision.tickets, kMaxTickets);
+
+    decision = controller.decide(makeSample(8, 6400, false), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kIncrease);
+    ASSERT_EQ(decision.tickets, kMinTickets);
+
+    // At the upper bound, the first probe goes down instead.
+    decision = controller.decide(makeSample(kMaxTickets, 6400), kMinTickets, kMaxTickets);
+    ASSERT(decision.action == Action::kDecrease);
+    ASSERT_LT(decision.tickets, kMaxTickets);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -51,6 +51,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor_helpers.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -286,6 +287,27 @@ Status WiredTigerIndex::insert(OperationContext* opCtx,
     return _insert(opCtx, c, keyString, dupsAllowed);
 }
 
+Status WiredTigerIndex::insertSorted(OperationContext* opCtx,
+                                     const KeyStringSet& keys,
+                                     bool dupsAllowed) {
+    dassert(opCtx->lockState()->isWriteLocked());
+
+    // A single cursor serves the whole batch. The keys arrive in index order, so WiredTiger can
+    // find each insert position close to the previous one.
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const auto& keyString : keys) {
+        dassert(
+            KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize()).isValid());
+        Status status = _insert(opCtx, c, keyString, dupsAllowed);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
 void WiredTigerIndex::unindex(OperationContext* opCtx,
                               const KeyString::Value& keyString,
                               bool dupsAllowed) {
@@ -854,9 +876,13 @@ public:
           _forward(forward),
           _key(idx.getKeyStringVersion()),
           _typeBits(idx.getKeyStringVersion()),
+          _keyDecoder(idx.getOrdering()),
           _query(idx.getKeyStringVersion()),
           _prefix(prefix) {
         _cursor.emplace(_idx.uri(), _idx.tableId(), false, _opCtx);
+        if (_forward && _prefix == KVPrefix::kNotPrefixed) {
+            _readAhead.emplace(_idx.uri(), WiredTigerReadAheadManager::KeyFormat::kKeyString);
+        }
     }
 
     boost::optional<IndexKeyEntry> next(RequestedInfo parts) override {
@@ -906,6 +932,10 @@ public:
     boost::optional<KeyStringEntry> seekForKeyString(
         const KeyString::Value& keyStringValue) override {
         dassert(_opCtx->lockState()->isReadLocked());
+        _positionedInSeekBatch = false;
+        if (_readAhead) {
+            _readAhead->reset();
+        }
         seekWTCursor(keyStringValue);
 
         updatePosition();
@@ -966,7 +996,30 @@ public:
         return {};
     }
 
+    void setSeekBatch(std::vector<SeekRange> ranges) override {
+        _seekBatch = std::move(ranges);
+        _seekBatchPos = 0;
+        _positionedInSeekBatch = false;
+        _keysExaminedInSeekBatch = 0;
+    }
+
+    boost::optional<IndexKeyEntry> seekNextInBatch(RequestedInfo parts) override {
+        dassert(_opCtx->lockState()->isReadLocked());
+        invariant(_seekBatchPos < _seekBatch.size());
+
+        // Only move on to the next range once this one has been positioned on, so that a caller
+        // retrying after a WriteConflictException seeks to the same range again.
+        auto entry = seekInBatch(_seekBatch[_seekBatchPos], parts);
+        ++_seekBatchPos;
+        return entry;
+    }
+
+    size_t keysExaminedInSeekBatch() const override {
+        return _keysExaminedInSeekBatch;
+    }
+
     void save() override {
+        _positionedInSeekBatch = false;
         try {
             if (_cursor)
                 _cursor->reset();
@@ -1075,8 +1128,7 @@ protected:
 
         BSONObj bson;
         if (TRACING_ENABLED || (parts & kWantKey)) {
-            bson =
-                KeyString::toBson(_key.getBuffer(), _key.getSize(), _idx.getOrdering(), _typeBits);
+            bson = _keyDecoder.decode(_key.getBuffer(), _key.getSize(), _typeBits);
 
             LOGV2_TRACE_CURSOR(20000, "returning {bson} {id}", "bson"_attr = bson, "id"_attr = _id);
         }
@@ -1123,6 +1175,50 @@ protected:
         _cursorAtEof = false;
     }
 
+    // Positions the cursor on the first entry of 'range' and makes it the end of the scan.
+    boost::optional<IndexKeyEntry> seekInBatch(const SeekRange& range, RequestedInfo parts) {
+        // The position left behind by the previous range can only be reused if that range was
+        // scanned to its end without the cursor being moved or repositioned in between.
+        const bool canReusePosition = _positionedInSeekBatch && _eof;
+        setEndPosition(range.endKey, range.endInclusive);
+
+        if (canReusePosition && _cursorAtEof) {
+            // The previous range ran off the end of the index, so this one can't have any entries
+            // since the ranges are sorted in the direction of the cursor.
+            return {};
+        }
+
+        if (canReusePosition) {
+            // The cursor is parked on the first key past the end of the previous range. Since this
+            // range starts at or after that end point, if the parked key is not before our seek
+            // key it is also the first key in this range, and no search of the tree is needed.
+            const int cmp = _key.compare(range.seekKey);
+            if (_forward ? cmp >= 0 : cmp <= 0) {
+                _eof = false;
+                if (atOrPastEndPointAfterSeeking()) {
+                    _eof = true;
+                    return {};
+                }
+                _lastMoveSkippedKey = false;
+                updateIdAndTypeBits();
+                return curr(parts);
+            }
+        }
+
+        // Leave the WiredTiger cursor positioned rather than resetting it, so that its search can
+        // start from the currently pinned leaf page when the next key lives nearby.
+        if (_readAhead) {
+            _readAhead->reset();
+        }
+        seekWTCursor(range.seekKey);
+        updatePosition();
+        _positionedInSeekBatch = true;
+        if (!_cursorAtEof) {
+            ++_keysExaminedInSeekBatch;
+        }
+        return curr(parts);
+    }
+
     // Seeks to query. Returns true on exact match.
     bool seekWTCursor(const KeyString::Value& query) {
         // Ensure an active transaction is open.
@@ -1236,6 +1332,18 @@ protected:
             advanceWTCursor();
         }
         updatePosition(true);
+
+        if (!_seekBatch.empty() && !_cursorAtEof) {
+            ++_keysExaminedInSeekBatch;
+        }
+
+        if (_readAhead && !_eof && _readAhead->advanced(_key.getSize())) {
+            _readAhead->scheduleFrom(
+                _opCtx,
+                std::string(_key.getBuffer(), _key.getSize()),
+                _endPosition ? std::string(_endPosition->getBuffer(), _endPosition->getSize())
+                             : std::string());
+        }
         return true;
     }
 
@@ -1279,6 +1387,12 @@ protected:
     RecordId _id;
     bool _eof = true;
 
+    // Decodes _key for curr(), reusing the leading fields it shares with the last key decoded.
+    mutable KeyString::PrefixDecoder _keyDecoder;
+
+    // Reads ahead of long forward scans. Not used for reverse or prefixed cursors.
+    boost::optional<WiredTigerReadAheadTracker> _readAhead;
+
     // This differs from _eof in that it always reflects the result of the most recent call to
     // reposition _cursor.
     bool _cursorAtEof = false;
@@ -1291,6 +1405,17 @@ protected:
     KVPrefix _prefix;
 
     std::unique_ptr<KeyString::Builder> _endPosition;
+
+    // The ranges submitted by setSeekBatch() and the index of the next one to visit.
+    std::vector<SeekRange> _seekBatch;
+    size_t _seekBatchPos = 0;
+
+    // True while the cursor's position was reached by seekNextInBatch() and subsequent calls to
+    // next() only. Any other repositioning, or saving the cursor, resets it.
+    bool _positionedInSeekBatch = false;
+
+    // The number of keys the cursor has landed on since setSeekBatch(), returned or not.
+    size_t _keysExaminedInSeekBatch = 0;
 };
 
 // The Standard Cursor doesn't need anything more than the base has.
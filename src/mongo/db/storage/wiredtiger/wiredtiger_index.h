@@ -102,6 +102,10 @@ public:
                           const KeyString::Value& keyString,
                           bool dupsAllowed);
 
+    virtual Status insertSorted(OperationContext* opCtx,
+                                const KeyStringSet& keys,
+                                bool dupsAllowed);
+
     virtual void unindex(OperationContext* opCtx,
                          const KeyString::Value& keyString,
                          bool dupsAllowed);
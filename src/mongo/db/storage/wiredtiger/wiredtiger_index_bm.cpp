@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/system_clock_source.h"
+
+namespace mongo {
+namespace {
+
+// The number of entries in the index that the benchmarks seek into. Entry i has key {"": i}.
+const int kNumIndexKeys = 500 * 1000;
+
+/**
+ * Owns a WiredTiger connection holding a single standard index on {a: 1}, populated with
+ * kNumIndexKeys entries. Building the index is slow, so a single instance is shared by every run.
+ */
+class WiredTigerIndexBenchmarkHelper {
+public:
+    WiredTigerIndexBenchmarkHelper() : _dbpath("wt_index_bm"), _conn(nullptr) {
+        const char* config = "create,cache_size=1G,";
+        invariantWTOK(wiredtiger_open(_dbpath.path().c_str(), nullptr, config, &_conn));
+        _sessionCache = std::make_unique<WiredTigerSessionCache>(_conn, &_clockSource);
+
+        const std::string ns = "test.wt_index_bm";
+        BSONObj spec = BSON("key" << BSON("a" << 1) << "name"
+                                  << "a_1"
+                                  << "v" << static_cast<int>(IndexDescriptor::kLatestIndexVersion));
+        _desc = std::make_unique<IndexDescriptor>("", spec);
+
+        auto opCtx = newOperationContext();
+        auto createString = WiredTigerIndex::generateCreateString(
+            kWiredTigerEngineName, "", "", NamespaceString(ns), *_desc, false /* isPrefixed */);
+        invariant(createString.getStatus());
+
+        const std::string uri = "table:" + ns;
+        invariantWTOK(WiredTigerIndex::Create(opCtx.get(), uri, createString.getValue()));
+        _index = std::make_unique<WiredTigerIndexStandard>(
+            opCtx.get(), uri, "" /* ident */, _desc.get(), KVPrefix::kNotPrefixed);
+
+        WriteUnitOfWork wuow(opCtx.get());
+        for (int i = 0; i < kNumIndexKeys; ++i) {
+            KeyString::Builder ks(
+                _index->getKeyStringVersion(), BSON("" << i), _index->getOrdering());
+            ks.appendRecordId(RecordId(i + 1));
+            invariant(_index->insert(opCtx.get(), ks.getValueCopy(), true /* dupsAllowed */));
+        }
+        wuow.commit();
+    }
+
+    ~WiredTigerIndexBenchmarkHelper() {
+        _index.reset();
+        _sessionCache.reset();
+        _conn->close(_conn, nullptr);
+    }
+
+    std::unique_ptr<OperationContext> newOperationContext() {
+        return std::make_unique<OperationContextNoop>(
+            new WiredTigerRecoveryUnit(_sessionCache.get(), &_oplogManager));
+    }
+
+    SortedDataInterface* index() const {
+        return _index.get();
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    SystemClockSource _clockSource;
+    WT_CONNECTION* _conn;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+    WiredTigerOplogManager _oplogManager;
+    std::unique_ptr<IndexDescriptor> _desc;
+    std::unique_ptr<SortedDataInterface> _index;
+};
+
+WiredTigerIndexBenchmarkHelper& getHelper() {
+    static WiredTigerIndexBenchmarkHelper helper;
+    return helper;
+}
+
+/**
+ * Returns the sorted values of an $in list with 'numValues' entries. Dense lists hit consecutive
+ * index keys, while sparse lists are spread evenly over the whole index.
+ */
+std::vector<int> makeInList(int numValues, bool sparse) {
+    const int stride = sparse ? kNumIndexKeys / numValues : 1;
+    std::vector<int> values;
+    values.reserve(numValues);
+    for (int i = 0; i < numValues; ++i) {
+        values.push_back(i * stride);
+    }
+    return values;
+}
+
+KeyString::Value makeSeekKey(SortedDataInterface* index, int value) {
+    return IndexEntryComparison::makeKeyStringFromBSONKeyForSeek(BSON("" << value),
+                                                                 index->getKeyStringVersion(),
+                                                                 index->getOrdering(),
+                                                                 true /* forward */,
+                                                                 true /* inclusive */);
+}
+
+// Visits each point interval with its own seek, checking the key found after the end of each
+// interval against the bounds as IndexBoundsChecker does.
+void BM_IndexSeekPerInterval(benchmark::State& state) {
+    auto& helper = getHelper();
+    auto index = helper.index();
+    const auto values = makeInList(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        auto opCtx = helper.newOperationContext();
+        auto cursor = index->newCursor(opCtx.get(), true /* forward */);
+        size_t numFound = 0;
+        for (auto value : values) {
+            const BSONObj point = BSON("" << value);
+            for (auto kv = cursor->seek(makeSeekKey(index, value));
+                 kv && kv->key.woCompare(point, BSONObj(), false) == 0;
+                 kv = cursor->next()) {
+                ++numFound;
+            }
+        }
+        invariant(numFound == values.size());
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+// Visits each point interval through a single batch of seeks submitted to the cursor up front.
+void BM_IndexSeekBatch(benchmark::State& state) {
+    auto& helper = getHelper();
+    auto index = helper.index();
+    const auto values = makeInList(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        auto opCtx = helper.newOperationContext();
+        auto cursor = index->newCursor(opCtx.get(), true /* forward */);
+
+        std::vector<SortedDataInterface::Cursor::SeekRange> seekBatch;
+        seekBatch.reserve(values.size());
+        for (auto value : values) {
+            seekBatch.push_back({makeSeekKey(index, value), BSON("" << value), true});
+        }
+        cursor->setSeekBatch(std::move(seekBatch));
+
+        size_t numFound = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            for (auto kv = cursor->seekNextInBatch(); kv; kv = cursor->next()) {
+                ++numFound;
+            }
+        }
+        invariant(numFound == values.size());
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+// Arguments are the number of $in values and whether they are spread over the whole index.
+BENCHMARK(BM_IndexSeekPerInterval)
+    ->RangeMultiplier(10)
+    ->Ranges({{1000, 100 * 1000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IndexSeekBatch)
+    ->RangeMultiplier(10)
+    ->Ranges({{1000, 100 * 1000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
@@ -479,6 +479,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = std::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    if (!_ephemeral) {
+        _readAheadManager = std::make_unique<WiredTigerReadAheadManager>(_sessionCache.get());
+        _readAheadManager->startThread();
+    }
+
     // Until the Replication layer installs a real callback, prevent truncating the oplog.
     setOldestActiveTransactionTimestampCallback(
         [](Timestamp) { return StatusWith(boost::make_optional(Timestamp::min())); });
@@ -518,6 +523,12 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 
+    if (!_ephemeral) {
+        _concurrencyAdjuster = std::make_unique<WiredTigerConcurrencyAdjuster>(
+            _sessionCache.get(), &openReadTransaction, &openWriteTransaction);
+        _concurrencyAdjuster->startThread();
+    }
+
     _runTimeConfigParam.reset(new WiredTigerEngineRuntimeConfigParameter(
         "wiredTigerEngineRuntimeConfig", ServerParameterType::kRuntimeOnly));
     _runTimeConfigParam->_data.second = this;
@@ -544,6 +555,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        {
+            BSONObjBuilder queues(bbb.subobjStart("queues"));
+            openWriteTransaction.appendStats(&queues);
+        }
         bbb.done();
     }
     {
@@ -551,6 +566,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        {
+            BSONObjBuilder queues(bbb.subobjStart("queues"));
+            openReadTransaction.appendStats(&queues);
+        }
         bbb.done();
     }
     bb.done();
@@ -662,6 +681,12 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_readAheadManager) {
+        _readAheadManager->haltThread();
+    }
+    if (_concurrencyAdjuster) {
+        _concurrencyAdjuster->haltThread();
+    }
     LOGV2_FOR_RECOVERY(23988,
                        2,
                        "Shutdown timestamps.",
@@ -2114,6 +2139,18 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
                        "Rolling back to the stable timestamp",
                        "stableTimestamp"_attr = stableTimestamp,
                        "initialDataTimestamp"_attr = initialDataTimestamp);
+
+    // Rolling back to stable fails if any session has a cursor open, and the read-ahead thread
+    // reads without holding any locks, so it is paused until the rollback is done.
+    if (_readAheadManager) {
+        _readAheadManager->pause();
+    }
+    ON_BLOCK_EXIT([&] {
+        if (_readAheadManager) {
+            _readAheadManager->resume();
+        }
+    });
+
     int ret = _conn->rollback_to_stable(_conn, nullptr);
     if (ret) {
         return {ErrorCodes::UnrecoverableRollbackError,
@@ -42,7 +42,9 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_concurrency_adjuster.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/mutex.h"
@@ -332,6 +334,20 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Returns nullptr for in-memory engines, which have nothing to read ahead.
+     */
+    WiredTigerReadAheadManager* getReadAheadManager() const {
+        return _readAheadManager.get();
+    }
+
+    /**
+     * Returns nullptr for in-memory engines.
+     */
+    WiredTigerConcurrencyAdjuster* getConcurrencyAdjuster() const {
+        return _concurrencyAdjuster.get();
+    }
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
     Timestamp getStableTimestamp() const override;
@@ -473,6 +489,10 @@ private:
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
 
+    std::unique_ptr<WiredTigerReadAheadManager> _readAheadManager;
+
+    std::unique_ptr<WiredTigerConcurrencyAdjuster> _concurrencyAdjuster;
+
     std::string _rsOptions;
     std::string _indexOptions;
 
@@ -0,0 +1,333 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#include <wiredtiger.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// The number of windows that may be waiting for the background thread. Once it falls this far
+// behind, new requests are dropped rather than queued, as they would likely be overtaken anyway.
+const size_t kMaxQueuedWindows = 64;
+
+// A cursor must advance this many times without being repositioned before reading ahead of it.
+const int64_t kMinSequentialAdvances = 1000;
+
+int64_t decodeRecordId(const std::string& key) {
+    invariant(key.size() == sizeof(uint64_t));
+    return static_cast<int64_t>(ConstDataView(key.data()).read<BigEndian<uint64_t>>() ^
+                                (1ULL << 63));
+}
+
+void setKey(WT_CURSOR* c, WiredTigerReadAheadManager::KeyFormat format, const std::string& key) {
+    if (format == WiredTigerReadAheadManager::KeyFormat::kRecordId) {
+        c->set_key(c, decodeRecordId(key));
+    } else {
+        WT_ITEM item;
+        item.data = key.data();
+        item.size = key.size();
+        c->set_key(c, &item);
+    }
+}
+
+}  // namespace
+
+WiredTigerReadAheadManager::WiredTigerReadAheadManager(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache) {}
+
+WiredTigerReadAheadManager::~WiredTigerReadAheadManager() {
+    haltThread();
+}
+
+void WiredTigerReadAheadManager::startThread() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(!_isRunning);
+    _shuttingDown.store(false);
+    _thread = stdx::thread(&WiredTigerReadAheadManager::_readAheadLoop, this);
+    _isRunning = true;
+}
+
+void WiredTigerReadAheadManager::haltThread() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_isRunning) {
+            return;
+        }
+        _shuttingDown.store(true);
+        _isRunning = false;
+        _queue.clear();
+        _queueCV.notify_one();
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void WiredTigerReadAheadManager::pause() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    if (_pauseCount++ == 0) {
+        _paused.store(true);
+        _queue.clear();
+    }
+    _windowDoneCV.wait(lk, [&] { return !_isReadingWindow; });
+}
+
+void WiredTigerReadAheadManager::resume() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(_pauseCount > 0);
+    if (--_pauseCount == 0) {
+        _paused.store(false);
+    }
+}
+
+bool WiredTigerReadAheadManager::schedule(std::shared_ptr<Window> window) {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_isRunning && _pauseCount == 0 && _queue.size() < kMaxQueuedWindows) {
+            _queue.push_back(std::move(window));
+            _queueCV.notify_one();
+            _windowsScheduled.fetchAndAdd(1);
+            return true;
+        }
+    }
+    _windowsDropped.fetchAndAdd(1);
+    return false;
+}
+
+void WiredTigerReadAheadManager::appendStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder bob(builder->subobjStart("readAhead"));
+    bob.append("windowsScheduled", _windowsScheduled.load());
+    bob.append("windowsDropped", _windowsDropped.load());
+    bob.append("windowsUsed", _windowsUsed.load());
+    bob.append("windowsOvertaken", _windowsOvertaken.load());
+    bob.append("entriesRead", _entriesRead.load());
+    bob.append("bytesRead", _bytesRead.load());
+    bob.done();
+}
+
+std::string WiredTigerReadAheadManager::encodeRecordId(int64_t repr) {
+    // Flipping the sign bit of the big-endian representation makes negative ids sort first.
+    std::string key(sizeof(uint64_t), '\0');
+    DataView(&key[0]).write<BigEndian<uint64_t>>(static_cast<uint64_t>(repr) ^ (1ULL << 63));
+    return key;
+}
+
+void WiredTigerReadAheadManager::_readAheadLoop() {
+    Client::initThread("WTReadAhead");
+    LOGV2_DEBUG(5035000, 1, "Starting the WiredTiger read-ahead thread");
+
+    while (true) {
+        std::shared_ptr<Window> window;
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                _queueCV.wait(lk, [&] { return _shuttingDown.load() || !_queue.empty(); });
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+            window = std::move(_queue.front());
+            _queue.pop_front();
+            _isReadingWindow = true;
+        }
+
+        if (!window->cancelled.load()) {
+            _readAhead(window.get());
+        }
+        window->done.store(true);
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        _isReadingWindow = false;
+        _windowDoneCV.notify_all();
+    }
+
+    LOGV2_DEBUG(5035001, 1, "Stopping the WiredTiger read-ahead thread");
+}
+
+void WiredTigerReadAheadManager::_readAhead(Window* window) {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+
+    // The cursor is opened outside of any explicit transaction, and is closed before the session
+    // is returned to the cache, so the snapshot it uses is not held on to.
+    WT_CURSOR* c = nullptr;
+    if (s->open_cursor(s, window->uri.c_str(), nullptr, nullptr, &c) != 0) {
+        // The table may have been dropped since the window was requested.
+        return;
+    }
+    ON_BLOCK_EXIT([&] { c->close(c); });
+
+    setKey(c, window->format, window->startKey);
+    int cmp = 0;
+    int ret = c->search_near(c, &cmp);
+    if (ret == 0 && cmp < 0) {
+        ret = c->next(c);
+    }
+
+    const bool isKeyString = window->format == KeyFormat::kKeyString;
+    long long entries = 0;
+    long long bytes = 0;
+    WT_ITEM key;
+    WT_ITEM value;
+    while (ret == 0) {
+        if (isKeyString) {
+            if (c->get_key(c, &key) != 0) {
+                break;
+            }
+            if (!window->endKey.empty() &&
+                window->endKey.compare(
+                    0, std::string::npos, static_cast<const char*>(key.data), key.size) < 0) {
+                // Past the end of the range the cursor will scan.
+                window->reachedEnd = true;
+                break;
+            }
+            bytes += key.size;
+        }
+        if (c->get_value(c, &value) != 0) {
+            break;
+        }
+        bytes += value.size;
+        ++entries;
+
+        if (bytes >= window->maxBytes || window->cancelled.loadRelaxed() ||
+            _shuttingDown.loadRelaxed() || _paused.loadRelaxed()) {
+            if (isKeyString) {
+                window->lastKey.assign(static_cast<const char*>(key.data), key.size);
+            } else {
+                int64_t id;
+                if (c->get_key(c, &id) == 0) {
+                    window->lastKey = encodeRecordId(id);
+                }
+            }
+            break;
+        }
+        ret = c->next(c);
+    }
+
+    // Any other error, such as a prepare conflict, just ends the window early.
+    if (ret == WT_NOTFOUND) {
+        window->reachedEnd = true;
+    }
+
+    _entriesRead.fetchAndAdd(entries);
+    _bytesRead.fetchAndAdd(bytes);
+}
+
+bool WiredTigerReadAheadTracker::advanced(size_t bytes) {
+    if (_reachedEnd) {
+        return false;
+    }
+    if (_sequentialAdvances < kMinSequentialAdvances) {
+        ++_sequentialAdvances;
+        return false;
+    }
+
+    const int64_t windowBytes = gWiredTigerReadAheadBytes.load();
+    if (windowBytes <= 0) {
+        return false;
+    }
+    _bytesSinceScheduled += bytes;
+    return !_scheduled || _bytesSinceScheduled >= windowBytes;
+}
+
+void WiredTigerReadAheadTracker::scheduleFrom(OperationContext* opCtx,
+                                              std::string currentKey,
+                                              std::string endKey) {
+    _scheduled = true;
+    _bytesSinceScheduled = 0;
+
+    auto engine = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->getKVEngine();
+    auto manager = engine ? engine->getReadAheadManager() : nullptr;
+    if (!manager) {
+        _reachedEnd = true;
+        return;
+    }
+
+    const int64_t windowBytes = gWiredTigerReadAheadBytes.load();
+    std::string startKey = std::move(currentKey);
+    int64_t maxBytes = 2 * windowBytes;
+    if (_window) {
+        if (_window->done.load()) {
+            manager->noteWindowUsed();
+            if (_window->reachedEnd) {
+                // Everything up to the end of the scan has already been read.
+                _reachedEnd = true;
+                _window.reset();
+                return;
+            }
+            if (_window->lastKey > startKey) {
+                // Continue from where the previous window stopped.
+                startKey = std::move(_window->lastKey);
+                maxBytes = windowBytes;
+            }
+        } else {
+            // The cursor caught up with the read-ahead. Restart it from the cursor's position.
+            _window->cancelled.store(true);
+            manager->noteWindowOvertaken();
+        }
+    }
+
+    _window = std::make_shared<WiredTigerReadAheadManager::Window>(
+        _uri, _format, std::move(startKey), std::move(endKey), maxBytes);
+    if (!manager->schedule(_window)) {
+        _window.reset();
+    }
+}
+
+void WiredTigerReadAheadTracker::reset() {
+    if (_window) {
+        _window->cancelled.store(true);
+        _window.reset();
+    }
+    _sequentialAdvances = 0;
+    _bytesSinceScheduled = 0;
+    _scheduled = false;
+    _reachedEnd = false;
+}
+
+}  // namespace mongo
@@ -0,0 +1,219 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+class WiredTigerSessionCache;
+
+/**
+ * Reads ahead of long forward scans, so that a scan over a cold table finds the leaf pages it is
+ * about to visit already in the WiredTiger cache instead of stalling on each page read.
+ *
+ * WiredTiger has no asynchronous read interface, so a background thread started by
+ * startThread() walks each requested window of entries with its own session and cursor, which
+ * pulls the pages into the cache. Windows are described by encoded keys that sort, byte-wise, in
+ * the same order as the table's keys.
+ */
+class WiredTigerReadAheadManager {
+    WiredTigerReadAheadManager(const WiredTigerReadAheadManager&) = delete;
+    WiredTigerReadAheadManager& operator=(const WiredTigerReadAheadManager&) = delete;
+
+public:
+    enum class KeyFormat {
+        // Tables keyed by a single RecordId. Keys are encoded with encodeRecordId().
+        kRecordId,
+        // Tables keyed by KeyStrings. Keys are the KeyString bytes.
+        kKeyString,
+    };
+
+    /**
+     * A range of entries to read ahead. Shared between the cursor that requested it and the
+     * background thread.
+     */
+    struct Window {
+        Window(std::string uri,
+               KeyFormat format,
+               std::string startKey,
+               std::string endKey,
+               int64_t maxBytes)
+            : uri(std::move(uri)),
+              format(format),
+              startKey(std::move(startKey)),
+              endKey(std::move(endKey)),
+              maxBytes(maxBytes) {}
+
+        const std::string uri;
+        const KeyFormat format;
+        const std::string startKey;
+        // Reading stops at the first key after 'endKey'. Empty means the end of the table.
+        const std::string endKey;
+        const int64_t maxBytes;
+
+        // Set by the requesting cursor once the window is no longer useful to it.
+        AtomicWord<bool> cancelled{false};
+
+        // Set by the background thread once it is finished with the window. The fields below are
+        // written before 'done' is set and must not be read until it has been observed.
+        AtomicWord<bool> done{false};
+        std::string lastKey;
+        bool reachedEnd = false;
+    };
+
+    explicit WiredTigerReadAheadManager(WiredTigerSessionCache* sessionCache);
+    ~WiredTigerReadAheadManager();
+
+    void startThread();
+    void haltThread();
+
+    /**
+     * Stops reading ahead until a matching call to resume(), for operations such as rollback to
+     * stable which fail if any other session is using the tables. Drops the queued windows and
+     * waits for the window being read, if any, to finish. The thread keeps running, but new
+     * windows are dropped while paused. Calls may be nested.
+     */
+    void pause();
+    void resume();
+
+    /**
+     * Queues 'window' for the background thread. Returns false, without queueing it, if the
+     * thread is not running or paused, or is already too far behind.
+     */
+    bool schedule(std::shared_ptr<Window> window);
+
+    /**
+     * Records whether a window had been read by the time its cursor caught up with it.
+     */
+    void noteWindowUsed() {
+        _windowsUsed.fetchAndAdd(1);
+    }
+    void noteWindowOvertaken() {
+        _windowsOvertaken.fetchAndAdd(1);
+    }
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Encodes a RecordId so that encoded ids compare byte-wise in RecordId order.
+     */
+    static std::string encodeRecordId(int64_t repr);
+
+private:
+    void _readAheadLoop();
+
+    void _readAhead(Window* window);
+
+    WiredTigerSessionCache* const _sessionCache;
+
+    stdx::thread _thread;
+
+    AtomicWord<bool> _shuttingDown{false};
+
+    // Set while paused, so that the window being read stops early.
+    AtomicWord<bool> _paused{false};
+
+    // Protects the state below.
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerReadAheadManager::_mutex");
+
+    // Signaled when a window is queued or the thread should stop.
+    stdx::condition_variable _queueCV;
+
+    // Signaled when the thread finishes reading a window.
+    stdx::condition_variable _windowDoneCV;
+
+    std::deque<std::shared_ptr<Window>> _queue;
+    bool _isRunning = false;
+    bool _isReadingWindow = false;
+    int _pauseCount = 0;
+
+    AtomicWord<long long> _windowsScheduled{0};
+    AtomicWord<long long> _windowsDropped{0};
+    AtomicWord<long long> _windowsUsed{0};
+    AtomicWord<long long> _windowsOvertaken{0};
+    AtomicWord<long long> _entriesRead{0};
+    AtomicWord<long long> _bytesRead{0};
+};
+
+/**
+ * Decides when to read ahead of a forward cursor. Read-ahead starts once the cursor has advanced
+ * sequentially over enough entries to look like a long scan. The first window reaches two
+ * window-lengths past the cursor, and each time the cursor has consumed another window-length a
+ * window continuing from where the previous one stopped is requested, so the read-ahead stays
+ * about one window-length in front of the cursor.
+ */
+class WiredTigerReadAheadTracker {
+public:
+    WiredTigerReadAheadTracker(std::string uri, WiredTigerReadAheadManager::KeyFormat format)
+        : _uri(std::move(uri)), _format(format) {}
+
+    ~WiredTigerReadAheadTracker() {
+        reset();
+    }
+
+    /**
+     * Called each time the cursor moves forward over an entry of 'bytes' bytes. Returns true if
+     * the cursor should now call scheduleFrom() with its current key.
+     */
+    bool advanced(size_t bytes);
+
+    /**
+     * Requests read-ahead from 'currentKey', stopping after 'endKey' if it is not empty.
+     */
+    void scheduleFrom(OperationContext* opCtx, std::string currentKey, std::string endKey);
+
+    /**
+     * Called when the cursor is repositioned, to abandon any read-ahead of its old position.
+     */
+    void reset();
+
+private:
+    const std::string _uri;
+    const WiredTigerReadAheadManager::KeyFormat _format;
+
+    std::shared_ptr<WiredTigerReadAheadManager::Window> _window;
+    int64_t _sequentialAdvances = 0;
+    int64_t _bytesSinceScheduled = 0;
+    bool _scheduled = false;
+    bool _reachedEnd = false;
+};
+
+}  // namespace mongo
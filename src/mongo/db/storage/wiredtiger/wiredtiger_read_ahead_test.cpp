@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/system_clock_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const std::string kUri = "table:read_ahead";
+
+// The read-ahead thread is a Client, so these tests need a global ServiceContext.
+class WiredTigerReadAheadTest : public ServiceContextTest {
+public:
+    WiredTigerReadAheadTest() : _dbpath("wt_test") {
+        ASSERT_OK(wtRCToStatus(
+            wiredtiger_open(_dbpath.path().c_str(), nullptr, "create,", &_conn)));
+        _sessionCache = std::make_unique<WiredTigerSessionCache>(_conn, &_clockSource);
+        _manager = std::make_unique<WiredTigerReadAheadManager>(_sessionCache.get());
+    }
+
+    ~WiredTigerReadAheadTest() {
+        _manager.reset();
+        _sessionCache.reset();
+        _conn->close(_conn, nullptr);
+    }
+
+    /**
+     * Creates a table with records 0 through 'numRecords' - 1, each 'valueSize' bytes long.
+     */
+    void createTable(int numRecords, int valueSize) {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        ASSERT_OK(wtRCToStatus(s->create(s, kUri.c_str(), "key_format=q,value_format=u")));
+
+        WT_CURSOR* c;
+        ASSERT_OK(wtRCToStatus(s->open_cursor(s, kUri.c_str(), nullptr, nullptr, &c)));
+        const std::string value(valueSize, 'x');
+        for (int64_t id = 0; id < numRecords; ++id) {
+            WT_ITEM item;
+            item.data = value.data();
+            item.size = value.size();
+            c->set_key(c, id);
+            c->set_value(c, &item);
+            ASSERT_OK(wtRCToStatus(c->insert(c)));
+        }
+        ASSERT_OK(wtRCToStatus(c->close(c)));
+    }
+
+    std::shared_ptr<WiredTigerReadAheadManager::Window> makeWindow(int64_t startId,
+                                                                   int64_t maxBytes) {
+        return std::make_shared<WiredTigerReadAheadManager::Window>(
+            kUri,
+            WiredTigerReadAheadManager::KeyFormat::kRecordId,
+            WiredTigerReadAheadManager::encodeRecordId(startId),
+            std::string(),
+            maxBytes);
+    }
+
+    void waitUntilDone(const WiredTigerReadAheadManager::Window& window) {
+        while (!window.done.load()) {
+            sleepmillis(1);
+        }
+    }
+
+    BSONObj getStats() {
+        BSONObjBuilder builder;
+        _manager->appendStats(&builder);
+        return builder.obj().getObjectField("readAhead").getOwned();
+    }
+
+protected:
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn = nullptr;
+    SystemClockSource _clockSource;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+    std::unique_ptr<WiredTigerReadAheadManager> _manager;
+};
+
+TEST(WiredTigerReadAheadManagerTest, EncodedRecordIdsSortInRecordIdOrder) {
+    const std::vector<int64_t> ids = {
+        std::numeric_limits<int64_t>::min(), -256, -1, 0, 1, 255, 256, 1LL << 40,
+        std::numeric_limits<int64_t>::max()};
+    for (size_t i = 1; i < ids.size(); ++i) {
+        ASSERT_LT(WiredTigerReadAheadManager::encodeRecordId(ids[i - 1]),
+                  WiredTigerReadAheadManager::encodeRecordId(ids[i]));
+    }
+}
+
+TEST_F(WiredTigerReadAheadTest, ReadsWindowAndRecordsWhereItStopped) {
+    createTable(100, 100);
+    _manager->startThread();
+
+    // The window stops on the record that takes it to 1000 bytes.
+    auto window = makeWindow(10, 1000);
+    ASSERT(_manager->schedule(window));
+    waitUntilDone(*window);
+    ASSERT_FALSE(window->reachedEnd);
+    ASSERT_EQ(window->lastKey, WiredTigerReadAheadManager::encodeRecordId(19));
+
+    // A window running off the end of the table records that it did.
+    auto lastWindow = makeWindow(90, 1000 * 1000);
+    ASSERT(_manager->schedule(lastWindow));
+    waitUntilDone(*lastWindow);
+    ASSERT(lastWindow->reachedEnd);
+
+    auto stats = getStats();
+    ASSERT_EQ(stats["windowsScheduled"].numberLong(), 2);
+    ASSERT_EQ(stats["entriesRead"].numberLong(), 20);
+    ASSERT_EQ(stats["bytesRead"].numberLong(), 2000);
+}
+
+TEST_F(WiredTigerReadAheadTest, CancelledWindowIsNotRead) {
+    createTable(100, 100);
+
+    // Cancel the window before the thread can see it.
+    auto window = makeWindow(0, 1000);
+    window->cancelled.store(true);
+    _manager->startThread();
+    ASSERT(_manager->schedule(window));
+    waitUntilDone(*window);
+
+    ASSERT_EQ(getStats()["entriesRead"].numberLong(), 0);
+}
+
+TEST_F(WiredTigerReadAheadTest, WindowsAreDroppedWhenNotRunning) {
+    createTable(10, 100);
+    ASSERT_FALSE(_manager->schedule(makeWindow(0, 1000)));
+
+    _manager->startThread();
+    _manager->haltThread();
+    ASSERT_FALSE(_manager->schedule(makeWindow(0, 1000)));
+
+    ASSERT_EQ(getStats()["windowsDropped"].numberLong(), 2);
+}
+
+TEST_F(WiredTigerReadAheadTest, PauseWaitsForWindowAndDropsNewOnes) {
+    createTable(100 * 1000, 100);
+    _manager->startThread();
+
+    // A window large enough to still be queued or being read when the manager is paused. Once
+    // pause() returns, it has either been dropped from the queue or been cut short.
+    auto window = makeWindow(0, std::numeric_limits<int64_t>::max());
+    ASSERT(_manager->schedule(window));
+    _manager->pause();
+    const auto entriesRead = getStats()["entriesRead"].numberLong();
+    ASSERT_LT(entriesRead, 100 * 1000);
+    sleepmillis(10);
+    ASSERT_EQ(getStats()["entriesRead"].numberLong(), entriesRead);
+    ASSERT_FALSE(_manager->schedule(makeWindow(0, 1000)));
+
+    // Pauses nest.
+    _manager->pause();
+    _manager->resume();
+    ASSERT_FALSE(_manager->schedule(makeWindow(0, 1000)));
+
+    _manager->resume();
+    auto resumedWindow = makeWindow(10, 1000);
+    ASSERT(_manager->schedule(resumedWindow));
+    waitUntilDone(*resumedWindow);
+    ASSERT_EQ(resumedWindow->lastKey, WiredTigerReadAheadManager::encodeRecordId(19));
+
+    ASSERT_EQ(getStats()["windowsDropped"].numberLong(), 2);
+}
+
+}  // namespace
+}  // namespace mongo
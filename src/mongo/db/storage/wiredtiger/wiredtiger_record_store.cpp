@@ -38,7 +38,9 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
@@ -1514,6 +1516,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     Record highestIdRecord;
     invariant(nRecords != 0);
+
+    // Take the RecordIds for the whole batch with a single update of the shared counter. They are
+    // consecutive, so the records below are inserted in key order.
+    const int64_t firstId = _isOplog ? 0 : _reserveIds(opCtx, nRecords).repr();
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         if (_isOplog) {
@@ -1523,12 +1529,15 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 return status.getStatus();
             record.id = status.getValue();
         } else {
-            record.id = _nextId(opCtx);
+            record.id = RecordId(firstId + i);
         }
         dassert(record.id > highestIdRecord.id);
         highestIdRecord = record;
     }
 
+    // Setting the timestamp of the transaction is not free, and batches often use the same
+    // timestamp for every record, so only do it when the timestamp changes.
+    Timestamp lastTimestamp;
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         Timestamp ts;
@@ -1544,9 +1553,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         } else {
             ts = timestamps[i];
         }
-        if (!ts.isNull()) {
+        if (!ts.isNull() && ts != lastTimestamp) {
             LOGV2_DEBUG(22403, 4, "inserting record with timestamp {ts}", "ts"_attr = ts);
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
+            lastTimestamp = ts;
         }
         setKey(c, record.id);
         WiredTigerItem value(record.data.data(), record.data.size());
@@ -1998,11 +2008,13 @@ void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
     _nextIdNum.store(nextId);
 }
 
-RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
+RecordId WiredTigerRecordStore::_reserveIds(OperationContext* opCtx, size_t count) {
     invariant(!_isOplog);
+    invariant(count > 0);
     _initNextIdIfNeeded(opCtx);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(count));
     invariant(out.isNormal());
+    invariant(RecordId(out.repr() + count - 1).isNormal());
     return out;
 }
 
@@ -2212,6 +2224,10 @@ Status WiredTigerRecordStore::oplogDiskLocRegister(OperationContext* opCtx,
 
 // Cursor Base:
 
+// The furthest, in RecordIds, fetchBatch() steps forward from one record to the next instead of
+// searching for it.
+const int64_t kMaxFetchBatchSteps = 8;
+
 WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContext* opCtx,
                                                                  const WiredTigerRecordStore& rs,
                                                                  bool forward)
@@ -2222,6 +2238,13 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
     _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
 }
 
+void WiredTigerRecordStoreCursorBase::enableReadAhead() {
+    // Oplog readers mostly tail the end of the oplog, where there is nothing to read ahead of.
+    if (_forward && !_rs._isOplog) {
+        _readAhead.emplace(_rs.getURI(), WiredTigerReadAheadManager::KeyFormat::kRecordId);
+    }
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     invariant(_hasRestored);
     if (_eof)
@@ -2284,12 +2307,20 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
     metricsCollector.incrementOneDocRead(value.size);
 
+    if (_readAhead && _readAhead->advanced(value.size)) {
+        _readAhead->scheduleFrom(
+            _opCtx, WiredTigerReadAheadManager::encodeRecordId(id.repr()), std::string());
+    }
+
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     invariant(_hasRestored);
+    if (_readAhead) {
+        _readAhead->reset();
+    }
     if (_forward && _oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
         _eof = true;
         return {};
@@ -2325,6 +2356,80 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::fetchBatch(const std::vector<RecordId>& ids,
+                                                 std::vector<boost::optional<Record>>* out) {
+    invariant(_hasRestored);
+    if (_readAhead) {
+        _readAhead->reset();
+    }
+    out->clear();
+    out->resize(ids.size());
+
+    // Ensure an active transaction is open.
+    WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+
+    std::vector<size_t> order(ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(
+        order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return ids[lhs] < ids[rhs]; });
+
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+    _skipNextAdvance = false;
+    WT_CURSOR* c = _cursor->get();
+
+    // The id the WiredTiger cursor is positioned on, or null if it is not positioned.
+    RecordId positionedAt;
+    for (size_t i : order) {
+        const RecordId& id = ids[i];
+        if (_forward && _oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
+            continue;
+        }
+
+        if (!positionedAt.isNull() && id >= positionedAt &&
+            id.repr() - positionedAt.repr() <= kMaxFetchBatchSteps) {
+            // The id is at most a few records past the current position, so stepping to it is
+            // cheaper than searching for it from the root of the tree.
+            while (positionedAt < id) {
+                int advanceRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->next(c); });
+                RecordId key;
+                if (advanceRet == 0 && hasWrongPrefix(c, &key)) {
+                    advanceRet = WT_NOTFOUND;
+                }
+                if (advanceRet == WT_NOTFOUND) {
+                    positionedAt = RecordId();
+                    break;
+                }
+                invariantWTOK(advanceRet);
+                positionedAt = key.isValid() ? key : getKey(c);
+            }
+        } else {
+            setKey(c, id);
+            int seekRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search(c); });
+            metricsCollector.incrementOneCursorSeek();
+            if (seekRet == WT_NOTFOUND) {
+                positionedAt = RecordId();
+                continue;
+            }
+            invariantWTOK(seekRet);
+            positionedAt = id;
+        }
+
+        if (positionedAt != id) {
+            continue;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(c->get_value(c, &value));
+        metricsCollector.incrementOneDocRead(value.size);
+        (*out)[i] = Record{
+            id,
+            RecordData(static_cast<const char*>(value.data), static_cast<int>(value.size))
+                .getOwned()};
+    }
+
+    _lastReturnedId = positionedAt;
+    _eof = positionedAt.isNull();
+}
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
@@ -2340,6 +2445,9 @@ void WiredTigerRecordStoreCursorBase::save() {
 
 void WiredTigerRecordStoreCursorBase::saveUnpositioned() {
     save();
+    if (_readAhead) {
+        _readAhead->reset();
+    }
     _lastReturnedId = RecordId();
 }
 
@@ -2457,7 +2565,9 @@ std::unique_ptr<RecordCursor> StandardWiredTigerRecordStore::getRandomCursorWith
 
 WiredTigerRecordStoreStandardCursor::WiredTigerRecordStoreStandardCursor(
     OperationContext* opCtx, const WiredTigerRecordStore& rs, bool forward)
-    : WiredTigerRecordStoreCursorBase(opCtx, rs, forward) {}
+    : WiredTigerRecordStoreCursorBase(opCtx, rs, forward) {
+    enableReadAhead();
+}
 
 void WiredTigerRecordStoreStandardCursor::setKey(WT_CURSOR* cursor, RecordId id) const {
     cursor->set_key(cursor, id.repr());
@@ -40,6 +40,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/platform/atomic_word.h"
@@ -297,7 +298,10 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId(OperationContext* opCtx);
+    /**
+     * Reserves 'count' consecutive RecordIds at once and returns the first of them.
+     */
+    RecordId _reserveIds(OperationContext* opCtx, size_t count);
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
@@ -450,6 +454,8 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    void fetchBatch(const std::vector<RecordId>& ids, std::vector<boost::optional<Record>>* out);
+
     void save();
 
     void saveUnpositioned();
@@ -479,6 +485,12 @@ protected:
      */
     virtual void initCursorToBeginning() = 0;
 
+    /**
+     * Reads ahead of this cursor once it looks like a long scan. Only valid for forward cursors
+     * over tables keyed by a single RecordId.
+     */
+    void enableReadAhead();
+
     const WiredTigerRecordStore& _rs;
     OperationContext* _opCtx;
     const bool _forward;
@@ -487,6 +499,7 @@ protected:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     bool _hasRestored = true;
+    boost::optional<WiredTigerReadAheadTracker> _readAhead;
 
 private:
     bool isVisible(const RecordId& id);
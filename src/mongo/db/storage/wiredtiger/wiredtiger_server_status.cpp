@@ -96,6 +96,14 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
                           Timestamp(_engine->getOplogManager()->getOplogReadTimestamp()));
     }
 
+    WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendStats(&bob);
+    if (auto readAheadManager = _engine->getReadAheadManager()) {
+        readAheadManager->appendStats(&bob);
+    }
+    if (auto concurrencyAdjuster = _engine->getConcurrencyAdjuster()) {
+        concurrencyAdjuster->appendStats(&bob);
+    }
+
     return bob.obj();
 }
 
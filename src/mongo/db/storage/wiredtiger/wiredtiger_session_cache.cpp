@@ -33,7 +33,9 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -45,6 +47,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -109,6 +112,18 @@ void _openCursor(WT_SESSION* session,
                             "message"_attr = kWTRepairMsg);
     }
 }
+
+size_t numSessionPools() {
+    if (gWiredTigerSessionCachePools > 0) {
+        return gWiredTigerSessionCachePools;
+    }
+    const auto cores = ProcessInfo::getNumAvailableCores();
+    return std::clamp<size_t>(cores, 1, 64);
+}
+
+// Threads are assigned to session pools round-robin, in the order they first ask for a session.
+AtomicWord<unsigned> nextPoolAssignment{0};
+thread_local unsigned threadPoolAssignment = nextPoolAssignment.fetchAndAdd(1);
 }  // namespace
 
 WT_CURSOR* WiredTigerSession::getCachedCursor(const std::string& uri, uint64_t id) {
@@ -118,9 +133,11 @@ WT_CURSOR* WiredTigerSession::getCachedCursor(const std::string& uri, uint64_t i
             WT_CURSOR* c = i->_cursor;
             _cursors.erase(i);
             _cursorsOut++;
+            _cursorCacheHits++;
             return c;
         }
     }
+    _cursorCacheMisses++;
     return nullptr;
 }
 
@@ -202,14 +219,16 @@ WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
-      _prepareCommitOrAbortCounter(0) {}
+      _prepareCommitOrAbortCounter(0),
+      _pools(numSessionPools()) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
     : _engine(nullptr),
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
-      _prepareCommitOrAbortCounter(0) {}
+      _prepareCommitOrAbortCounter(0),
+      _pools(numSessionPools()) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -373,10 +392,26 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 }
 
 
+size_t WiredTigerSessionCache::_homePoolIndex() const {
+    return threadPoolAssignment % _pools.size();
+}
+
+WiredTigerSession* WiredTigerSessionCache::_takeSession(SessionPool& pool) {
+    invariant(!pool.sessions.empty());
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones.
+    WiredTigerSession* session = pool.sessions.back();
+    pool.sessions.pop_back();
+    pool.numIdle.store(pool.sessions.size());
+    return session;
+}
+
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto& pool : _pools) {
+        stdx::lock_guard<Latch> lock(pool.mutex);
+        for (auto session : pool.sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
@@ -384,15 +419,47 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto& pool : _pools) {
+        stdx::lock_guard<Latch> lock(pool.mutex);
+        for (auto session : pool.sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto& pool : _pools) {
+        stdx::lock_guard<Latch> lock(pool.mutex);
+        count += pool.sessions.size();
+    }
+    return count;
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) {
+    long long idleSessions = 0;
+    long long hits = 0;
+    long long steals = 0;
+    long long cursorCacheHits = 0;
+    long long cursorCacheMisses = 0;
+    for (auto& pool : _pools) {
+        stdx::lock_guard<Latch> lock(pool.mutex);
+        idleSessions += pool.sessions.size();
+        hits += pool.hits;
+        steals += pool.steals;
+        cursorCacheHits += pool.cursorCacheHits;
+        cursorCacheMisses += pool.cursorCacheMisses;
+    }
+
+    BSONObjBuilder bob(builder->subobjStart("sessionCache"));
+    bob.append("pools", static_cast<long long>(_pools.size()));
+    bob.append("idleSessions", idleSessions);
+    bob.append("sessionsOpened", _sessionsOpened.load());
+    bob.append("poolHits", hits);
+    bob.append("poolSteals", steals);
+    bob.append("cursorCacheHits", cursorCacheHits);
+    bob.append("cursorCacheMisses", cursorCacheMisses);
+    bob.done();
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -402,30 +469,43 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
+    for (auto& pool : _pools) {
+        stdx::lock_guard<Latch> lock(pool.mutex);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = pool.sessions.begin(); it != pool.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = pool.sessions.erase(it);
                 delete (session);
             } else {
                 ++it;
             }
         }
+        pool.numIdle.store(pool.sessions.size());
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
     SessionCache swap;
 
     {
-        stdx::lock_guard<Latch> lock(_cacheLock);
+        // Hold every pool lock while the epoch moves on, so that no session from the old epoch
+        // can be handed out or returned to a pool once the epoch has been incremented. The pools
+        // are always locked in index order.
+        std::vector<stdx::unique_lock<Latch>> locks;
+        locks.reserve(_pools.size());
+        for (auto& pool : _pools) {
+            locks.emplace_back(pool.mutex);
+        }
+
+        // Increment the epoch as we are now closing all sessions with this epoch.
         _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+        for (auto& pool : _pools) {
+            swap.insert(swap.end(), pool.sessions.begin(), pool.sessions.end());
+            pool.sessions.clear();
+            pool.numIdle.store(0);
+        }
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -442,20 +522,32 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            // Reset the idle time
-            cachedSession->setIdleExpireTime(Date_t::min());
-            return UniqueWiredTigerSession(cachedSession);
+    // Prefer this thread's own pool, whose sessions are most likely to have cursors open on the
+    // tables this thread uses. Otherwise steal an idle session from one of the other pools.
+    const size_t home = _homePoolIndex();
+    for (size_t n = 0; n < _pools.size(); ++n) {
+        auto& pool = _pools[(home + n) % _pools.size()];
+        if (pool.numIdle.loadRelaxed() == 0) {
+            continue;
+        }
+
+        stdx::lock_guard<Latch> lock(pool.mutex);
+        if (pool.sessions.empty()) {
+            continue;
+        }
+        WiredTigerSession* cachedSession = _takeSession(pool);
+        if (n == 0) {
+            pool.hits++;
+        } else {
+            pool.steals++;
         }
+        // Reset the idle time
+        cachedSession->setIdleExpireTime(Date_t::min());
+        return UniqueWiredTigerSession(cachedSession);
     }
 
-    // Outside of the cache partition lock, but on release will be put back on the cache
+    // Outside of the pool locks, but on release will be put back on the cache
+    _sessionsOpened.fetchAndAdd(1);
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -510,10 +602,14 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<Latch> lock(_cacheLock);
+        auto& pool = _pools[_homePoolIndex()];
+        stdx::lock_guard<Latch> lock(pool.mutex);
+        pool.cursorCacheHits += std::exchange(session->_cursorCacheHits, 0);
+        pool.cursorCacheMisses += std::exchange(session->_cursorCacheMisses, 0);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            pool.sessions.push_back(session);
+            pool.numIdle.store(pool.sessions.size());
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -39,6 +39,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -199,6 +200,11 @@ private:
     CursorCache _cursors;            // owned
     uint64_t _cursorGen;
     int _cursorsOut;
+
+    // Lookups in the cursor cache since this session was last returned to the session cache.
+    uint64_t _cursorCacheHits = 0;
+    uint64_t _cursorCacheMisses = 0;
+
     bool _dropQueuedIdentsAtSessionEnd = true;
     Date_t _idleExpireTime;
 };
@@ -206,6 +212,12 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  Idle sessions are spread over several pools, each with its own lock, so that threads taking
+ *  and returning sessions at the same time rarely contend. Each thread prefers the pool it is
+ *  assigned to, which also tends to hand it back a session whose cached cursors are open on the
+ *  tables it uses. When that pool is empty, the thread steals an idle session from another pool
+ *  before opening a new one.
  */
 class WiredTigerSessionCache {
 public:
@@ -259,6 +271,11 @@ public:
      */
     size_t getIdleSessionsCount();
 
+    /**
+     * Appends counters describing how often sessions and their cached cursors are reused.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
     /**
      * Closes all cached sessions whose idle expiration time has been reached.
      */
@@ -376,9 +393,36 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    Mutex _cacheLock = MONGO_MAKE_LATCH("WiredTigerSessionCache::_cacheLock");
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    struct SessionPool {
+        Mutex mutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::SessionPool::mutex");
+        SessionCache sessions;
+
+        // Mirrors sessions.size(), so that empty pools can be skipped without taking their lock.
+        AtomicWord<size_t> numIdle{0};
+
+        // The following counters are protected by 'mutex'.
+        uint64_t hits = 0;
+        uint64_t steals = 0;
+        uint64_t cursorCacheHits = 0;
+        uint64_t cursorCacheMisses = 0;
+    };
+
+    /**
+     * Returns the pool preferred by the calling thread.
+     */
+    size_t _homePoolIndex() const;
+
+    /**
+     * Removes the most recently used session from 'pool', which must be locked and not empty.
+     */
+    static WiredTigerSession* _takeSession(SessionPool& pool);
+
+    std::vector<CacheAligned<SessionPool>> _pools;
+
+    // The number of sessions opened because no pool had an idle one.
+    AtomicWord<long long> _sessionsOpened{0};
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -33,8 +33,10 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/system_clock_source.h"
@@ -113,4 +115,41 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, IdleSessionsAreReusedAcrossPools) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    auto getStats = [&] {
+        BSONObjBuilder builder;
+        sessionCache->appendStats(&builder);
+        return builder.obj().getObjectField("sessionCache").getOwned();
+    };
+
+    // Release a session on another thread, which puts it in that thread's pool.
+    stdx::thread([&] { sessionCache->getSession(); }).join();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // This thread finds it, either in its own pool or by stealing it from the other thread's.
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    }
+    auto stats = getStats();
+    ASSERT_EQUALS(stats["sessionsOpened"].numberLong(), 1);
+    ASSERT_EQUALS(stats["poolHits"].numberLong() + stats["poolSteals"].numberLong(), 1);
+    if (stats["pools"].numberLong() > 1) {
+        ASSERT_EQUALS(stats["poolSteals"].numberLong(), 1);
+    }
+
+    // The session is now in this thread's pool, so taking it again is a hit.
+    { UniqueWiredTigerSession session = sessionCache->getSession(); }
+    auto newStats = getStats();
+    ASSERT_EQUALS(newStats["sessionsOpened"].numberLong(), 1);
+    ASSERT_EQUALS(newStats["poolHits"].numberLong(), stats["poolHits"].numberLong() + 1);
+    ASSERT_EQUALS(newStats["idleSessions"].numberLong(), 1);
+
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
 }  // namespace mongo
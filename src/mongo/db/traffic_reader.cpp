@@ -51,6 +51,7 @@
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
+#include "mongo/transport/message_compressor_zstd.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/errno_util.h"
 #include "mongo/util/scopeguard.h"
@@ -250,4 +251,31 @@ void trafficRecordingFileToMongoReplayFile(int inputFd, std::ostream& outputStre
     }
 }
 
+std::string trafficRecordingFileToZstdDictionary(int inputFd, size_t dictionarySize) {
+    // Network compressors compress the body of each message separately, so that is what the
+    // dictionary is trained on. Training on about a hundred times the dictionary size is
+    // recommended; more only slows training down. Messages which don't fit in what is left of
+    // that budget are skipped rather than ending the sampling, so that one large message (e.g. a
+    // bulk insert early in the recording) can't leave too few samples to train on.
+    const size_t maxSampleBytes = 100 * dictionarySize;
+    size_t sampleBytes = 0;
+    std::vector<std::string> samples;
+
+    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
+    while (auto packet = readPacket(buf.get(), inputFd)) {
+        if (packet->message.getNetworkOp() == dbCompressed) {
+            continue;
+        }
+
+        const size_t sampleSize = packet->message.dataLen();
+        if (sampleBytes + sampleSize > maxSampleBytes) {
+            continue;
+        }
+        samples.emplace_back(packet->message.data(), sampleSize);
+        sampleBytes += sampleSize;
+    }
+
+    return ZstdDictionaryMessageCompressor::trainDictionary(samples, dictionarySize);
+}
+
 }  // namespace mongo
@@ -38,4 +38,8 @@ BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile);
 
 // This is the function that traffic_reader_main.cpp calls
 void trafficRecordingFileToMongoReplayFile(int inFile, std::ostream& outFile);
+
+// Trains a zstd dictionary of at most dictionarySize bytes on the messages in the recorded
+// traffic, for use as the zstdCompressionDictionaryFile of the "zstd-dict" network compressor.
+std::string trafficRecordingFileToZstdDictionary(int inFile, size_t dictionarySize);
 }  // namespace mongo
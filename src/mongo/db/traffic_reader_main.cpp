@@ -40,6 +40,7 @@
 
 #include "mongo/base/initializer.h"
 #include "mongo/db/traffic_reader.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/signal_handlers.h"
 #include "mongo/util/text.h"
 
@@ -66,16 +67,21 @@ int main(int argc, char* argv[]) {
     // input / output files for the reader (input defaults to stdin)
     int inputFd = 0;
     std::ofstream outputStream;
+    size_t dictionarySize = 0;
 
     try {
         // Define the program options
         auto inputStr = "Path to file input file (defaults to stdin)";
         auto outputStr =
             "Path to file that mongotrafficreader will place its output (defaults to stdout)";
+        auto dictionaryStr =
+            "Instead of converting the recording, output a zstd network compression dictionary of "
+            "at most this many bytes, trained on the uncompressed messages in the recording";
         boost::program_options::options_description desc{"Options"};
         desc.add_options()("help,h", "help")(
             "input,i", boost::program_options::value<std::string>(), inputStr)(
-            "output,o", boost::program_options::value<std::string>(), outputStr);
+            "output,o", boost::program_options::value<std::string>(), outputStr)(
+            "trainZstdDictionary", boost::program_options::value<size_t>(), dictionaryStr);
 
         // Parse the program options
         store(parse_command_line(argc, argv, desc), vm);
@@ -122,11 +128,27 @@ int main(int argc, char* argv[]) {
             outputStream.clear(std::cout.rdstate());
             outputStream.basic_ios<char>::rdbuf(std::cout.rdbuf());
         }
+
+        if (vm.count("trainZstdDictionary")) {
+            dictionarySize = vm["trainZstdDictionary"].as<size_t>();
+        }
     } catch (const boost::program_options::error& ex) {
         std::cerr << ex.what() << '\n';
         return EXIT_FAILURE;
     }
 
+    if (dictionarySize) {
+        try {
+            auto dictionary =
+                mongo::trafficRecordingFileToZstdDictionary(inputFd, dictionarySize);
+            outputStream.write(dictionary.data(), dictionary.size());
+        } catch (const DBException& ex) {
+            std::cerr << ex.toString() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return 0;
+    }
+
     mongo::trafficRecordingFileToMongoReplayFile(inputFd, outputStream);
 
     return 0;
@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fcntl.h>
+#include <fstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "mongo/base/data_builder.h"
+#include "mongo/base/data_type_terminated.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/traffic_reader.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Writes 'messages' to 'path' in the format TrafficRecorder records them in.
+ */
+void writeRecording(const std::string& path, const std::vector<Message>& messages) {
+    std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc | std::ios_base::out);
+    DataBuilder db;
+    uint64_t order = 0;
+    for (const auto& message : messages) {
+        db.clear();
+        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint32_t>>(0));
+        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(1));
+        uassertStatusOK(db.writeAndAdvance<Terminated<'\0', StringData>>("127.0.0.1:27017"_sd));
+        uassertStatusOK(db.writeAndAdvance<Terminated<'\0', StringData>>("127.0.0.1:50000"_sd));
+        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(0));
+        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(++order));
+
+        auto size = db.size() + message.size();
+        db.getCursor().write<LittleEndian<uint32_t>>(size);
+
+        out.write(db.getCursor().data(), db.size());
+        out.write(message.buf(), message.size());
+    }
+    ASSERT(out.good());
+}
+
+std::string trainOnRecording(const std::string& path, size_t dictionarySize) {
+#ifdef _WIN32
+    int inputFd = open(path.c_str(), O_RDONLY | O_BINARY);
+#else
+    int inputFd = open(path.c_str(), O_RDONLY);
+#endif
+    ASSERT_NE(inputFd, -1);
+    ON_BLOCK_EXIT([&] { close(inputFd); });
+    return trafficRecordingFileToZstdDictionary(inputFd, dictionarySize);
+}
+
+BSONObj makeInsert(int i) {
+    return BSON("insert"
+                << "coll"
+                << "ordered" << true << "documents"
+                << BSON_ARRAY(BSON("_id" << i << "name"
+                                         << "user" + std::to_string(i) << "score"
+                                         << i * 7 % 100)));
+}
+
+TEST(TrafficReaderTest, ZstdDictionaryIsTrainedPastMessagesLargerThanTheSampleBudget) {
+    const size_t dictionarySize = 1024;
+
+    std::vector<Message> messages;
+    // The first message alone is larger than the 100 * dictionarySize bytes sampled, so it must
+    // be skipped rather than ending the sampling before any message is taken.
+    messages.push_back(OpMsgRequest::fromDBAndBody(
+                           "test", BSON("padding" << std::string(200 * dictionarySize, 'x')))
+                           .serialize());
+    for (int i = 0; i < 1000; i++) {
+        messages.push_back(OpMsgRequest::fromDBAndBody("test", makeInsert(i)).serialize());
+    }
+
+    unittest::TempDir tempDir("TrafficReaderTest");
+    const auto path = tempDir.path() + "/recording";
+    writeRecording(path, messages);
+
+    auto dictionary = trainOnRecording(path, dictionarySize);
+    ASSERT_GT(dictionary.size(), 0U);
+    ASSERT_LTE(dictionary.size(), dictionarySize);
+
+    // The dictionary must be usable by the compressor it was trained for.
+    ZstdDictionaryMessageCompressor compressor(dictionary);
+    auto body = OpMsgRequest::fromDBAndBody("test", makeInsert(1000)).serialize();
+    ConstDataRange input(body.singleData().data(), body.singleData().dataLen());
+    std::vector<char> compressed(compressor.getMaxCompressedSize(input.length()));
+    auto compressedSize = uassertStatusOK(
+        compressor.compressData(input, DataRange(compressed.data(), compressed.size())));
+    ASSERT_LT(compressedSize, input.length());
+
+    std::vector<char> decompressed(input.length());
+    auto decompressedSize = uassertStatusOK(
+        compressor.decompressData(ConstDataRange(compressed.data(), compressedSize),
+                                  DataRange(decompressed.data(), decompressed.size())));
+    ASSERT_EQ(decompressedSize, input.length());
+    ASSERT_EQ(memcmp(decompressed.data(), input.data(), input.length()), 0);
+}
+
+}  // namespace
+}  // namespace mongo
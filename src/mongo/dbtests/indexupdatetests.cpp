@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/multi_index_block.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/catalog/uncommitted_collections.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
@@ -231,6 +232,143 @@ public:
     }
 };
 
+/** Generating keys on several threads builds the same indexes as the serial collection scan. */
+class InsertBuildParallelKeyGeneration : public IndexBuildBase {
+public:
+    void run() {
+        auto defaultNumThreads = indexBuildKeyGenerationThreads.load();
+        ON_BLOCK_EXIT([&] { indexBuildKeyGenerationThreads.store(defaultNumThreads); });
+        indexBuildKeyGenerationThreads.store(4);
+
+        AutoGetOrCreateDb dbRaii(_opCtx, _nss.db(), LockMode::MODE_IX);
+        boost::optional<Lock::CollectionLock> collLk;
+        collLk.emplace(_opCtx, _nss, LockMode::MODE_IX);
+        auto& coll = collection();
+
+        // Enough documents to fill several batches for each thread.
+        const int32_t nDocs = 10000;
+        long long nPartialIndexKeys = 0;
+        {
+            WriteUnitOfWork wunit(_opCtx);
+            OpDebug* const nullOpDebug = nullptr;
+            for (int32_t i = 0; i < nDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    _opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << BSON_ARRAY(i << -i) << "b" << i % 7)),
+                    nullOpDebug,
+                    true));
+                nPartialIndexKeys += (i % 7 >= 4) ? 1 : 0;
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer;
+
+        const std::vector<BSONObj> specs = {
+            BSON("name"
+                 << "a_1_b_1"
+                 << "key" << BSON("a" << 1 << "b" << 1) << "v" << static_cast<int>(kIndexVersion)),
+            BSON("name"
+                 << "b_1"
+                 << "key" << BSON("b" << 1) << "v" << static_cast<int>(kIndexVersion)
+                 << "partialFilterExpression" << BSON("b" << BSON("$gte" << 4)))};
+
+        collLk.emplace(_opCtx, _nss, LockMode::MODE_X);
+        auto abortOnExit = makeGuard([&] {
+            indexer.abortIndexBuild(_opCtx, collection(), MultiIndexBlock::kNoopOnCleanUpFn);
+        });
+
+        ASSERT_OK(indexer.init(_opCtx, coll, specs, MultiIndexBlock::kNoopOnInitFn).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(_opCtx, coll.get()));
+        ASSERT_OK(indexer.dumpInsertsFromBulk(_opCtx, coll.get()));
+        ASSERT_OK(indexer.checkConstraints(_opCtx, coll.get()));
+
+        {
+            WriteUnitOfWork wunit(_opCtx);
+            ASSERT_OK(indexer.commit(_opCtx,
+                                     coll.getWritableCollection(),
+                                     MultiIndexBlock::kNoopOnCreateEachFn,
+                                     MultiIndexBlock::kNoopOnCommitFn));
+            wunit.commit();
+        }
+        abortOnExit.dismiss();
+
+        // Every document has two keys in the compound index, except for the first one since 0 and
+        // -0 are equal.
+        auto compoundIndex = coll->getIndexCatalog()->findIndexByName(_opCtx, "a_1_b_1");
+        ASSERT(compoundIndex);
+        ASSERT(compoundIndex->getEntry()->isMultikey());
+        ASSERT_EQUALS(
+            2LL * nDocs - 1,
+            compoundIndex->getEntry()->accessMethod()->getSortedDataInterface()->numEntries(
+                _opCtx));
+
+        auto partialIndex = coll->getIndexCatalog()->findIndexByName(_opCtx, "b_1");
+        ASSERT(partialIndex);
+        ASSERT_FALSE(partialIndex->getEntry()->isMultikey());
+        ASSERT_EQUALS(
+            nPartialIndexKeys,
+            partialIndex->getEntry()->accessMethod()->getSortedDataInterface()->numEntries(_opCtx));
+    }
+};
+
+/**
+ * Documents whose key generation errors are suppressed by several key generation threads are all
+ * recorded as skipped, from the thread scanning the collection.
+ */
+class InsertBuildParallelKeyGenerationSkippedRecords : public IndexBuildBase {
+public:
+    void run() {
+        auto defaultNumThreads = indexBuildKeyGenerationThreads.load();
+        ON_BLOCK_EXIT([&] { indexBuildKeyGenerationThreads.store(defaultNumThreads); });
+        indexBuildKeyGenerationThreads.store(4);
+
+        AutoGetOrCreateDb dbRaii(_opCtx, _nss.db(), LockMode::MODE_IX);
+        boost::optional<Lock::CollectionLock> collLk;
+        collLk.emplace(_opCtx, _nss, LockMode::MODE_IX);
+        auto& coll = collection();
+
+        // Spread documents with parallel arrays, which cannot be indexed, over the batches handed
+        // to every thread.
+        const int32_t nDocs = 10000;
+        {
+            WriteUnitOfWork wunit(_opCtx);
+            OpDebug* const nullOpDebug = nullptr;
+            for (int32_t i = 0; i < nDocs; ++i) {
+                auto doc = i % 100 == 0
+                    ? BSON("_id" << i << "a" << BSON_ARRAY(i << -i) << "b" << BSON_ARRAY(1 << 2))
+                    : BSON("_id" << i << "a" << i << "b" << i);
+                ASSERT_OK(coll->insertDocument(_opCtx, InsertStatement(doc), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer;
+
+        const BSONObj spec = BSON("name"
+                                  << "a_1_b_1"
+                                  << "key" << BSON("a" << 1 << "b" << 1) << "v"
+                                  << static_cast<int>(kIndexVersion));
+
+        collLk.emplace(_opCtx, _nss, LockMode::MODE_X);
+        ON_BLOCK_EXIT([&] {
+            indexer.abortIndexBuild(_opCtx, collection(), MultiIndexBlock::kNoopOnCleanUpFn);
+        });
+
+        ASSERT_OK(indexer.init(_opCtx, coll, spec, MultiIndexBlock::kNoopOnInitFn).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(_opCtx, coll.get()));
+
+        auto buildingIndex = coll->getIndexCatalog()->getEntry(
+            coll->getIndexCatalog()->findIndexByName(_opCtx, "a_1_b_1", true));
+        ASSERT(buildingIndex);
+        ASSERT_FALSE(
+            buildingIndex->indexBuildInterceptor()->getSkippedRecordTracker()->areAllRecordsApplied(
+                _opCtx));
+        ASSERT_EQ(ErrorCodes::CannotIndexParallelArrays,
+                  indexer.retrySkippedRecords(_opCtx, coll.get()).code());
+    }
+};
+
 /** Index creation is killed if mayInterrupt is true. */
 class InsertBuildIndexInterrupt : public IndexBuildBase {
 public:
@@ -681,6 +819,8 @@ public:
         addIf<InsertBuildEnforceUnique<true>>();
         addIf<InsertBuildEnforceUnique<false>>();
 
+        add<InsertBuildParallelKeyGeneration>();
+        add<InsertBuildParallelKeyGenerationSkippedRecords>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIdIndexInterrupt>();
         add<SameSpecDifferentOption>();
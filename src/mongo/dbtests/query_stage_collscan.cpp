@@ -437,4 +437,35 @@ TEST_F(QueryStageCollectionScanTest, QueryTestCollscanResumeAfterRecordIdSeekFai
     ASSERT_THROWS_CODE(ps->work(&id), DBException, ErrorCodes::KeyNotFound);
 }
 
+// Tests that a collection scan whose consumer frees each working set member as soon as it is
+// returned keeps reusing the same member rather than growing the working set.
+TEST_F(QueryStageCollectionScanTest, QueryStageCollscanRecyclesWorkingSetMembers) {
+    AutoGetCollectionForReadCommand collection(&_opCtx, nss);
+
+    CollectionScanParams params;
+    params.direction = CollectionScanParams::FORWARD;
+    params.tailable = false;
+
+    WorkingSet ws;
+    auto scan = std::make_unique<CollectionScan>(
+        _expCtx.get(), collection.getCollection(), params, &ws, nullptr);
+
+    int count = 0;
+    WorkingSetID firstId = WorkingSet::INVALID_ID;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state;
+    while (PlanStage::IS_EOF != (state = scan->work(&id))) {
+        if (PlanStage::ADVANCED == state) {
+            if (firstId == WorkingSet::INVALID_ID) {
+                firstId = id;
+            }
+            ASSERT_EQUALS(firstId, id);
+            ASSERT(ws.get(id)->hasObj());
+            ws.free(id);
+            ++count;
+        }
+    }
+    ASSERT_EQUALS(numObj(), count);
+}
+
 }  // namespace query_stage_collection_scan
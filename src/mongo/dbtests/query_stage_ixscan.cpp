@@ -37,7 +37,12 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageIxscan {
 namespace {
@@ -136,6 +141,25 @@ public:
         return new IndexScan(_expCtx.get(), _coll, params, &_ws, filter);
     }
 
+    IndexScan* createIndexScanOverPoints(const std::vector<int>& points) {
+        IndexCatalog* catalog = _coll->getIndexCatalog();
+        std::vector<const IndexDescriptor*> indexes;
+        catalog->findIndexesByKeyPattern(&_opCtx, BSON("x" << 1), false, &indexes);
+        ASSERT_EQ(indexes.size(), 1U);
+
+        IndexScanParams params(&_opCtx, indexes[0]);
+        params.direction = 1;
+
+        OrderedIntervalList oil("x");
+        for (int point : points) {
+            oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(BSON("" << point)));
+        }
+        params.bounds.fields.push_back(oil);
+
+        MatchExpression* filter = nullptr;
+        return new IndexScan(_expCtx.get(), _collPtr, params, &_ws, filter);
+    }
+
     static const char* ns() {
         return "unittest.QueryStageIxscan";
     }
@@ -316,6 +340,92 @@ public:
     }
 };
 
+// Tests that an index scan whose consumer frees each working set member as soon as it is returned
+// keeps reusing the same member rather than growing the working set.
+class QueryStageIxscanRecyclesWorkingSetMembers : public IndexScanTest {
+public:
+    void run() {
+        setup();
+
+        const int numDocs = 100;
+        for (int i = 0; i < numDocs; ++i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        std::unique_ptr<IndexScan> ixscan(
+            createIndexScanSimpleRange(BSON("x" << MINKEY), BSON("x" << MAXKEY)));
+
+        int count = 0;
+        WorkingSetID firstId = WorkingSet::INVALID_ID;
+        WorkingSetID id;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = ixscan->work(&id))) {
+            if (PlanStage::ADVANCED == state) {
+                if (firstId == WorkingSet::INVALID_ID) {
+                    firstId = id;
+                }
+                ASSERT_EQ(firstId, id);
+                ASSERT_EQ(WorkingSetMember::RID_AND_IDX, _ws.get(id)->getState());
+                _ws.free(id);
+                ++count;
+            }
+        }
+        ASSERT_EQ(numDocs, count);
+    }
+};
+
+// A write conflict while seeking to one range of a batched index scan must not cause that range to
+// be skipped when the scan is retried.
+class QueryStageIxscanWriteConflictDuringBatchedSeek : public IndexScanTest {
+public:
+    void run() {
+        // The fail point that simulates the write conflict is specific to WiredTiger.
+        if (storageGlobalParams.engine != "wiredTiger") {
+            return;
+        }
+
+        const bool batchedSeeksWereEnabled = internalQueryEnableBatchedIndexSeeks.load();
+        internalQueryEnableBatchedIndexSeeks.store(true);
+        ON_BLOCK_EXIT([&] { internalQueryEnableBatchedIndexSeeks.store(batchedSeeksWereEnabled); });
+
+        setup();
+
+        for (int i = 1; i <= 5; ++i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        std::unique_ptr<IndexScan> ixscan(createIndexScanOverPoints({1, 3, 5}));
+
+        WorkingSetMember* member = getNext(ixscan.get());
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 1));
+
+        // Stop on {'': 2}, past the end of the first range.
+        WorkingSetID id;
+        ASSERT_EQ(PlanStage::NEED_TIME, ixscan->work(&id));
+
+        {
+            // Fail the search for the start of the second range.
+            FailPointEnableBlock failPoint("WTWriteConflictExceptionForReads");
+            ASSERT_EQ(PlanStage::NEED_YIELD, ixscan->work(&id));
+        }
+
+        static_cast<PlanStage*>(ixscan.get())->saveState();
+        _opCtx.recoveryUnit()->abandonSnapshot();
+        static_cast<PlanStage*>(ixscan.get())->restoreState(&_collPtr);
+
+        // The retry seeks to the second range again rather than moving on to the third.
+        member = getNext(ixscan.get());
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 3));
+        member = getNext(ixscan.get());
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 5));
+
+        PlanStage::StageState state;
+        while (PlanStage::NEED_TIME == (state = ixscan->work(&id))) {
+        }
+        ASSERT_EQ(PlanStage::IS_EOF, state);
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_ixscan") {}
@@ -326,6 +436,8 @@ public:
         add<QueryStageIxscanInsertDuringSaveExclusive>();
         add<QueryStageIxscanInsertDuringSaveExclusive2>();
         add<QueryStageIxscanInsertDuringSaveReverse>();
+        add<QueryStageIxscanRecyclesWorkingSetMembers>();
+        add<QueryStageIxscanWriteConflictDuringBatchedSeek>();
     }
 };
 
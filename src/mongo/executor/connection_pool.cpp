@@ -33,6 +33,7 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <cmath>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
@@ -61,6 +62,13 @@ namespace mongo {
 
 namespace {
 
+// The weight of each request in the moving average of how long requests wait for a connection
+constexpr double kQueueDelayAlpha = 0.2;
+
+// While no requests are waiting, that average decays as though a request which did not wait
+// arrived this often, so that a pool which has gone idle does not keep reporting an old delay
+constexpr Milliseconds kQueueDelayIdleDecayPeriod = Seconds{1};
+
 auto makeSeveritySuppressor() {
     return std::make_unique<logv2::KeyedSeveritySuppressor<HostAndPort>>(
         Seconds{1}, logv2::LogSeverity::Log(), logv2::LogSeverity::Debug(2));
@@ -135,8 +143,9 @@ std::string ConnectionPool::ConnectionControls::toString() const {
 }
 
 std::string ConnectionPool::HostState::toString() const {
-    return "{{ requests: {}, ready: {}, pending: {}, active: {}, isExpired: {} }}"_format(
-        requests, ready, pending, active, health.isExpired);
+    return "{{ requests: {}, ready: {}, pending: {}, active: {}, queueDelay: {}, "
+           "isExpired: {} }}"_format(
+               requests, ready, pending, active, queueDelay.toString(), health.isExpired);
 }
 
 /**
@@ -320,6 +329,22 @@ public:
      */
     size_t requestsPending() const;
 
+    /**
+     * Returns the number of connections the controller currently wants open for this pool.
+     */
+    size_t targetConnections() const;
+
+    /**
+     * Returns a moving average of how long requests have waited for a connection, decayed for the
+     * time since the last request if none are waiting.
+     */
+    Microseconds queueDelay() {
+        if (_requests.empty()) {
+            decayIdleQueueDelay(_parent->_factory->now());
+        }
+        return _queueDelay;
+    }
+
     /**
      * Returns the HostAndPort for this pool.
      */
@@ -352,10 +377,14 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, Promise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t requestedAt;
+        Promise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -374,6 +403,12 @@ private:
 
     void returnConnection(ConnectionInterface* connPtr);
 
+    // Folds the time a request waited for a connection into _queueDelay
+    void recordQueueDelay(Milliseconds delay, Date_t now);
+
+    // Decays _queueDelay for the time since it was last updated, while no requests are waiting
+    void decayIdleQueueDelay(Date_t now);
+
     // This internal helper is used both by get and by _fulfillRequests and differs in that it
     // skips some bookkeeping that the other callers do on their own
     ConnectionHandle tryGetConnection();
@@ -426,6 +461,10 @@ private:
 
     size_t _created = 0;
 
+    // A moving average of how long requests waited for a connection, reported to the controller
+    Microseconds _queueDelay{0};
+    Date_t _queueDelayUpdatedAt;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     HostHealth _health;
@@ -576,6 +615,8 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
                                      pool->availableConnections(),
                                      pool->createdConnections(),
                                      pool->refreshingConnections()};
+        hostStats.target = pool->targetConnections();
+        hostStats.queueDelay = pool->queueDelay();
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -635,6 +676,10 @@ size_t ConnectionPool::SpecificPool::requestsPending() const {
     return _requests.size();
 }
 
+size_t ConnectionPool::SpecificPool::targetConnections() const {
+    return _parent->_controller->getControls(_id).targetConnections;
+}
+
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnection(
     Milliseconds timeout) {
 
@@ -647,6 +692,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
         auto conn = tryGetConnection();
 
         if (conn) {
+            recordQueueDelay(Milliseconds(0), now);
             LOGV2_DEBUG(22559,
                         kDiagnosticLogLevel,
                         "Using existing idle connection to {hostAndPort}",
@@ -670,7 +716,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     const auto expiration = now + timeout;
     auto pf = makePromiseFuture<ConnectionHandle>();
 
-    _requests.push_back(make_pair(expiration, std::move(pf.promise)));
+    _requests.push_back({expiration, now, std::move(pf.promise)});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
     return std::move(pf.future);
@@ -885,6 +931,32 @@ void ConnectionPool::SpecificPool::addToReady(OwnedConnection conn) {
     connPtr->setTimeout(_parent->_controller->toRefreshTimeout(), std::move(returnConnectionFunc));
 }
 
+void ConnectionPool::SpecificPool::recordQueueDelay(Milliseconds delay, Date_t now) {
+    // new_delay = alpha * x + (1 - alpha) * old_delay
+    _queueDelay = Microseconds(static_cast<Microseconds::rep>(
+        kQueueDelayAlpha * durationCount<Microseconds>(delay) +
+        (1 - kQueueDelayAlpha) * durationCount<Microseconds>(_queueDelay)));
+    _queueDelayUpdatedAt = now;
+}
+
+void ConnectionPool::SpecificPool::decayIdleQueueDelay(Date_t now) {
+    if (_queueDelay == Microseconds{0}) {
+        _queueDelayUpdatedAt = now;
+        return;
+    }
+
+    const auto periods = durationCount<Milliseconds>(now - _queueDelayUpdatedAt) /
+        durationCount<Milliseconds>(kQueueDelayIdleDecayPeriod);
+    if (periods <= 0) {
+        return;
+    }
+
+    // Each period is a request which did not wait: new_delay = (1 - alpha) * old_delay
+    _queueDelay = Microseconds(static_cast<Microseconds::rep>(
+        std::pow(1 - kQueueDelayAlpha, periods) * durationCount<Microseconds>(_queueDelay)));
+    _queueDelayUpdatedAt += kQueueDelayIdleDecayPeriod * periods;
+}
+
 // Sets state to shutdown and kicks off the failure protocol to tank existing connections
 void ConnectionPool::SpecificPool::triggerShutdown(const Status& status) {
     auto wasShutdown = std::exchange(_health.isShutdown, true);
@@ -947,7 +1019,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status) {
     }
 
     for (auto& request : _requests) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 
     LOGV2_DEBUG(22573,
@@ -976,7 +1048,8 @@ void ConnectionPool::SpecificPool::fulfillRequests() {
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        recordQueueDelay(_lastActiveTime - _requests.front().requestedAt, _lastActiveTime);
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -1109,8 +1182,8 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
     }
 
     // If a request would timeout before the next event, then it is the next event
-    if (_requests.size() && (_requests.front().first < nextEventTime)) {
-        nextEventTime = _requests.front().first;
+    if (_requests.size() && (_requests.front().expiration < nextEventTime)) {
+        nextEventTime = _requests.front().expiration;
     }
 
     // If our timer is already set to the next event, then we're done
@@ -1130,12 +1203,13 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
 
         _health.isFailed = false;
 
-        while (_requests.size() && (_requests.front().first <= now)) {
+        while (_requests.size() && (_requests.front().expiration <= now)) {
             std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
 
             auto& request = _requests.back();
-            request.second.setError(Status(ErrorCodes::NetworkInterfaceExceededTimeLimit,
-                                           "Couldn't get a connection within the time limit"));
+            recordQueueDelay(now - request.requestedAt, now);
+            request.promise.setError(Status(ErrorCodes::NetworkInterfaceExceededTimeLimit,
+                                            "Couldn't get a connection within the time limit"));
             _requests.pop_back();
 
             // Since we've failed a request, we've interacted with external users
@@ -1159,6 +1233,7 @@ void ConnectionPool::SpecificPool::updateController() {
         refreshingConnections(),
         availableConnections(),
         inUseConnections(),
+        queueDelay(),
     };
     LOGV2_DEBUG(22578,
                 kDiagnosticLogLevel,
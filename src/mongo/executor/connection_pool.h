@@ -211,6 +211,11 @@ public:
         size_t ready = 0;
         size_t active = 0;
 
+        // A moving average of how long recent requests waited for a connection. Requests which
+        // are fulfilled by a ready connection count as not having waited. While no requests are
+        // waiting, the average decays as though a request which did not wait arrived every second.
+        Microseconds queueDelay{0};
+
         std::string toString() const;
     };
 
@@ -31,6 +31,8 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
 
 namespace mongo {
@@ -49,6 +51,8 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    target += other.target;
+    queueDelay = std::max(queueDelay, other.queueDelay);
 
     return *this;
 }
@@ -114,6 +118,9 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostInfo.appendNumber("target", hostStats.target);
+                hostInfo.appendNumber("queueDelayMicros",
+                                      durationCount<Microseconds>(hostStats.queueDelay));
             }
         }
     }
@@ -126,6 +133,9 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostInfo.appendNumber("target", hostStats.target);
+            hostInfo.appendNumber("queueDelayMicros",
+                                  durationCount<Microseconds>(hostStats.queueDelay));
         }
     }
 }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -50,6 +51,13 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // The number of connections the pool's controller currently wants open, summed like the
+    // counts above.
+    size_t target = 0u;
+
+    // How long requests have recently waited for a connection. Combining stats keeps the longest.
+    Microseconds queueDelay{0};
 };
 
 /**
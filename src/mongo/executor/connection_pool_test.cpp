@@ -41,6 +41,7 @@
 #include <fmt/ostream.h>
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
@@ -959,6 +960,95 @@ TEST_F(ConnectionPoolTest, minPoolRespected) {
     ASSERT(!reachedC);
 }
 
+/**
+ * Verify that the time requests wait for a connection is averaged and reported with the pool's
+ * stats, and that requests served by a ready connection count as not having waited.
+ */
+TEST_F(ConnectionPoolTest, queueDelayReported) {
+    auto pool = makePool();
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // The first request waits 100ms for a new connection to be set up
+    ConnectionPool::ConnectionHandle conn;
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          ASSERT(swConn.isOK());
+                          conn = std::move(swConn.getValue());
+                      });
+    ASSERT(!conn);
+
+    PoolImpl::setNow(now + Milliseconds(100));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn);
+    doneWith(conn);
+
+    auto queueDelay = [&] {
+        ConnectionPoolStats stats;
+        pool->appendConnectionStats(&stats);
+        return stats.statsByHost[HostAndPort()].queueDelay;
+    };
+    ASSERT_EQ(queueDelay(), Milliseconds(20));
+
+    // The second request is served immediately by the ready connection
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          ASSERT(swConn.isOK());
+                          conn = std::move(swConn.getValue());
+                      });
+    ASSERT(conn);
+    doneWith(conn);
+
+    ASSERT_EQ(queueDelay(), Milliseconds(16));
+}
+
+/**
+ * Verify that the reported time requests wait for a connection decays while none are waiting, as
+ * though a request which did not wait arrived every second.
+ */
+TEST_F(ConnectionPoolTest, queueDelayDecaysWhileIdle) {
+    auto pool = makePool();
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool::ConnectionHandle conn;
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          ASSERT(swConn.isOK());
+                          conn = std::move(swConn.getValue());
+                      });
+    PoolImpl::setNow(now + Milliseconds(100));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn);
+    doneWith(conn);
+
+    auto queueDelay = [&] {
+        ConnectionPoolStats stats;
+        pool->appendConnectionStats(&stats);
+        return stats.statsByHost[HostAndPort()].queueDelay;
+    };
+    ASSERT_EQ(queueDelay(), Milliseconds(20));
+
+    // Less than a second later, nothing has decayed yet
+    PoolImpl::setNow(now + Milliseconds(1000));
+    ASSERT_EQ(queueDelay(), Milliseconds(20));
+
+    // Two seconds after the request, the average is as if two requests did not wait
+    PoolImpl::setNow(now + Milliseconds(2100));
+    ASSERT_EQ(queueDelay(), Microseconds(12800));
+
+    // Periods are counted from the last one applied, not from each update
+    PoolImpl::setNow(now + Milliseconds(2600));
+    ASSERT_EQ(queueDelay(), Microseconds(12800));
+    PoolImpl::setNow(now + Milliseconds(3100));
+    ASSERT_EQ(queueDelay(), Microseconds(10240));
+}
+
 
 /**
  * Verify that the hostTimeout is respected. This implies that an idle
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_tracker.h"
+
+#include "mongo/util/system_clock_source.h"
+
+namespace mongo {
+namespace executor {
+
+HostLatencyTracker::HostLatencyTracker(ClockSource* clockSource) : _clockSource(clockSource) {}
+
+HostLatencyTracker& HostLatencyTracker::get() {
+    static HostLatencyTracker tracker(SystemClockSource::get());
+    return tracker;
+}
+
+void HostLatencyTracker::recordLatency(const HostAndPort& host, Microseconds latency) {
+    const auto now = _clockSource->now();
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto [it, inserted] = _latencies.emplace(host, HostLatency{latency, now});
+    if (inserted) {
+        return;
+    }
+
+    auto& entry = it->second;
+    if (_isExpired(entry, now)) {
+        entry = HostLatency{latency, now};
+        return;
+    }
+
+    // new_latency = alpha * x + (1 - alpha) * old_latency
+    entry.average = Microseconds(static_cast<Microseconds::rep>(
+        kAlpha * durationCount<Microseconds>(latency) +
+        (1 - kAlpha) * durationCount<Microseconds>(entry.average)));
+    entry.lastSampled = now;
+}
+
+boost::optional<Microseconds> HostLatencyTracker::getLatency(const HostAndPort& host) const {
+    const auto now = _clockSource->now();
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _latencies.find(host);
+    if (it == _latencies.end() || _isExpired(it->second, now)) {
+        return boost::none;
+    }
+    return it->second.average;
+}
+
+void HostLatencyTracker::removeHost(const HostAndPort& host) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _latencies.erase(host);
+}
+
+void HostLatencyTracker::append(BSONObjBuilder* builder) const {
+    const auto now = _clockSource->now();
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (const auto& [host, latency] : _latencies) {
+        if (_isExpired(latency, now)) {
+            continue;
+        }
+        // Convert from micros so we don't lose information if under a ms
+        builder->append(host.toString(), durationCount<Microseconds>(latency.average) / 1000.0);
+    }
+}
+
+}  // namespace executor
+}  // namespace mongo
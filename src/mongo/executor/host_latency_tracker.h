@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+namespace executor {
+
+/**
+ * Process-wide record of how long the remote commands sent to each host take, from the moment a
+ * request is written to a connection until its response is read.
+ *
+ * Unlike the round trip times the replica set monitor measures with periodic pings, these samples
+ * arrive with every command and include the time the host spends queueing and executing them, so
+ * they notice a host which is slow for reasons other than its distance. Only commands which
+ * succeeded are sampled: a command which fails quickly, e.g. with NotWritablePrimary, says nothing
+ * about how fast the host serves the commands it accepts.
+ *
+ * A host's average expires once no sample has arrived for kSampleLifetime, so that a host which was
+ * slow once, and is therefore no longer sent commands, is treated as unknown again rather than
+ * being judged forever on its old latency.
+ */
+class HostLatencyTracker {
+    HostLatencyTracker(const HostLatencyTracker&) = delete;
+    HostLatencyTracker& operator=(const HostLatencyTracker&) = delete;
+
+public:
+    // The weight of each new sample in a host's moving average.
+    static constexpr double kAlpha = 0.2;
+
+    // How long a host's moving average is used after its latest sample.
+    static constexpr Seconds kSampleLifetime{10};
+
+    explicit HostLatencyTracker(ClockSource* clockSource);
+
+    static HostLatencyTracker& get();
+
+    /**
+     * Folds 'latency' into the exponentially weighted moving average for 'host'. If the average has
+     * expired, 'latency' starts a new one.
+     */
+    void recordLatency(const HostAndPort& host, Microseconds latency);
+
+    /**
+     * Returns the moving average for 'host', or boost::none if no command has completed against it
+     * within the last kSampleLifetime.
+     */
+    boost::optional<Microseconds> getLatency(const HostAndPort& host) const;
+
+    /**
+     * Forgets the moving average for 'host', e.g. because it has left its replica set.
+     */
+    void removeHost(const HostAndPort& host);
+
+    /**
+     * Appends the unexpired moving average for each host as "<host>: <millis>".
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    struct HostLatency {
+        Microseconds average;
+        Date_t lastSampled;
+    };
+
+    bool _isExpired(const HostLatency& latency, Date_t now) const {
+        return now - latency.lastSampled > kSampleLifetime;
+    }
+
+    ClockSource* const _clockSource;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("HostLatencyTracker::_mutex");
+    stdx::unordered_map<HostAndPort, HostLatency> _latencies;
+};
+
+}  // namespace executor
+}  // namespace mongo
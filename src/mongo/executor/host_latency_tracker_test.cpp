@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_tracker.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+TEST(HostLatencyTrackerTest, UnknownHostHasNoLatency) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    ASSERT_FALSE(tracker.getLatency(HostAndPort("a", 27017)));
+}
+
+TEST(HostLatencyTrackerTest, FirstSampleIsTheLatency) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    tracker.recordLatency(HostAndPort("a", 27017), Microseconds(500));
+    ASSERT_EQ(*tracker.getLatency(HostAndPort("a", 27017)), Microseconds(500));
+}
+
+TEST(HostLatencyTrackerTest, LaterSamplesAreAveraged) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    const HostAndPort host("a", 27017);
+    tracker.recordLatency(host, Microseconds(1000));
+    tracker.recordLatency(host, Microseconds(2000));
+    ASSERT_EQ(*tracker.getLatency(host), Microseconds(1200));
+    tracker.recordLatency(host, Microseconds(200));
+    ASSERT_EQ(*tracker.getLatency(host), Microseconds(1000));
+}
+
+TEST(HostLatencyTrackerTest, HostsAreTrackedSeparately) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    tracker.recordLatency(HostAndPort("a", 27017), Microseconds(1000));
+    tracker.recordLatency(HostAndPort("b", 27017), Microseconds(3000));
+    ASSERT_EQ(*tracker.getLatency(HostAndPort("a", 27017)), Microseconds(1000));
+    ASSERT_EQ(*tracker.getLatency(HostAndPort("b", 27017)), Microseconds(3000));
+    ASSERT_FALSE(tracker.getLatency(HostAndPort("a", 27018)));
+}
+
+TEST(HostLatencyTrackerTest, LatencyExpiresWithoutNewSamples) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    const HostAndPort host("a", 27017);
+    tracker.recordLatency(host, Microseconds(1000));
+
+    clock.advance(HostLatencyTracker::kSampleLifetime);
+    ASSERT_EQ(*tracker.getLatency(host), Microseconds(1000));
+    clock.advance(Milliseconds(1));
+    ASSERT_FALSE(tracker.getLatency(host));
+}
+
+TEST(HostLatencyTrackerTest, SampleAfterExpiryStartsANewAverage) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    const HostAndPort host("a", 27017);
+    tracker.recordLatency(host, Microseconds(10000));
+
+    clock.advance(HostLatencyTracker::kSampleLifetime + Milliseconds(1));
+    tracker.recordLatency(host, Microseconds(500));
+    ASSERT_EQ(*tracker.getLatency(host), Microseconds(500));
+}
+
+TEST(HostLatencyTrackerTest, EachSampleExtendsTheLifetime) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    const HostAndPort host("a", 27017);
+    tracker.recordLatency(host, Microseconds(1000));
+
+    clock.advance(HostLatencyTracker::kSampleLifetime);
+    tracker.recordLatency(host, Microseconds(2000));
+    clock.advance(HostLatencyTracker::kSampleLifetime);
+    ASSERT_EQ(*tracker.getLatency(host), Microseconds(1200));
+}
+
+TEST(HostLatencyTrackerTest, RemovedHostHasNoLatency) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    tracker.recordLatency(HostAndPort("a", 27017), Microseconds(1000));
+    tracker.recordLatency(HostAndPort("b", 27017), Microseconds(3000));
+
+    tracker.removeHost(HostAndPort("a", 27017));
+    ASSERT_FALSE(tracker.getLatency(HostAndPort("a", 27017)));
+    ASSERT_EQ(*tracker.getLatency(HostAndPort("b", 27017)), Microseconds(3000));
+}
+
+TEST(HostLatencyTrackerTest, AppendReportsMillis) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    tracker.recordLatency(HostAndPort("a", 27017), Microseconds(1500));
+
+    BSONObjBuilder builder;
+    tracker.append(&builder);
+    ASSERT_BSONOBJ_EQ(builder.obj(), BSON("a:27017" << 1.5));
+}
+
+TEST(HostLatencyTrackerTest, AppendSkipsExpiredLatencies) {
+    ClockSourceMock clock;
+    HostLatencyTracker tracker(&clock);
+    tracker.recordLatency(HostAndPort("a", 27017), Microseconds(1500));
+    clock.advance(HostLatencyTracker::kSampleLifetime + Milliseconds(1));
+    tracker.recordLatency(HostAndPort("b", 27017), Microseconds(2000));
+
+    BSONObjBuilder builder;
+    tracker.append(&builder);
+    ASSERT_BSONOBJ_EQ(builder.obj(), BSON("b:27017" << 2.0));
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/executor/hedging_metrics.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/transport/transport_layer_manager.h"
@@ -101,7 +102,19 @@ private:
 namespace {
 const Status kNetworkInterfaceShutdownInProgress = {ErrorCodes::ShutdownInProgress,
                                                     "NetworkInterface shutdown in progress"};
+
+/**
+ * Returns whether the server may hold on to 'request' until there is new data to return, which
+ * says nothing about the latency of the host. These are getMores on awaitData cursors, such as
+ * change streams, which are the only getMores allowed a maxTimeMS, and awaitable hellos.
+ */
+bool mayWaitForData(const RemoteCommandRequest& request) {
+    if (request.cmdObj.firstElementFieldNameStringData() == "getMore"_sd) {
+        return request.cmdObj.hasField("maxTimeMS"_sd);
+    }
+    return request.cmdObj.hasField("maxAwaitTimeMS"_sd);
 }
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -591,6 +604,12 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::CommandState::sendRequest(
                    ->runCommandRequest(*requestState->request, baton);
            })
         .then([this, requestState](RemoteCommandResponse response) {
+            // Only successful commands are sampled: a command which fails quickly, e.g. with
+            // NotWritablePrimary, would make its host look faster than it is.
+            if (response.elapsed && !mayWaitForData(*requestState->request) &&
+                response.isOK() && getStatusFromCommandResult(response.data).isOK()) {
+                HostLatencyTracker::get().recordLatency(requestState->host, *response.elapsed);
+            }
             doMetadataHook(RemoteCommandOnAnyResponse(requestState->host, response));
             return response;
         });
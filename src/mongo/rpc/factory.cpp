@@ -82,10 +82,10 @@ OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage) {
     }
 }
 
-std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol) {
+std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol, SharedBuffer buffer) {
     switch (protocol) {
         case Protocol::kOpMsg:
-            return std::make_unique<OpMsgReplyBuilder>();
+            return std::make_unique<OpMsgReplyBuilder>(std::move(buffer));
         case Protocol::kOpQuery:
             return std::make_unique<LegacyReplyBuilder>();
     }
@@ -67,9 +67,11 @@ inline Message messageFromOpMsgRequest(ProtocolSet clientProtos,
 OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage);
 
 /**
- * Returns the appropriate concrete ReplyBuilder.
+ * Returns the appropriate concrete ReplyBuilder. If 'buffer' is non-null and the protocol builds
+ * its reply in place, the reply is built in 'buffer' rather than in a newly allocated buffer.
  */
-std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol);
+std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol,
+                                                        SharedBuffer buffer = {});
 
 }  // namespace rpc
 }  // namespace mongo
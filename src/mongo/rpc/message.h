@@ -30,6 +30,7 @@
 #pragma once
 
 #include <cstdint>
+#include <utility>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
@@ -471,6 +472,13 @@ public:
         return _buf;
     }
 
+    /**
+     * Gives up this Message's reference to its buffer, leaving the Message empty.
+     */
+    SharedBuffer releaseBuffer() {
+        return std::exchange(_buf, {});
+    }
+
     std::string opMsgDebugString() const;
 
 private:
@@ -209,6 +209,17 @@ public:
         skipHeaderAndFlags();
     }
 
+    /**
+     * Builds the message in 'buffer' rather than in a newly allocated buffer. The buffer must not
+     * be shared and is grown as needed.
+     */
+    explicit OpMsgBuilder(SharedBuffer buffer) {
+        if (buffer) {
+            _buf.useSharedBuffer(std::move(buffer));
+        }
+        skipHeaderAndFlags();
+    }
+
     /**
      * See the documentation for DocSequenceBuilder below.
      */
@@ -122,6 +122,79 @@ TEST(OpMsg, FireAndForgetInsertWorks) {
     ASSERT_EQ(conn->count(NamespaceString("test.collection")), 1u);
 }
 
+TEST(OpMsg, PipelinedFireAndForgetInsertsAreAppliedInOrder) {
+    std::string errMsg;
+    auto conn = std::unique_ptr<DBClientBase>(
+        unittest::getFixtureConnectionString().connect("integration_test", errMsg));
+    uassert(ErrorCodes::SocketException, errMsg, conn);
+
+    conn->dropCollection("test.collection");
+
+    // Send the inserts back to back without waiting on the server, then an update which can only
+    // mark every document if all of the inserts were applied before it.
+    const int kNumInserts = 1000;
+    for (int i = 0; i < kNumInserts; ++i) {
+        conn->runFireAndForgetCommand(OpMsgRequest::fromDBAndBody(
+            "test",
+            BSON("insert"
+                 << "collection"
+                 << "writeConcern" << BSON("w" << 0) << "documents"
+                 << BSON_ARRAY(BSON("_id" << i)))));
+    }
+    conn->runFireAndForgetCommand(OpMsgRequest::fromDBAndBody(
+        "test",
+        BSON("update"
+             << "collection"
+             << "writeConcern" << BSON("w" << 0) << "updates"
+             << BSON_ARRAY(BSON("q" << BSON("_id" << BSON("$lt" << kNumInserts)) << "u"
+                                    << BSON("$set" << BSON("updated" << true)) << "multi"
+                                    << true)))));
+
+    ASSERT_EQ(conn->count(NamespaceString("test.collection"), BSON("updated" << true)),
+              size_t(kNumInserts));
+}
+
+TEST(OpMsg, ClosingConnectionDuringPipelinedFireAndForgetRequestEndsSession) {
+    std::string errMsg;
+    auto observer = std::unique_ptr<DBClientBase>(
+        unittest::getFixtureConnectionString().connect("integration_test", errMsg));
+    uassert(ErrorCodes::SocketException, errMsg, observer);
+
+    auto getCurrentConnections = [&] {
+        BSONObj serverStatusReply;
+        ASSERT(observer->runCommand("admin", BSON("serverStatus" << 1), serverStatusReply));
+        return serverStatusReply["connections"]["current"].numberInt();
+    };
+    const auto initialConnections = getCurrentConnections();
+
+    auto conn = std::unique_ptr<DBClientBase>(
+        unittest::getFixtureConnectionString().connect("integration_test", errMsg));
+    uassert(ErrorCodes::SocketException, errMsg, conn);
+
+    // When run asynchronously, the server starts reading the next message as it takes this request
+    // for processing. No message follows, so that read is still in flight when the client goes.
+    auto sleepCmd = BSON("sleep" << 1 << "millis" << 1000 << "lock"
+                                 << "none");
+    conn->runFireAndForgetCommand(OpMsgRequest::fromDBAndBody("admin", sleepCmd));
+    auto curOpCmd =
+        BSON("aggregate" << 1 << "cursor" << BSONObj() << "pipeline"
+                         << BSON_ARRAY(BSON("$currentOp" << BSON("localOps" << true))
+                                       << BSON("$match" << BSON("command.sleep" << 1))));
+    ASSERT(waitForCondition([&] {
+        const auto curOpReply =
+            observer->runCommand(OpMsgRequest::fromDBAndBody("admin", curOpCmd));
+        const auto cursorResponse = CursorResponse::parseFromBSON(curOpReply->getCommandReply());
+        ASSERT_OK(cursorResponse.getStatus());
+        return !cursorResponse.getValue().getBatch().empty();
+    }));
+    conn.reset();
+
+    // The session ends once the request completes, and the server keeps serving other clients.
+    ASSERT(waitForCondition([&] { return getCurrentConnections() == initialConnections; }));
+    BSONObj pingReply;
+    ASSERT(observer->runCommand("admin", BSON("ping" << 1), pingReply));
+}
+
 TEST(OpMsg, DocumentSequenceLargeDocumentMultiInsertWorks) {
     std::string errMsg;
     auto conn = std::unique_ptr<DBClientBase>(
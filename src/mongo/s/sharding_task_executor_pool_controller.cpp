@@ -215,8 +215,21 @@ auto ShardingTaskExecutorPoolController::updateHost(PoolId id, const HostState&
     const size_t minConns = gParameters.minConnections.load();
     const size_t maxConns = gParameters.maxConnections.load();
 
+    // Grow or shrink the spare connections according to how long requests wait for a connection
+    const auto targetQueueDelay = Milliseconds{gParameters.targetQueueDelayMS.load()};
+    if (targetQueueDelay <= Milliseconds{0}) {
+        poolData.spare = 0;
+    } else if (stats.requests > 0 && stats.queueDelay > targetQueueDelay) {
+        // An average left over from a busy period does not grow the pool unless requests are
+        // still waiting. The pool decays it while none are.
+        poolData.spare = std::min(poolData.spare + 1, maxConns);
+    } else if (poolData.spare > 0 && stats.requests == 0 &&
+               stats.queueDelay < targetQueueDelay / 2) {
+        --poolData.spare;
+    }
+
     // Update the target for just the pool first
-    poolData.target = stats.requests + stats.active;
+    poolData.target = stats.requests + stats.active + poolData.spare;
 
     if (poolData.target < minConns) {
         poolData.target = minConns;
@@ -59,6 +59,12 @@ namespace mongo {
  * When the MatchingStrategy is kMatchBusiestNode, it operates like kMatchPrimaryNode, but any pool
  * can be responsible for increasing the targetConnections of each member of its set.
  *
+ * When targetQueueDelayMS is set, each pool also keeps spare connections ready beyond those in use
+ * or requested. A pool gains a spare connection each time it updates while requests are waiting and
+ * the moving average of the time its requests wait for a connection is above the target, and loses
+ * one each time it updates with no requests waiting and the average below half the target. The
+ * pool decays the average while no requests are waiting, so an idle pool gives its spares back.
+ *
  * Note that, in essence, there are three outside elements that can mutate the state of this class:
  * * The ReplicaSetChangeNotifier can notify the listener which updates the host groups
  * * The ServerParameters can update the Parameters which will used in the next update
@@ -89,6 +95,8 @@ public:
 
         synchronized_value<std::string> matchingStrategyString;
         AtomicWord<MatchingStrategy> matchingStrategy;
+
+        AtomicWord<int> targetQueueDelayMS;
     };
 
     static inline Parameters gParameters;
@@ -177,6 +185,9 @@ private:
         // The number of connections the host should maintain
         size_t target = 0;
 
+        // The number of connections beyond those in use or requested that the host should maintain
+        size_t spare = 0;
+
         // This host is able to shutdown
         bool isAbleToShutdown = false;
     };
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/sharding_task_executor_pool_controller.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using ConnectionPool = executor::ConnectionPool;
+
+const ConnectionPool::PoolId kPoolId = 1;
+const HostAndPort kHost("FakeHost", 12345);
+
+class ShardingTaskExecutorPoolControllerTest : public unittest::Test {
+public:
+    void setUp() override {
+        auto& params = ShardingTaskExecutorPoolController::gParameters;
+        _savedMinConnections = params.minConnections.load();
+        _savedMaxConnections = params.maxConnections.load();
+        _savedTargetQueueDelayMS = params.targetQueueDelayMS.load();
+
+        params.minConnections.store(1);
+        params.maxConnections.store(8);
+        params.targetQueueDelayMS.store(10);
+
+        _controller.addHost(kPoolId, kHost);
+    }
+
+    void tearDown() override {
+        _controller.removeHost(kPoolId);
+
+        auto& params = ShardingTaskExecutorPoolController::gParameters;
+        params.minConnections.store(_savedMinConnections);
+        params.maxConnections.store(_savedMaxConnections);
+        params.targetQueueDelayMS.store(_savedTargetQueueDelayMS);
+    }
+
+    /**
+     * Updates the pool with the given state and returns its resulting target connections.
+     */
+    size_t update(size_t requests, size_t active, Milliseconds queueDelay) {
+        ConnectionPool::HostState stats;
+        stats.requests = requests;
+        stats.active = active;
+        stats.queueDelay = queueDelay;
+        _controller.updateHost(kPoolId, stats);
+        return _controller.getControls(kPoolId).targetConnections;
+    }
+
+private:
+    ShardingTaskExecutorPoolController _controller;
+
+    int _savedMinConnections;
+    int _savedMaxConnections;
+    int _savedTargetQueueDelayMS;
+};
+
+TEST_F(ShardingTaskExecutorPoolControllerTest, NoSpareConnectionsWithoutTargetQueueDelay) {
+    ShardingTaskExecutorPoolController::gParameters.targetQueueDelayMS.store(0);
+    ASSERT_EQ(update(2, 3, Milliseconds(100)), 5u);
+    ASSERT_EQ(update(2, 3, Milliseconds(100)), 5u);
+}
+
+TEST_F(ShardingTaskExecutorPoolControllerTest, SpareConnectionsGrowWhileRequestsWaitTooLong) {
+    ASSERT_EQ(update(1, 2, Milliseconds(20)), 4u);
+    ASSERT_EQ(update(1, 2, Milliseconds(20)), 5u);
+
+    // Waits within the target neither grow nor shrink the pool while requests are waiting.
+    ASSERT_EQ(update(1, 2, Milliseconds(4)), 5u);
+}
+
+TEST_F(ShardingTaskExecutorPoolControllerTest, SpareConnectionsAreCappedByMaxConnections) {
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_LTE(update(1, 2, Milliseconds(20)), 8u);
+    }
+    ASSERT_EQ(update(1, 2, Milliseconds(20)), 8u);
+}
+
+TEST_F(ShardingTaskExecutorPoolControllerTest, StaleQueueDelayDoesNotGrowIdlePool) {
+    ASSERT_EQ(update(1, 0, Milliseconds(20)), 2u);
+    ASSERT_EQ(update(1, 0, Milliseconds(20)), 3u);
+
+    // Once nothing is waiting, an average still above the target keeps the spares but no longer
+    // adds to them.
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(update(0, 0, Milliseconds(20)), 2u);
+    }
+}
+
+TEST_F(ShardingTaskExecutorPoolControllerTest, SpareConnectionsShrinkOnceIdle) {
+    ASSERT_EQ(update(1, 0, Milliseconds(20)), 2u);
+    ASSERT_EQ(update(1, 0, Milliseconds(20)), 3u);
+    ASSERT_EQ(update(1, 0, Milliseconds(20)), 4u);
+
+    // Between half the target and the target, the spares are kept.
+    ASSERT_EQ(update(0, 0, Milliseconds(6)), 3u);
+
+    // Below half the target with nothing waiting, one spare is given back per update, down to
+    // minConnections.
+    ASSERT_EQ(update(0, 0, Milliseconds(4)), 2u);
+    ASSERT_EQ(update(0, 0, Milliseconds(4)), 1u);
+    ASSERT_EQ(update(0, 0, Milliseconds(4)), 1u);
+    ASSERT_EQ(update(0, 0, Milliseconds(0)), 1u);
+}
+
+TEST_F(ShardingTaskExecutorPoolControllerTest, DisablingTargetQueueDelayDropsSpareConnections) {
+    ASSERT_EQ(update(1, 2, Milliseconds(20)), 4u);
+    ASSERT_EQ(update(1, 2, Milliseconds(20)), 5u);
+
+    ShardingTaskExecutorPoolController::gParameters.targetQueueDelayMS.store(0);
+    ASSERT_EQ(update(1, 2, Milliseconds(20)), 3u);
+}
+
+}  // namespace
+}  // namespace mongo
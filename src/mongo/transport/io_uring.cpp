@@ -0,0 +1,736 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring.h"
+
+#ifdef MONGO_HAS_IO_URING
+
+#include <asio.hpp>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mongo/base/string_data.h"
+#include "mongo/transport/asio_utils.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// The kernel reads and writes the heads and tails of the rings concurrently with us, so they are
+// accessed with the same acquire and release semantics as liburing uses.
+unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void storeRelease(T* p, T value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+Status errnoStatus(StringData call) {
+    auto savedErrno = errno;
+    return Status(ErrorCodes::OperationFailed,
+                  str::stream() << call << " failed: " << errnoWithDescription(savedErrno));
+}
+
+Status resultToStatus(int result) {
+    if (result == 0) {
+        return errorCodeToStatus(asio::error::eof);
+    }
+    return errorCodeToStatus(std::error_code(-result, asio::system_category()));
+}
+
+}  // namespace
+
+/**
+ * Reads the eventfd that other threads wake the reactor thread up with.
+ */
+class IoUring::WakeupOperation final : public IoUring::Operation {
+public:
+    explicit WakeupOperation(IoUring* ring) : _ring(ring) {}
+
+    void prepare(io_uring_sqe* sqe) override {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = _ring->_wakeupFd;
+        sqe->addr = reinterpret_cast<uint64_t>(&_count);
+        sqe->len = sizeof(_count);
+    }
+
+    void complete(int result, uint32_t flags) override {
+        if (result != -ECANCELED) {
+            _ring->submit(this);
+        }
+    }
+
+private:
+    IoUring* const _ring;
+    uint64_t _count = 0;
+};
+
+/**
+ * Cancels every operation in flight on the ring, when it shuts down.
+ */
+class IoUring::CancelAllOperation final : public IoUring::Operation {
+public:
+    void prepare(io_uring_sqe* sqe) override {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+    }
+
+    void complete(int result, uint32_t flags) override {}
+};
+
+StatusWith<std::unique_ptr<IoUring>> IoUring::make(const Options& options) {
+    std::unique_ptr<IoUring> ring(new IoUring(options));
+    auto status = ring->_setup();
+    if (!status.isOK()) {
+        return status;
+    }
+    return {std::move(ring)};
+}
+
+IoUring::IoUring(const Options& options)
+    : _options(options),
+      _wakeupOp(std::make_unique<WakeupOperation>(this)),
+      _cancelAllOp(std::make_unique<CancelAllOperation>()) {}
+
+IoUring::~IoUring() {
+    shutdown();
+
+    if (_bufferRing) {
+        ::munmap(_bufferRing, _bufferRingSize);
+    }
+    if (_sqes) {
+        ::munmap(_sqes, _sqesSize);
+    }
+    if (_cqRing && _cqRing != _sqRing) {
+        ::munmap(_cqRing, _cqRingSize);
+    }
+    if (_sqRing) {
+        ::munmap(_sqRing, _sqRingSize);
+    }
+    if (_wakeupFd >= 0) {
+        ::close(_wakeupFd);
+    }
+    if (_ringFd >= 0) {
+        ::close(_ringFd);
+    }
+}
+
+Status IoUring::_setup() {
+    const auto numBuffers = _options.numBuffers;
+    if (numBuffers == 0 || numBuffers > (1 << 15) || (numBuffers & (numBuffers - 1))) {
+        return Status(ErrorCodes::BadValue,
+                      "The number of io_uring buffers must be a power of two, at most 32768");
+    }
+
+    // Cooperative task running saves interrupting the reactor thread for every completion, and
+    // needs Linux 5.19.
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_COOP_TASKRUN;
+    _ringFd = ::syscall(__NR_io_uring_setup, _options.queueDepth, &params);
+    if (_ringFd < 0 && errno == EINVAL) {
+        memset(&params, 0, sizeof(params));
+        _ringFd = ::syscall(__NR_io_uring_setup, _options.queueDepth, &params);
+    }
+    if (_ringFd < 0) {
+        return errnoStatus("io_uring_setup");
+    }
+
+    // Without this, completions overflowing the completion queue would be lost.
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        return Status(ErrorCodes::OperationFailed,
+                      "The kernel's io_uring may drop completions when they overflow");
+    }
+
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+    }
+
+    auto mapRing = [&](size_t size, off_t offset) -> void* {
+        auto addr = ::mmap(
+            nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, offset);
+        return addr == MAP_FAILED ? nullptr : addr;
+    };
+
+    _sqRing = mapRing(_sqRingSize, IORING_OFF_SQ_RING);
+    if (!_sqRing) {
+        return errnoStatus("mmap of the io_uring submission queue");
+    }
+    _cqRing = singleMmap ? _sqRing : mapRing(_cqRingSize, IORING_OFF_CQ_RING);
+    if (!_cqRing) {
+        return errnoStatus("mmap of the io_uring completion queue");
+    }
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = static_cast<io_uring_sqe*>(mapRing(_sqesSize, IORING_OFF_SQES));
+    if (!_sqes) {
+        return errnoStatus("mmap of the io_uring submission queue entries");
+    }
+
+    auto sq = static_cast<char*>(_sqRing);
+    _sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    _sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sqEntries = params.sq_entries;
+
+    auto cq = static_cast<char*>(_cqRing);
+    _cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // The buffer ring must be page aligned, which mmap() guarantees.
+    _bufferRingSize = numBuffers * sizeof(io_uring_buf);
+    auto bufferRing = ::mmap(
+        nullptr, _bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufferRing == MAP_FAILED) {
+        return errnoStatus("mmap of the io_uring buffer ring");
+    }
+    _bufferRing = static_cast<io_uring_buf*>(bufferRing);
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(_bufferRing);
+    reg.ring_entries = numBuffers;
+    reg.bgid = kBufferGroup;
+    if (::syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return errnoStatus("io_uring_register of the buffer ring");
+    }
+
+    _buffers.reset(new char[size_t(numBuffers) * _options.bufferSize]);
+    for (unsigned id = 0; id < numBuffers; ++id) {
+        recycleBuffer(id);
+    }
+
+    _wakeupFd = ::eventfd(0, EFD_CLOEXEC);
+    if (_wakeupFd < 0) {
+        return errnoStatus("eventfd");
+    }
+
+    return Status::OK();
+}
+
+void IoUring::start() {
+    submit(_wakeupOp.get());
+    _thread = stdx::thread([this] { _run(); });
+}
+
+void IoUring::shutdown() {
+    std::vector<Operation*> queued;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (std::exchange(_inShutdown, true)) {
+            return;
+        }
+
+        if (!_thread.joinable()) {
+            queued = std::exchange(_queued, {});
+        }
+    }
+
+    if (!_thread.joinable()) {
+        // The reactor thread never started, so nothing is in flight.
+        for (auto op : queued) {
+            op->complete(-ECANCELED, 0);
+        }
+        return;
+    }
+
+    _wakeup();
+    _thread.join();
+}
+
+void IoUring::submit(Operation* op) {
+    bool wakeup = false;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_inShutdown) {
+            _queued.push_back(op);
+            wakeup = std::exchange(_waiting, false);
+            op = nullptr;
+        }
+    }
+
+    if (op) {
+        op->complete(-ECANCELED, 0);
+    } else if (wakeup) {
+        _wakeup();
+    }
+}
+
+IoUring::Stats IoUring::getStats() const {
+    Stats stats;
+    stats.submitted = _submitted.load();
+    stats.enterCalls = _enterCalls.load();
+    stats.completions = _completions.load();
+    return stats;
+}
+
+void IoUring::recycleBuffer(uint16_t id) {
+    auto& entry = _bufferRing[_bufferRingTail & (_options.numBuffers - 1)];
+    entry.addr = reinterpret_cast<uint64_t>(buffer(id));
+    entry.len = _options.bufferSize;
+    entry.bid = id;
+    ++_bufferRingTail;
+
+    // The ring's tail overlays the reserved field of its first entry. This doesn't go through
+    // io_uring_buf_ring, whose layout differs between C and C++.
+    storeRelease(&_bufferRing[0].resv, _bufferRingTail);
+}
+
+void IoUring::_run() noexcept {
+    setThreadName("IoUringReactor");
+
+    // Operations taken off the queue which haven't fit in the submission queue yet.
+    std::vector<Operation*> toPrepare;
+    size_t prepared = 0;
+    bool cancelledAll = false;
+
+    while (!cancelledAll || _inFlight > 0) {
+        bool inShutdown;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            toPrepare.insert(toPrepare.end(), _queued.begin(), _queued.end());
+            _queued.clear();
+            inShutdown = _inShutdown;
+            _waiting = true;
+        }
+
+        unsigned toSubmit = 0;
+        auto tail = *_sqTail;
+        auto prepareNext = [&](Operation* op) {
+            auto sqe = &_sqes[tail & _sqMask];
+            memset(sqe, 0, sizeof(*sqe));
+            op->prepare(sqe);
+            sqe->user_data = reinterpret_cast<uint64_t>(op);
+            _sqArray[tail & _sqMask] = tail & _sqMask;
+            ++tail;
+            ++toSubmit;
+            ++_inFlight;
+        };
+
+        if (inShutdown && !cancelledAll) {
+            // Fail whatever hasn't been submitted yet, and cancel everything else.
+            for (auto it = toPrepare.begin() + prepared; it != toPrepare.end(); ++it) {
+                (*it)->complete(-ECANCELED, 0);
+            }
+            toPrepare.clear();
+            prepared = 0;
+
+            prepareNext(_cancelAllOp.get());
+            cancelledAll = true;
+        }
+
+        // The kernel consumes the whole submission queue on every io_uring_enter(), so there is
+        // room for at least this many entries.
+        while (prepared < toPrepare.size() && toSubmit < _sqEntries) {
+            prepareNext(toPrepare[prepared++]);
+        }
+        if (prepared == toPrepare.size()) {
+            toPrepare.clear();
+            prepared = 0;
+        }
+        storeRelease(_sqTail, tail);
+
+        // Only wait for completions when nothing is left to submit.
+        _enter(toSubmit, toPrepare.empty() ? 1 : 0);
+
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _waiting = false;
+        }
+
+        _reap();
+    }
+}
+
+void IoUring::_enter(unsigned toSubmit, unsigned minComplete) {
+    while (true) {
+        _enterCalls.fetchAndAdd(1);
+        auto flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+        auto submitted =
+            ::syscall(__NR_io_uring_enter, _ringFd, toSubmit, minComplete, flags, nullptr, 0);
+        if (submitted >= 0) {
+            _submitted.fetchAndAdd(submitted);
+            toSubmit -= submitted;
+            if (toSubmit == 0) {
+                return;
+            }
+            continue;
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+
+        if (errno == EBUSY || errno == EAGAIN) {
+            // The completion queue overflowed, so make room in it before submitting more.
+            _reap();
+            minComplete = 0;
+            continue;
+        }
+
+        fassert(5035010, errnoStatus("io_uring_enter"));
+    }
+}
+
+size_t IoUring::_reap() {
+    size_t reaped = 0;
+    auto head = *_cqHead;
+    while (head != loadAcquire(_cqTail)) {
+        const auto& cqe = _cqes[head & _cqMask];
+        auto op = reinterpret_cast<Operation*>(cqe.user_data);
+        auto result = cqe.res;
+        auto flags = cqe.flags;
+
+        // Hand the entry back to the kernel before completing the operation, which may submit
+        // more work.
+        storeRelease(_cqHead, ++head);
+        ++reaped;
+
+        if (!(flags & IORING_CQE_F_MORE)) {
+            --_inFlight;
+        }
+        op->complete(result, flags);
+    }
+
+    _completions.fetchAndAdd(reaped);
+    return reaped;
+}
+
+void IoUring::_wakeup() {
+    while (::eventfd_write(_wakeupFd, 1) != 0) {
+        invariant(errno == EINTR);
+    }
+}
+
+class IoUringSocket::ReceiveOperation final : public IoUring::Operation {
+public:
+    explicit ReceiveOperation(IoUringSocket* socket) : _socket(socket) {}
+
+    void prepare(io_uring_sqe* sqe) override {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = _socket->_fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = _socket->_ring->bufferGroup();
+    }
+
+    void complete(int result, uint32_t flags) override {
+        _socket->_onReceived(result, flags);
+    }
+
+    // Keeps the socket alive while the receive is in flight.
+    std::shared_ptr<IoUringSocket> self;
+
+private:
+    IoUringSocket* const _socket;
+};
+
+/**
+ * Cancels the receive of a socket whose backlog is full.
+ */
+class IoUringSocket::PauseOperation final : public IoUring::Operation {
+public:
+    explicit PauseOperation(IoUringSocket* socket) : _socket(socket) {}
+
+    void prepare(io_uring_sqe* sqe) override {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<uint64_t>(_socket->_receiveOp.get());
+    }
+
+    void complete(int result, uint32_t flags) override {
+        auto released = std::move(self);
+    }
+
+    std::shared_ptr<IoUringSocket> self;
+
+private:
+    IoUringSocket* const _socket;
+};
+
+class IoUringSocket::SendOperation final : public IoUring::Operation {
+public:
+    explicit SendOperation(IoUringSocket* socket) : _socket(socket) {}
+
+    void prepare(io_uring_sqe* sqe) override {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = _socket->_fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buf + sent);
+        sqe->len = len - sent;
+        sqe->msg_flags = MSG_NOSIGNAL;
+    }
+
+    void complete(int result, uint32_t flags) override {
+        if (result > 0) {
+            sent += result;
+            if (sent < len) {
+                _socket->_ring->submit(this);
+                return;
+            }
+        }
+
+        // Fulfilling the promise may start the next write.
+        auto released = std::move(self);
+        auto fulfilled = std::move(*promise);
+        promise.reset();
+        if (result > 0) {
+            fulfilled.emplaceValue();
+        } else {
+            fulfilled.setError(resultToStatus(result));
+        }
+    }
+
+    const char* buf = nullptr;
+    size_t len = 0;
+    size_t sent = 0;
+    boost::optional<Promise<void>> promise;
+    std::shared_ptr<IoUringSocket> self;
+
+private:
+    IoUringSocket* const _socket;
+};
+
+std::shared_ptr<IoUringSocket> IoUring::makeSocket(int fd) {
+    auto ownFd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (ownFd < 0) {
+        return nullptr;
+    }
+
+    auto socket = std::make_shared<IoUringSocket>(this, ownFd);
+    bool startReceiving;
+    {
+        stdx::lock_guard<Latch> lk(socket->_mutex);
+        startReceiving = socket->_shouldStartReceiving(lk);
+    }
+    if (startReceiving) {
+        submit(socket->_receiveOp.get());
+    }
+    return socket;
+}
+
+IoUringSocket::IoUringSocket(IoUring* ring, int fd)
+    : _ring(ring),
+      _fd(fd),
+      _receiveOp(std::make_unique<ReceiveOperation>(this)),
+      _sendOp(std::make_unique<SendOperation>(this)),
+      _pauseOp(std::make_unique<PauseOperation>(this)) {}
+
+IoUringSocket::~IoUringSocket() {
+    ::close(_fd);
+}
+
+Future<void> IoUringSocket::read(void* buf, size_t len) {
+    auto dest = static_cast<char*>(buf);
+    bool startReceiving;
+    Future<void> future;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        invariant(!_read);
+
+        auto fromBacklog = std::min(len, _backlog.size());
+        memcpy(dest, _backlog.data(), fromBacklog);
+        _backlog.erase(0, fromBacklog);
+
+        if (fromBacklog == len) {
+            future = Future<void>::makeReady();
+        } else if (!_receiveStatus.isOK()) {
+            future = Future<void>::makeReady(_receiveStatus);
+        } else {
+            auto pf = makePromiseFuture<void>();
+            _read.emplace(PendingRead{dest, len, fromBacklog, std::move(pf.promise)});
+            future = std::move(pf.future);
+        }
+
+        startReceiving = _shouldStartReceiving(lk);
+    }
+
+    if (startReceiving) {
+        _ring->submit(_receiveOp.get());
+    }
+    return future;
+}
+
+Future<void> IoUringSocket::write(const void* buf, size_t len) {
+    invariant(!_sendOp->promise);
+    if (len == 0) {
+        return Future<void>::makeReady();
+    }
+
+    auto pf = makePromiseFuture<void>();
+    _sendOp->buf = static_cast<const char*>(buf);
+    _sendOp->len = len;
+    _sendOp->sent = 0;
+    _sendOp->promise.emplace(std::move(pf.promise));
+    _sendOp->self = shared_from_this();
+    _ring->submit(_sendOp.get());
+    return std::move(pf.future);
+}
+
+Future<void> IoUringSocket::waitForData() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(!_dataPromise);
+    if (!_backlog.empty() || !_receiveStatus.isOK()) {
+        return Future<void>::makeReady();
+    }
+
+    auto pf = makePromiseFuture<void>();
+    _dataPromise.emplace(std::move(pf.promise));
+    return std::move(pf.future);
+}
+
+void IoUringSocket::cancel() {
+    boost::optional<PendingRead> read;
+    boost::optional<Promise<void>> dataPromise;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        read = std::exchange(_read, boost::none);
+        dataPromise = std::exchange(_dataPromise, boost::none);
+    }
+
+    const Status canceled(ErrorCodes::CallbackCanceled, "Callback was canceled");
+    if (read) {
+        read->promise.setError(canceled);
+    }
+    if (dataPromise) {
+        dataPromise->setError(canceled);
+    }
+}
+
+bool IoUringSocket::_shouldStartReceiving(WithLock) {
+    if (_receiving || !_receiveStatus.isOK() || _backlog.size() >= kMaxBacklogBytes) {
+        return false;
+    }
+
+    _receiving = true;
+    _receiveOp->self = shared_from_this();
+    return true;
+}
+
+void IoUringSocket::_onReceived(int result, uint32_t flags) {
+    // Released last, as it may hold the last reference to this socket.
+    std::shared_ptr<IoUringSocket> released;
+
+    boost::optional<Promise<void>> readPromise;
+    Status readStatus = Status::OK();
+    boost::optional<Promise<void>> dataPromise;
+    bool startReceiving = false;
+    bool pause = false;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+
+        if (result > 0) {
+            invariant(flags & IORING_CQE_F_BUFFER);
+            const uint16_t bufferId = flags >> IORING_CQE_BUFFER_SHIFT;
+            StringData received(_ring->buffer(bufferId), result);
+
+            if (_read) {
+                auto toRead = std::min(received.size(), _read->len - _read->filled);
+                memcpy(_read->buf + _read->filled, received.rawData(), toRead);
+                _read->filled += toRead;
+                received = received.substr(toRead);
+                if (_read->filled == _read->len) {
+                    readPromise.emplace(std::move(_read->promise));
+                    _read.reset();
+                }
+            }
+            _backlog.append(received.rawData(), received.size());
+            _ring->recycleBuffer(bufferId);
+
+            if (_backlog.size() >= kMaxBacklogBytes && (flags & IORING_CQE_F_MORE) &&
+                !std::exchange(_pausing, true)) {
+                _pauseOp->self = shared_from_this();
+                pause = true;
+            }
+        } else if (result == -ENOBUFS) {
+            // Every receive buffer was taken. The receive stopped, and starts again below.
+        } else if (result == -ECANCELED && _pausing) {
+            // The backlog is full. The receive starts again once a read has drained it.
+        } else {
+            _receiveStatus = resultToStatus(result);
+        }
+
+        if (!(flags & IORING_CQE_F_MORE)) {
+            _receiving = false;
+            _pausing = false;
+            released = std::move(_receiveOp->self);
+            startReceiving = _shouldStartReceiving(lk);
+        }
+
+        if (!_receiveStatus.isOK() && _read) {
+            readPromise.emplace(std::move(_read->promise));
+            readStatus = _receiveStatus;
+            _read.reset();
+        }
+        if (_dataPromise && (!_backlog.empty() || !_receiveStatus.isOK())) {
+            dataPromise = std::exchange(_dataPromise, boost::none);
+        }
+    }
+
+    if (pause) {
+        _ring->submit(_pauseOp.get());
+    }
+    if (startReceiving) {
+        _ring->submit(_receiveOp.get());
+    }
+
+    if (readPromise) {
+        if (readStatus.isOK()) {
+            readPromise->emplaceValue();
+        } else {
+            readPromise->setError(readStatus);
+        }
+    }
+    if (dataPromise) {
+        dataPromise->emplaceValue();
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
+
+#endif  // MONGO_HAS_IO_URING
@@ -0,0 +1,329 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+// Multishot receives only exist in the io_uring headers of Linux 6.0 and later. Without them, all
+// network I/O goes through ASIO.
+#ifdef IORING_RECV_MULTISHOT
+#define MONGO_HAS_IO_URING
+#endif
+
+#include <memory>
+
+namespace mongo {
+namespace transport {
+
+class IoUring;
+class IoUringSocket;
+
+}  // namespace transport
+}  // namespace mongo
+
+#ifdef MONGO_HAS_IO_URING
+
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/future.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * An io_uring instance which performs the network I/O of many sockets.
+ *
+ * Any thread may submit operations. They are queued, and a single reactor thread hands everything
+ * queued since its last pass to the kernel with one io_uring_enter() call, which also reaps the
+ * completions. The buffers that receives land in are registered with the kernel up front, as a
+ * provided buffer ring.
+ */
+class IoUring {
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+public:
+    struct Options {
+        // The number of submission queue entries.
+        unsigned queueDepth = 4096;
+
+        // The number and size of the receive buffers. The number must be a power of two.
+        unsigned numBuffers = 1024;
+        unsigned bufferSize = 16 * 1024;
+    };
+
+    struct Stats {
+        // Operations handed to the kernel.
+        long long submitted = 0;
+
+        // Calls to io_uring_enter(), each of which submits a batch of operations.
+        long long enterCalls = 0;
+
+        // Completion queue entries reaped.
+        long long completions = 0;
+    };
+
+    /**
+     * An operation to run on the ring. The reactor thread fills in its submission queue entry, and
+     * then calls complete() with each of its completion queue entries. There are more completions
+     * to come for the operation only if 'flags' contains IORING_CQE_F_MORE.
+     */
+    class Operation {
+    public:
+        virtual ~Operation() = default;
+
+        virtual void prepare(io_uring_sqe* sqe) = 0;
+
+        virtual void complete(int result, uint32_t flags) = 0;
+    };
+
+    /**
+     * Sets up an io_uring instance and registers its receive buffers. Fails if the kernel doesn't
+     * support io_uring, or doesn't let this process use it.
+     */
+    static StatusWith<std::unique_ptr<IoUring>> make(const Options& options);
+
+    ~IoUring();
+
+    /**
+     * Starts the reactor thread. Operations submitted before then are queued.
+     */
+    void start();
+
+    /**
+     * Cancels every operation in flight, and stops the reactor thread once they have all
+     * completed. Operations submitted afterwards complete right away with -ECANCELED.
+     */
+    void shutdown();
+
+    /**
+     * Returns an IoUringSocket for the connected socket 'fd', which starts receiving right away, or
+     * nullptr if 'fd' can't be duplicated.
+     */
+    std::shared_ptr<IoUringSocket> makeSocket(int fd);
+
+    /**
+     * Queues 'op' to be submitted. The operation must stay alive until its last completion.
+     */
+    void submit(Operation* op);
+
+    Stats getStats() const;
+
+    uint16_t bufferGroup() const {
+        return kBufferGroup;
+    }
+
+    /**
+     * Returns the receive buffer 'id', chosen by the kernel for a completion.
+     */
+    const char* buffer(uint16_t id) const {
+        return _buffers.get() + size_t(id) * _options.bufferSize;
+    }
+
+    /**
+     * Returns the receive buffer 'id' to the kernel. Only the reactor thread may call this.
+     */
+    void recycleBuffer(uint16_t id);
+
+private:
+    class WakeupOperation;
+    class CancelAllOperation;
+
+    static constexpr uint16_t kBufferGroup = 0;
+
+    explicit IoUring(const Options& options);
+
+    Status _setup();
+
+    void _run() noexcept;
+
+    /**
+     * Submits 'toSubmit' entries from the submission queue, and waits until at least 'minComplete'
+     * completions are ready.
+     */
+    void _enter(unsigned toSubmit, unsigned minComplete);
+
+    /**
+     * Calls complete() on the operation of every completion queue entry, and returns their number.
+     */
+    size_t _reap();
+
+    void _wakeup();
+
+    const Options _options;
+
+    int _ringFd = -1;
+
+    // The submission queue, shared with the kernel. Only the reactor thread touches it.
+    void* _sqRing = nullptr;
+    size_t _sqRingSize = 0;
+    unsigned* _sqHead = nullptr;
+    unsigned* _sqTail = nullptr;
+    unsigned* _sqArray = nullptr;
+    unsigned _sqMask = 0;
+    unsigned _sqEntries = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqesSize = 0;
+
+    // The completion queue, shared with the kernel. It may share its mapping with the submission
+    // queue.
+    void* _cqRing = nullptr;
+    size_t _cqRingSize = 0;
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned _cqMask = 0;
+    io_uring_cqe* _cqes = nullptr;
+
+    // The receive buffers, and the ring through which they are handed to the kernel.
+    std::unique_ptr<char[]> _buffers;
+    io_uring_buf* _bufferRing = nullptr;
+    size_t _bufferRingSize = 0;
+    uint16_t _bufferRingTail = 0;
+
+    // An eventfd, which other threads write to when the reactor thread is waiting in the kernel
+    // and they have queued operations for it.
+    int _wakeupFd = -1;
+    std::unique_ptr<WakeupOperation> _wakeupOp;
+    std::unique_ptr<CancelAllOperation> _cancelAllOp;
+
+    // Operations which are in the kernel, and haven't had their last completion yet. Only the
+    // reactor thread touches it.
+    size_t _inFlight = 0;
+
+    AtomicWord<long long> _submitted{0};
+    AtomicWord<long long> _enterCalls{0};
+    AtomicWord<long long> _completions{0};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("IoUring::_mutex");
+    std::vector<Operation*> _queued;
+    bool _waiting = false;
+    bool _inShutdown = false;
+    stdx::thread _thread;
+};
+
+/**
+ * The io_uring side of a connected socket. It keeps one multishot receive in flight, which copies
+ * the bytes received straight into a pending read, and into a backlog otherwise. At most one read
+ * and one write may be pending at a time.
+ *
+ * The socket works on a duplicate of the caller's file descriptor, so that operations still queued
+ * once the caller closed its own can't reach another socket that reused the number. The caller
+ * must shut the socket down before closing it, so that the receive completes.
+ */
+class IoUringSocket : public std::enable_shared_from_this<IoUringSocket> {
+    IoUringSocket(const IoUringSocket&) = delete;
+    IoUringSocket& operator=(const IoUringSocket&) = delete;
+
+public:
+    // The receive stops while this many bytes are waiting to be read, so that a client can't fill
+    // up the memory of the server by sending faster than it replies.
+    static constexpr size_t kMaxBacklogBytes = 1024 * 1024;
+
+    /**
+     * Takes ownership of 'fd'. Use IoUring::makeSocket() rather than this.
+     */
+    IoUringSocket(IoUring* ring, int fd);
+
+    ~IoUringSocket();
+
+    /**
+     * Reads exactly 'len' bytes into 'buf', which must stay valid until the future is ready.
+     */
+    Future<void> read(void* buf, size_t len);
+
+    /**
+     * Writes the 'len' bytes at 'buf', which must stay valid until the future is ready.
+     */
+    Future<void> write(const void* buf, size_t len);
+
+    /**
+     * Returns a future that is ready once there are bytes to read, or the socket has failed.
+     */
+    Future<void> waitForData();
+
+    /**
+     * Fails the pending read and waitForData() with CallbackCanceled. The socket keeps receiving.
+     */
+    void cancel();
+
+private:
+    friend class IoUring;
+
+    class ReceiveOperation;
+    class SendOperation;
+    class PauseOperation;
+
+    struct PendingRead {
+        char* buf;
+        size_t len;
+        size_t filled;
+        Promise<void> promise;
+    };
+
+    /**
+     * Returns whether to submit the receive, which is the case when it isn't in flight and the
+     * socket can still take more bytes. The caller must submit it after releasing the lock.
+     */
+    bool _shouldStartReceiving(WithLock);
+
+    void _onReceived(int result, uint32_t flags);
+
+    IoUring* const _ring;
+    const int _fd;
+
+    const std::unique_ptr<ReceiveOperation> _receiveOp;
+    const std::unique_ptr<SendOperation> _sendOp;
+    const std::unique_ptr<PauseOperation> _pauseOp;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("IoUringSocket::_mutex");
+
+    // Why the socket can't receive any more, such as the peer having closed it.
+    Status _receiveStatus = Status::OK();
+    bool _receiving = false;
+    bool _pausing = false;
+
+    std::string _backlog;
+    boost::optional<PendingRead> _read;
+    boost::optional<Promise<void>> _dataPromise;
+};
+
+}  // namespace transport
+}  // namespace mongo
+
+#endif  // MONGO_HAS_IO_URING
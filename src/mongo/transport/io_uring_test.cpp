@@ -0,0 +1,282 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kTest
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring.h"
+
+#ifdef MONGO_HAS_IO_URING
+
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+class IoUringTest : public unittest::Test {
+public:
+    void setUp() override {
+        IoUring::Options options;
+        options.numBuffers = 64;
+        options.bufferSize = 4096;
+        auto swRing = IoUring::make(options);
+        if (!swRing.isOK()) {
+            LOGV2(5035015, "Skipping io_uring test", "error"_attr = swRing.getStatus());
+            return;
+        }
+        _ring = std::move(swRing.getValue());
+        _ring->start();
+
+        int fds[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+        _fd = fds[0];
+        _peerFd = fds[1];
+        _socket = _ring->makeSocket(_fd);
+        ASSERT(_socket);
+    }
+
+    void tearDown() override {
+        if (!_ring) {
+            return;
+        }
+
+        ::shutdown(_fd, SHUT_RDWR);
+        ::close(_fd);
+        if (_peerFd >= 0) {
+            ::close(_peerFd);
+        }
+        _socket.reset();
+        _ring->shutdown();
+    }
+
+    bool supported() const {
+        return bool(_ring);
+    }
+
+    void peerWrite(const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            auto ret = ::write(_peerFd, data.data() + written, data.size() - written);
+            ASSERT_GT(ret, 0);
+            written += ret;
+        }
+    }
+
+    std::string peerRead(size_t len) {
+        std::string data(len, '\0');
+        size_t read = 0;
+        while (read < len) {
+            auto ret = ::read(_peerFd, &data[read], len - read);
+            ASSERT_GT(ret, 0);
+            read += ret;
+        }
+        return data;
+    }
+
+    static std::string makeData(size_t len) {
+        std::string data(len, '\0');
+        for (size_t i = 0; i < len; ++i) {
+            data[i] = 'a' + i % 26;
+        }
+        return data;
+    }
+
+    std::unique_ptr<IoUring> _ring;
+    std::shared_ptr<IoUringSocket> _socket;
+    int _fd = -1;
+    int _peerFd = -1;
+};
+
+TEST_F(IoUringTest, ReadReturnsBytesReceivedBeforeAndAfterIt) {
+    if (!supported()) {
+        return;
+    }
+
+    peerWrite("0123");
+    char buf[8];
+    auto future = _socket->read(buf, sizeof(buf));
+    peerWrite("4567");
+    ASSERT_OK(future.getNoThrow());
+    ASSERT_EQ(StringData(buf, sizeof(buf)), "01234567");
+}
+
+TEST_F(IoUringTest, ReadSpansManyBuffers) {
+    if (!supported()) {
+        return;
+    }
+
+    // Much more than the receive buffers can hold at once.
+    auto data = makeData(1024 * 1024);
+    stdx::thread peer([&] { peerWrite(data); });
+
+    std::string received(data.size(), '\0');
+    ASSERT_OK(_socket->read(&received[0], received.size()).getNoThrow());
+    peer.join();
+    ASSERT(received == data);
+}
+
+TEST_F(IoUringTest, ReadsDrainTheBacklogOfAPausedSocket) {
+    if (!supported()) {
+        return;
+    }
+
+    // Nothing is read until the peer is done, so the backlog exceeds its limit.
+    auto data = makeData(3 * IoUringSocket::kMaxBacklogBytes);
+    stdx::thread peer([&] { peerWrite(data); });
+    sleepmillis(100);
+
+    std::string received(data.size(), '\0');
+    for (size_t offset = 0; offset < received.size(); offset += 64 * 1024) {
+        ASSERT_OK(_socket->read(&received[offset], 64 * 1024).getNoThrow());
+    }
+    peer.join();
+    ASSERT(received == data);
+}
+
+TEST_F(IoUringTest, WaitForDataIsReadyOnceBytesArrive) {
+    if (!supported()) {
+        return;
+    }
+
+    auto future = _socket->waitForData();
+    ASSERT_FALSE(future.isReady());
+    peerWrite("x");
+    ASSERT_OK(future.getNoThrow());
+
+    // The byte is still there to read.
+    ASSERT_OK(_socket->waitForData().getNoThrow());
+    char c;
+    ASSERT_OK(_socket->read(&c, 1).getNoThrow());
+    ASSERT_EQ(c, 'x');
+}
+
+TEST_F(IoUringTest, WriteSendsEveryByte) {
+    if (!supported()) {
+        return;
+    }
+
+    auto data = makeData(1024 * 1024);
+    std::string received;
+    stdx::thread peer([&] { received = peerRead(data.size()); });
+
+    ASSERT_OK(_socket->write(data.data(), data.size()).getNoThrow());
+    peer.join();
+    ASSERT(received == data);
+}
+
+TEST_F(IoUringTest, CancelFailsPendingRead) {
+    if (!supported()) {
+        return;
+    }
+
+    char buf[4];
+    auto future = _socket->read(buf, sizeof(buf));
+    _socket->cancel();
+    ASSERT_EQ(future.getNoThrow(), ErrorCodes::CallbackCanceled);
+
+    // The socket keeps receiving.
+    peerWrite("abcd");
+    ASSERT_OK(_socket->read(buf, sizeof(buf)).getNoThrow());
+    ASSERT_EQ(StringData(buf, sizeof(buf)), "abcd");
+}
+
+TEST_F(IoUringTest, ReadFailsOncePeerCloses) {
+    if (!supported()) {
+        return;
+    }
+
+    peerWrite("ab");
+    ::close(std::exchange(_peerFd, -1));
+
+    char buf[4];
+    ASSERT_EQ(_socket->read(buf, sizeof(buf)).getNoThrow(), ErrorCodes::HostUnreachable);
+    ASSERT_OK(_socket->waitForData().getNoThrow());
+}
+
+TEST_F(IoUringTest, ShutdownFailsPendingAndLaterOperations) {
+    if (!supported()) {
+        return;
+    }
+
+    char buf[4];
+    auto future = _socket->read(buf, sizeof(buf));
+    _ring->shutdown();
+    ASSERT_EQ(future.getNoThrow(), ErrorCodes::CallbackCanceled);
+    ASSERT_EQ(_socket->write("x", 1).getNoThrow(), ErrorCodes::CallbackCanceled);
+}
+
+TEST_F(IoUringTest, OperationsOfManySocketsShareSubmissions) {
+    if (!supported()) {
+        return;
+    }
+
+    constexpr size_t kNumSockets = 64;
+    std::vector<int> peerFds;
+    std::vector<std::shared_ptr<IoUringSocket>> sockets;
+    for (size_t i = 0; i < kNumSockets; ++i) {
+        int fds[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+        sockets.push_back(_ring->makeSocket(fds[0]));
+        ::close(fds[0]);
+        peerFds.push_back(fds[1]);
+    }
+
+    std::vector<char> bufs(kNumSockets);
+    std::vector<Future<void>> reads;
+    for (size_t i = 0; i < kNumSockets; ++i) {
+        reads.push_back(sockets[i]->read(&bufs[i], 1));
+        ASSERT_EQ(::write(peerFds[i], "y", 1), 1);
+    }
+    for (auto& read : reads) {
+        ASSERT_OK(read.getNoThrow());
+    }
+
+    auto stats = _ring->getStats();
+    ASSERT_GTE(stats.submitted, static_cast<long long>(kNumSockets));
+    ASSERT_GTE(stats.completions, static_cast<long long>(kNumSockets));
+
+    for (auto fd : peerFds) {
+        ::close(fd);
+    }
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
+
+#endif  // MONGO_HAS_IO_URING
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_buffer_pool.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+const auto getMessageBufferPool = Session::declareDecoration<MessageBufferPool>();
+
+// Process-wide counters, reported under network.messageBuffers in serverStatus.
+AtomicWord<long long> buffersAllocated;
+AtomicWord<long long> buffersReused;
+AtomicWord<long long> buffersRecycled;
+AtomicWord<long long> buffersDiscarded;
+
+}  // namespace
+
+MessageBufferPool::MessageBufferPool() {
+    _buffers.reserve(kMaxCachedBuffers);
+}
+
+MessageBufferPool& MessageBufferPool::get(Session* session) {
+    return getMessageBufferPool(session);
+}
+
+MessageBufferPool& MessageBufferPool::get(const SessionHandle& session) {
+    return get(session.get());
+}
+
+size_t MessageBufferPool::sizeClass(size_t size) {
+    if (size > kMaxBufferSize) {
+        return size;
+    }
+
+    size_t sizeClass = kMinBufferSize;
+    while (sizeClass < size) {
+        sizeClass <<= 1;
+    }
+    return sizeClass;
+}
+
+SharedBuffer MessageBufferPool::allocate(size_t size) {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+
+        // Pick the smallest cached buffer which is large enough, so that a small request doesn't
+        // take the buffer a later large request could have used.
+        auto best = _buffers.end();
+        for (auto it = _buffers.begin(); it != _buffers.end(); ++it) {
+            if (it->capacity() >= size &&
+                (best == _buffers.end() || it->capacity() < best->capacity())) {
+                best = it;
+            }
+        }
+
+        if (best != _buffers.end()) {
+            auto buffer = std::move(*best);
+            *best = std::move(_buffers.back());
+            _buffers.pop_back();
+            buffersReused.fetchAndAddRelaxed(1);
+            return buffer;
+        }
+    }
+
+    buffersAllocated.fetchAndAddRelaxed(1);
+    return SharedBuffer::allocate(sizeClass(size));
+}
+
+void MessageBufferPool::recycle(SharedBuffer buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    if (!buffer.isShared() && buffer.capacity() <= kMaxBufferSize) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_buffers.size() < kMaxCachedBuffers) {
+            _buffers.push_back(std::move(buffer));
+            buffersRecycled.fetchAndAddRelaxed(1);
+            return;
+        }
+    }
+
+    buffersDiscarded.fetchAndAddRelaxed(1);
+}
+
+size_t MessageBufferPool::cachedBuffers() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _buffers.size();
+}
+
+void MessageBufferPool::appendStats(BSONObjBuilder* bob) {
+    BSONObjBuilder section(bob->subobjStart("messageBuffers"));
+    section.append("allocated", buffersAllocated.load());
+    section.append("reused", buffersReused.load());
+    section.append("recycled", buffersRecycled.load());
+    section.append("discarded", buffersDiscarded.load());
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/platform/mutex.h"
+#include "mongo/transport/session.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+namespace transport {
+
+/**
+ * A small cache of message buffers owned by a single Session.
+ *
+ * Requests read off of a session and the replies built for them are usually about the same size
+ * from one request to the next, so instead of returning every buffer to the allocator once a
+ * message has been processed, the buffers are handed back here and reused for the next message on
+ * the same session. Buffers are rounded up to power-of-two size classes so that a buffer released
+ * by one message fits the next message of a similar size.
+ *
+ * Only buffers which are exclusively owned by the caller may be recycled; a buffer which is still
+ * shared with, e.g., a BSONObj kept alive past the end of the request, is simply released.
+ */
+class MessageBufferPool {
+    MessageBufferPool(const MessageBufferPool&) = delete;
+    MessageBufferPool& operator=(const MessageBufferPool&) = delete;
+
+public:
+    static constexpr size_t kMinBufferSize = 512;
+    static constexpr size_t kMaxBufferSize = 64 * 1024;
+    static constexpr size_t kMaxCachedBuffers = 4;
+
+    MessageBufferPool();
+
+    static MessageBufferPool& get(Session* session);
+    static MessageBufferPool& get(const SessionHandle& session);
+
+    /**
+     * Returns the size class a request for 'size' bytes is rounded up to. Sizes above
+     * kMaxBufferSize are not pooled and are returned unchanged.
+     */
+    static size_t sizeClass(size_t size);
+
+    /**
+     * Returns an unshared buffer with a capacity of at least 'size' bytes, reusing a cached buffer
+     * when one is large enough.
+     */
+    SharedBuffer allocate(size_t size);
+
+    /**
+     * Caches 'buffer' for reuse by a later call to allocate(). Buffers which are still shared,
+     * which are too large to pool, or which don't fit in the cache are released.
+     */
+    void recycle(SharedBuffer buffer);
+
+    /**
+     * Returns the number of buffers currently cached by this pool.
+     */
+    size_t cachedBuffers() const;
+
+    /**
+     * Appends the process-wide counters for all pools to 'bob'.
+     */
+    static void appendStats(BSONObjBuilder* bob);
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("MessageBufferPool::_mutex");
+    std::vector<SharedBuffer> _buffers;
+};
+
+}  // namespace transport
+}  // namespace mongo
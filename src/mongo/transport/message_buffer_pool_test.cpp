@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_buffer_pool.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/rpc/op_msg_rpc_impls.h"
+#include "mongo/transport/mock_session.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+long long getCounter(StringData name) {
+    BSONObjBuilder bob;
+    MessageBufferPool::appendStats(&bob);
+    return bob.obj()["messageBuffers"][name].numberLong();
+}
+
+TEST(MessageBufferPool, SizeClassesArePowersOfTwo) {
+    ASSERT_EQ(MessageBufferPool::sizeClass(0), MessageBufferPool::kMinBufferSize);
+    ASSERT_EQ(MessageBufferPool::sizeClass(16), MessageBufferPool::kMinBufferSize);
+    ASSERT_EQ(MessageBufferPool::sizeClass(512), 512u);
+    ASSERT_EQ(MessageBufferPool::sizeClass(513), 1024u);
+    ASSERT_EQ(MessageBufferPool::sizeClass(40 * 1024), 64u * 1024);
+    ASSERT_EQ(MessageBufferPool::sizeClass(MessageBufferPool::kMaxBufferSize),
+              MessageBufferPool::kMaxBufferSize);
+    ASSERT_EQ(MessageBufferPool::sizeClass(MessageBufferPool::kMaxBufferSize + 1),
+              MessageBufferPool::kMaxBufferSize + 1);
+}
+
+TEST(MessageBufferPool, RecycledBufferIsReused) {
+    MessageBufferPool pool;
+
+    auto buffer = pool.allocate(100);
+    ASSERT_EQ(buffer.capacity(), MessageBufferPool::kMinBufferSize);
+    const auto ptr = buffer.get();
+    pool.recycle(std::move(buffer));
+    ASSERT_EQ(pool.cachedBuffers(), 1u);
+
+    const auto allocated = getCounter("allocated");
+    const auto reused = getCounter("reused");
+    auto reusedBuffer = pool.allocate(200);
+    ASSERT_EQ(reusedBuffer.get(), ptr);
+    ASSERT_EQ(pool.cachedBuffers(), 0u);
+    ASSERT_EQ(getCounter("allocated"), allocated);
+    ASSERT_EQ(getCounter("reused"), reused + 1);
+}
+
+TEST(MessageBufferPool, PicksSmallestBufferLargeEnough) {
+    MessageBufferPool pool;
+
+    auto small = pool.allocate(100);
+    auto medium = pool.allocate(1000);
+    auto large = pool.allocate(10000);
+    const auto mediumPtr = medium.get();
+    pool.recycle(std::move(large));
+    pool.recycle(std::move(small));
+    pool.recycle(std::move(medium));
+
+    auto buffer = pool.allocate(600);
+    ASSERT_EQ(buffer.get(), mediumPtr);
+    ASSERT_EQ(pool.cachedBuffers(), 2u);
+}
+
+TEST(MessageBufferPool, SharedBufferIsNotRecycled) {
+    MessageBufferPool pool;
+
+    auto buffer = pool.allocate(100);
+    auto otherOwner = buffer;
+
+    const auto discarded = getCounter("discarded");
+    pool.recycle(std::move(buffer));
+    ASSERT_EQ(pool.cachedBuffers(), 0u);
+    ASSERT_EQ(getCounter("discarded"), discarded + 1);
+}
+
+TEST(MessageBufferPool, OversizedBufferIsNotPooled) {
+    MessageBufferPool pool;
+
+    auto buffer = pool.allocate(MessageBufferPool::kMaxBufferSize + 1);
+    ASSERT_EQ(buffer.capacity(), MessageBufferPool::kMaxBufferSize + 1);
+    pool.recycle(std::move(buffer));
+    ASSERT_EQ(pool.cachedBuffers(), 0u);
+}
+
+TEST(MessageBufferPool, CacheIsBounded) {
+    MessageBufferPool pool;
+
+    std::vector<SharedBuffer> buffers;
+    for (size_t i = 0; i < MessageBufferPool::kMaxCachedBuffers + 2; ++i) {
+        buffers.push_back(pool.allocate(100));
+    }
+    for (auto& buffer : buffers) {
+        pool.recycle(std::move(buffer));
+    }
+    ASSERT_EQ(pool.cachedBuffers(), MessageBufferPool::kMaxCachedBuffers);
+}
+
+TEST(MessageBufferPool, EachSessionHasItsOwnPool) {
+    auto first = MockSession::create(nullptr);
+    auto second = MockSession::create(nullptr);
+
+    MessageBufferPool::get(first).recycle(SharedBuffer::allocate(100));
+    ASSERT_EQ(MessageBufferPool::get(first).cachedBuffers(), 1u);
+    ASSERT_EQ(MessageBufferPool::get(second).cachedBuffers(), 0u);
+}
+
+TEST(MessageBufferPool, SmallCommandRoundTripDoesNotAllocate) {
+    MessageBufferPool pool;
+
+    auto roundTrip = [&] {
+        // The request is read into a pooled buffer...
+        auto requestBuffer = pool.allocate(sizeof(MSGHEADER::Value));
+        auto request = OpMsgRequest::fromDBAndBody("test", BSON("ping" << 1)).serialize();
+        ASSERT_LTE(size_t(request.size()), requestBuffer.capacity());
+        memcpy(requestBuffer.get(), request.buf(), request.size());
+        Message in(std::move(requestBuffer));
+
+        // ...the reply is built in another pooled buffer...
+        rpc::OpMsgReplyBuilder replyBuilder(pool.allocate(BufBuilder::kDefaultInitSizeBytes));
+        replyBuilder.getBodyBuilder().append("ok", 1.0);
+        auto out = replyBuilder.done();
+
+        // ...and both are handed back once the reply has been sent.
+        pool.recycle(out.releaseBuffer());
+        pool.recycle(in.releaseBuffer());
+    };
+
+    roundTrip();
+    ASSERT_EQ(pool.cachedBuffers(), 2u);
+
+    const auto allocated = getCounter("allocated");
+    for (int i = 0; i < 100; ++i) {
+        roundTrip();
+    }
+    ASSERT_EQ(getCounter("allocated"), allocated);
+    ASSERT_EQ(pool.cachedBuffers(), 2u);
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
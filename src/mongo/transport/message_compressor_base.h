@@ -33,6 +33,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
 
 #include <type_traits>
 
@@ -42,6 +43,7 @@ enum class MessageCompressor : uint8_t {
     kSnappy = 1,
     kZlib = 2,
     kZstd = 3,
+    kZstdDictionary = 4,
     kExtended = 255,
 };
 
@@ -56,7 +58,9 @@ public:
     virtual ~MessageCompressorBase() = default;
 
     /*
-     * Returns the name for subclass compressors (e.g. "snappy", "zlib", "zstd" or "noop")
+     * Returns the name for subclass compressors (e.g. "snappy", "zlib", "zstd" or "noop"). This is
+     * the name negotiated with the remote host, which for some compressors also identifies their
+     * configuration (e.g. "zstd-dict-<dictionary id>").
      */
     const std::string& getName() const {
         return _name;
@@ -117,6 +121,46 @@ public:
         return _decompressBytesOut.loadRelaxed();
     }
 
+    /*
+     * This returns the number of messages compressed by compressData
+     */
+    int64_t getCompressorMessages() const {
+        return _compressMessages.loadRelaxed();
+    }
+
+    /*
+     * This returns the number of messages decompressed by decompressData
+     */
+    int64_t getDecompressorMessages() const {
+        return _decompressMessages.loadRelaxed();
+    }
+
+    /*
+     * This returns the total time spent in compressData
+     */
+    Microseconds getCompressorTime() const {
+        return Microseconds{_compressMicros.loadRelaxed()};
+    }
+
+    /*
+     * This returns the total time spent in decompressData
+     */
+    Microseconds getDecompressorTime() const {
+        return Microseconds{_decompressMicros.loadRelaxed()};
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for the time spent in compressData and
+     * decompressData
+     */
+    void counterHitCompressTime(Microseconds elapsed) {
+        _compressMicros.addAndFetch(durationCount<Microseconds>(elapsed));
+    }
+
+    void counterHitDecompressTime(Microseconds elapsed) {
+        _decompressMicros.addAndFetch(durationCount<Microseconds>(elapsed));
+    }
+
 
 protected:
     /*
@@ -126,10 +170,17 @@ protected:
         : _id{static_cast<MessageCompressorId>(id)},
           _name{getMessageCompressorName(id).toString()} {}
 
+    /*
+     * Like above, but negotiates the compressor under 'name' rather than the name of its ID.
+     */
+    MessageCompressorBase(MessageCompressor id, std::string name)
+        : _id{static_cast<MessageCompressorId>(id)}, _name{std::move(name)} {}
+
     /*
      * Called by sub-classes to bump their bytesIn/bytesOut counters for compression
      */
     void counterHitCompress(int64_t bytesIn, int64_t bytesOut) {
+        _compressMessages.addAndFetch(1);
         _compressBytesIn.addAndFetch(bytesIn);
         _compressBytesOut.addAndFetch(bytesOut);
     }
@@ -138,6 +189,7 @@ protected:
      * Called by sub-classes to bump their bytesIn/bytesOut counters for decompression
      */
     void counterHitDecompress(int64_t bytesIn, int64_t bytesOut) {
+        _decompressMessages.addAndFetch(1);
         _decompressBytesIn.addAndFetch(bytesIn);
         _decompressBytesOut.addAndFetch(bytesOut);
     }
@@ -151,5 +203,11 @@ private:
 
     AtomicWord<long long> _decompressBytesIn;
     AtomicWord<long long> _decompressBytesOut;
+
+    AtomicWord<long long> _compressMessages;
+    AtomicWord<long long> _decompressMessages;
+
+    AtomicWord<long long> _compressMicros;
+    AtomicWord<long long> _decompressMicros;
 };
 }  // namespace mongo
@@ -99,7 +99,8 @@ void checkFidelity(const Message& msg, std::unique_ptr<MessageCompressorBase> co
     const auto originalView = msg.singleData();
     const auto compressorName = compressor->getName();
 
-    std::vector<std::string> compressorList = {compressorName};
+    std::vector<std::string> compressorList = {
+        getMessageCompressorName(static_cast<MessageCompressor>(compressor->getId())).toString()};
     registry.setSupportedCompressors(std::move(compressorList));
     registry.registerImplementation(std::move(compressor));
     registry.finalizeSupportedCompressors().transitional_ignore();
@@ -167,6 +168,23 @@ void checkOverflow(std::unique_ptr<MessageCompressorBase> compressor) {
         compressor->decompressData(tooSmallRange, DataRange(scratch.data(), scratch.size())));
 }
 
+std::string buildZstdDictionary() {
+    // Trains on bodies shaped like the commands a driver sends, which share most of their bytes.
+    std::vector<std::string> samples;
+    for (int i = 0; i < 1000; i++) {
+        auto body = BSON("insert"
+                         << "coll"
+                         << "ordered" << true << "$db"
+                         << "test"
+                         << "documents"
+                         << BSON_ARRAY(BSON("_id" << i << "name"
+                                                  << "user" + std::to_string(i) << "score"
+                                                  << i * 7 % 100)));
+        samples.emplace_back(body.objdata(), body.objsize());
+    }
+    return ZstdDictionaryMessageCompressor::trainDictionary(samples, 4096);
+}
+
 Message buildMessage() {
     const auto data = std::string{"Hello, world!"};
     const auto bufferSize = MsgData::MsgDataHeaderSize + data.size();
@@ -240,6 +258,12 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictionaryMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage,
+                  std::make_unique<ZstdDictionaryMessageCompressor>(buildZstdDictionary()));
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<SnappyMessageCompressor>());
 }
@@ -252,6 +276,44 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictionaryMessageCompressor, Overflow) {
+    checkOverflow(std::make_unique<ZstdDictionaryMessageCompressor>(buildZstdDictionary()));
+}
+
+TEST(ZstdDictionaryMessageCompressor, InvalidDictionary) {
+    ASSERT_THROWS_CODE(ZstdDictionaryMessageCompressor("not a dictionary"),
+                       DBException,
+                       ErrorCodes::BadValue);
+}
+
+TEST(ZstdDictionaryMessageCompressor, NamedByDictionary) {
+    const auto dictionary = buildZstdDictionary();
+    ZstdDictionaryMessageCompressor compressor(dictionary);
+    ZstdDictionaryMessageCompressor sameDictionary(dictionary);
+    ASSERT_EQ(compressor.getName(), sameDictionary.getName());
+    ASSERT_NE(compressor.getName(), "zstd-dict");
+    ASSERT_EQ(compressor.getName().find("zstd-dict-"), 0U);
+}
+
+TEST(ZstdDictionaryMessageCompressor, CompressesSmallMessagesBetterThanZstd) {
+    const auto body = BSON("insert"
+                           << "coll"
+                           << "ordered" << true << "$db"
+                           << "test"
+                           << "documents"
+                           << BSON_ARRAY(BSON("_id" << 5000 << "name"
+                                                    << "user5000"
+                                                    << "score" << 42)));
+    ConstDataRange input(body.objdata(), body.objsize());
+
+    ZstdMessageCompressor zstd;
+    ZstdDictionaryMessageCompressor zstdDict(buildZstdDictionary());
+    std::vector<char> buffer(zstd.getMaxCompressedSize(body.objsize()));
+    auto zstdSize = assertOk(zstd.compressData(input, DataRange(buffer.data(), buffer.size())));
+    auto dictSize = assertOk(zstdDict.compressData(input, DataRange(buffer.data(), buffer.size())));
+    ASSERT_LT(dictSize, zstdSize);
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
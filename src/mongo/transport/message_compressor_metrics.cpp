@@ -36,6 +36,14 @@ namespace mongo {
 namespace {
 const auto kBytesIn = "bytesIn"_sd;
 const auto kBytesOut = "bytesOut"_sd;
+const auto kMessages = "messages"_sd;
+const auto kRatio = "ratio"_sd;
+const auto kTimeMicros = "timeMicros"_sd;
+
+// The ratio of uncompressed to compressed bytes, or 0 if nothing was processed.
+double compressionRatio(int64_t uncompressedBytes, int64_t compressedBytes) {
+    return compressedBytes ? static_cast<double>(uncompressedBytes) / compressedBytes : 0;
+}
 }  // namespace
 
 void appendMessageCompressionStats(BSONObjBuilder* b) {
@@ -52,12 +60,22 @@ void appendMessageCompressionStats(BSONObjBuilder* b) {
 
         BSONObjBuilder compressorSection(base.subobjStart("compressor"));
         compressorSection << kBytesIn << compressor->getCompressorBytesIn() << kBytesOut
-                          << compressor->getCompressorBytesOut();
+                          << compressor->getCompressorBytesOut() << kMessages
+                          << compressor->getCompressorMessages() << kRatio
+                          << compressionRatio(compressor->getCompressorBytesIn(),
+                                              compressor->getCompressorBytesOut())
+                          << kTimeMicros
+                          << durationCount<Microseconds>(compressor->getCompressorTime());
         compressorSection.doneFast();
 
         BSONObjBuilder decompressorSection(base.subobjStart("decompressor"));
         decompressorSection << kBytesIn << compressor->getDecompressorBytesIn() << kBytesOut
-                            << compressor->getDecompressorBytesOut();
+                            << compressor->getDecompressorBytesOut() << kMessages
+                            << compressor->getDecompressorMessages() << kRatio
+                            << compressionRatio(compressor->getDecompressorBytesOut(),
+                                                compressor->getDecompressorBytesIn())
+                            << kTimeMicros
+                            << durationCount<Microseconds>(compressor->getDecompressorTime());
         decompressorSection.doneFast();
         base.doneFast();
     }
@@ -57,6 +57,8 @@ StringData getMessageCompressorName(MessageCompressor id) {
             return "zlib"_sd;
         case MessageCompressor::kZstd:
             return "zstd"_sd;
+        case MessageCompressor::kZstdDictionary:
+            return "zstd-dict"_sd;
         default:
             fassert(40269, "Invalid message compressor ID");
     }
@@ -75,10 +77,14 @@ void MessageCompressorRegistry::registerImplementation(
             _compressorsByName.find(impl->getName()) == _compressorsByName.end() &&
                 _compressorsByIds[impl->getId()] == nullptr);
 
-    // Check to see if this compressor is allowed by configuration
-    auto it = std::find(_compressorNames.begin(), _compressorNames.end(), impl->getName());
+    // Check to see if this compressor is allowed by configuration. Compressors are configured by
+    // the name of their ID, but negotiated by their own name, which may identify their settings.
+    auto it = std::find(_compressorNames.begin(),
+                        _compressorNames.end(),
+                        getMessageCompressorName(static_cast<MessageCompressor>(impl->getId())));
     if (it == _compressorNames.end())
         return;
+    *it = impl->getName();
 
     _compressorsByName[impl->getName()] = impl.get();
     _compressorsByIds[impl->getId()] = std::move(impl);
@@ -70,7 +70,8 @@ public:
     /*
      * Registers a new implementation of a MessageCompressor with the registry. This only gets
      * called during startup. It is an error to call this twice with compressors with the same name
-     * or ID numbers.
+     * or ID numbers. The compressor is only registered if the name of its ID is configured, in
+     * which case the configured name is replaced by the compressor's own name.
      *
      * This method is not thread-safe and should only be called from a single-threaded context
      * (a MONGO_INITIALIZER).
@@ -29,15 +29,98 @@
 
 #include "mongo/platform/basic.h"
 
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <vector>
 
+#include <zdict.h>
 #include <zstd.h>
 
 #include "mongo/base/init.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_gen.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
+namespace {
+
+// Setting up a compression or decompression context costs about as much as compressing a small
+// message, so contexts are cached for reuse by later messages. The cache is bounded, so that a
+// burst of concurrent compression doesn't keep its contexts allocated for good.
+template <typename Context, Context* (*createContext)(), size_t (*freeContext)(Context*)>
+class ZstdContextCache {
+public:
+    static constexpr size_t kMaxCachedContexts = 64;
+
+    ~ZstdContextCache() {
+        for (auto context : _contexts) {
+            freeContext(context);
+        }
+    }
+
+    Context* acquire() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (!_contexts.empty()) {
+                auto context = _contexts.back();
+                _contexts.pop_back();
+                return context;
+            }
+        }
+        auto context = createContext();
+        invariant(context);
+        return context;
+    }
+
+    void release(Context* context) {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_contexts.size() < kMaxCachedContexts) {
+                _contexts.push_back(context);
+                return;
+            }
+        }
+        freeContext(context);
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("ZstdContextCache::_mutex");
+    std::vector<Context*> _contexts;
+};
+
+ZstdContextCache<ZSTD_CCtx, ZSTD_createCCtx, ZSTD_freeCCtx> compressionContexts;
+ZstdContextCache<ZSTD_DCtx, ZSTD_createDCtx, ZSTD_freeDCtx> decompressionContexts;
+
+StatusWith<std::size_t> compressResult(size_t ret) {
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    return {ret};
+}
+
+StatusWith<std::size_t> decompressResult(size_t ret) {
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+    }
+    return {ret};
+}
+
+unsigned getDictionaryId(const std::string& dictionary) {
+    auto dictionaryId = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    uassert(ErrorCodes::BadValue,
+            "The zstd compression dictionary is not a trained zstd dictionary",
+            dictionaryId != 0);
+    return dictionaryId;
+}
+
+}  // namespace
 
 ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
 
@@ -47,32 +130,113 @@ std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
 
 StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
                                                             DataRange output) {
-    size_t ret = ZSTD_compress(const_cast<char*>(output.data()),
-                               output.length(),
-                               input.data(),
-                               input.length(),
-                               ZSTD_CLEVEL_DEFAULT);
-
-    if (ZSTD_isError(ret)) {
-        return Status{ErrorCodes::BadValue,
-                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    auto context = compressionContexts.acquire();
+    ON_BLOCK_EXIT([&] { compressionContexts.release(context); });
+    auto ret = compressResult(ZSTD_compressCCtx(context,
+                                                const_cast<char*>(output.data()),
+                                                output.length(),
+                                                input.data(),
+                                                input.length(),
+                                                ZSTD_CLEVEL_DEFAULT));
+    if (ret.isOK()) {
+        counterHitCompress(input.length(), ret.getValue());
     }
-    counterHitCompress(input.length(), ret);
-    return {ret};
+    return ret;
 }
 
 StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
                                                               DataRange output) {
-    size_t ret = ZSTD_decompress(
-        const_cast<char*>(output.data()), output.length(), input.data(), input.length());
+    auto context = decompressionContexts.acquire();
+    ON_BLOCK_EXIT([&] { decompressionContexts.release(context); });
+    auto ret = decompressResult(ZSTD_decompressDCtx(context,
+                                                    const_cast<char*>(output.data()),
+                                                    output.length(),
+                                                    input.data(),
+                                                    input.length()));
+    if (ret.isOK()) {
+        counterHitDecompress(input.length(), ret.getValue());
+    }
+    return ret;
+}
 
-    if (ZSTD_isError(ret)) {
-        return Status{ErrorCodes::BadValue,
-                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+ZstdDictionaryMessageCompressor::ZstdDictionaryMessageCompressor(const std::string& dictionary)
+    : ZstdDictionaryMessageCompressor(dictionary, getDictionaryId(dictionary)) {}
+
+ZstdDictionaryMessageCompressor::ZstdDictionaryMessageCompressor(const std::string& dictionary,
+                                                                 unsigned dictionaryId)
+    : MessageCompressorBase(MessageCompressor::kZstdDictionary,
+                            str::stream()
+                                << getMessageCompressorName(MessageCompressor::kZstdDictionary)
+                                << "-" << dictionaryId),
+      _compressionDictionary(
+          ZSTD_createCDict(dictionary.data(), dictionary.size(), ZSTD_CLEVEL_DEFAULT)),
+      _decompressionDictionary(ZSTD_createDDict(dictionary.data(), dictionary.size())) {
+    invariant(_compressionDictionary && _decompressionDictionary);
+}
+
+ZstdDictionaryMessageCompressor::~ZstdDictionaryMessageCompressor() {
+    ZSTD_freeCDict(_compressionDictionary);
+    ZSTD_freeDDict(_decompressionDictionary);
+}
+
+std::string ZstdDictionaryMessageCompressor::trainDictionary(
+    const std::vector<std::string>& samples, size_t dictionarySize) {
+    std::string concatenatedSamples;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        concatenatedSamples.append(sample);
+        sampleSizes.push_back(sample.size());
     }
 
-    counterHitDecompress(input.length(), ret);
-    return {ret};
+    std::string dictionary(dictionarySize, '\0');
+    auto ret = ZDICT_trainFromBuffer(dictionary.data(),
+                                     dictionary.size(),
+                                     concatenatedSamples.data(),
+                                     sampleSizes.data(),
+                                     sampleSizes.size());
+    uassert(ErrorCodes::OperationFailed,
+            str::stream() << "Could not train a zstd dictionary on " << samples.size()
+                          << " messages: " << ZDICT_getErrorName(ret),
+            !ZDICT_isError(ret));
+    dictionary.resize(ret);
+    return dictionary;
+}
+
+std::size_t ZstdDictionaryMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdDictionaryMessageCompressor::compressData(ConstDataRange input,
+                                                                      DataRange output) {
+    auto context = compressionContexts.acquire();
+    ON_BLOCK_EXIT([&] { compressionContexts.release(context); });
+    auto ret = compressResult(ZSTD_compress_usingCDict(context,
+                                                       const_cast<char*>(output.data()),
+                                                       output.length(),
+                                                       input.data(),
+                                                       input.length(),
+                                                       _compressionDictionary));
+    if (ret.isOK()) {
+        counterHitCompress(input.length(), ret.getValue());
+    }
+    return ret;
+}
+
+StatusWith<std::size_t> ZstdDictionaryMessageCompressor::decompressData(ConstDataRange input,
+                                                                        DataRange output) {
+    auto context = decompressionContexts.acquire();
+    ON_BLOCK_EXIT([&] { decompressionContexts.release(context); });
+    auto ret = decompressResult(ZSTD_decompress_usingDDict(context,
+                                                           const_cast<char*>(output.data()),
+                                                           output.length(),
+                                                           input.data(),
+                                                           input.length(),
+                                                           _decompressionDictionary));
+    if (ret.isOK()) {
+        counterHitDecompress(input.length(), ret.getValue());
+    }
+    return ret;
 }
 
 
@@ -84,4 +248,33 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
     compressorRegistry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
     return Status::OK();
 }
+
+MONGO_INITIALIZER_GENERAL(ZstdDictionaryMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    if (gZstdCompressionDictionaryFile.empty()) {
+        return Status::OK();
+    }
+
+    std::ifstream file(gZstdCompressionDictionaryFile, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return {ErrorCodes::FileNotOpen,
+                str::stream() << "Could not open zstd compression dictionary "
+                              << gZstdCompressionDictionaryFile};
+    }
+    std::stringstream dictionary;
+    dictionary << file.rdbuf();
+
+    try {
+        auto& compressorRegistry = MessageCompressorRegistry::get();
+        compressorRegistry.registerImplementation(
+            std::make_unique<ZstdDictionaryMessageCompressor>(dictionary.str()));
+    } catch (const DBException& ex) {
+        return ex.toStatus().withContext(str::stream() << "Could not load zstd compression "
+                                                       << "dictionary "
+                                                       << gZstdCompressionDictionaryFile);
+    }
+    return Status::OK();
+}
 }  // namespace mongo
@@ -27,8 +27,15 @@
  *    it in the license file.
  */
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "mongo/transport/message_compressor_base.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
@@ -41,5 +48,44 @@ public:
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
 };
 
+/*
+ * A zstd compressor which primes compression with a dictionary trained on sampled traffic (see
+ * mongotrafficreader --trainZstdDictionary). Small messages have too little data of their own for
+ * zstd to find repetitions in, so the dictionary supplies the field names and values such messages
+ * usually share.
+ *
+ * Both hosts must have loaded the same dictionary, so the compressor is negotiated under a name
+ * which includes the ID of its dictionary.
+ */
+class ZstdDictionaryMessageCompressor final : public MessageCompressorBase {
+public:
+    /*
+     * Constructs a compressor from the contents of a dictionary file. Throws if 'dictionary' isn't
+     * a valid zstd dictionary.
+     */
+    explicit ZstdDictionaryMessageCompressor(const std::string& dictionary);
+
+    ~ZstdDictionaryMessageCompressor();
+
+    /*
+     * Trains a dictionary of at most 'dictionarySize' bytes on the message bodies in 'samples'.
+     * Throws if zstd can't build a dictionary from them, e.g. because there are too few.
+     */
+    static std::string trainDictionary(const std::vector<std::string>& samples,
+                                       size_t dictionarySize);
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+private:
+    ZstdDictionaryMessageCompressor(const std::string& dictionary, unsigned dictionaryId);
+
+    ZSTD_CDict_s* _compressionDictionary;
+    ZSTD_DDict_s* _decompressionDictionary;
+};
+
 
 }  // namespace mongo
@@ -132,6 +132,12 @@ Status ServiceEntryPointImpl::start() {
         }
     }
 
+    if (auto exec = transport::ServiceExecutorWorkStealing::get(_svcCtx)) {
+        if (auto status = exec->start(); !status.isOK()) {
+            return status;
+        }
+    }
+
     // TODO: Reintroduce SEF once it is attached as initial SE in SERVER-49109
     // if (auto status = transport::ServiceExecutorFixed::get(_svcCtx)->start(); !status.isOK()) {
     //     return status;
@@ -153,9 +159,13 @@ void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
 
     const bool quiet = serverGlobalParams.quiet.load();
     size_t connectionCount;
-    auto transportMode = transport::ServiceExecutorSynchronous::get(_svcCtx)->transportMode();
+    transport::ServiceExecutor* executor = transport::ServiceExecutorWorkStealing::get(_svcCtx);
+    if (!executor) {
+        executor = transport::ServiceExecutorSynchronous::get(_svcCtx);
+    }
 
-    auto ssm = ServiceStateMachine::create(_svcCtx, session, transportMode);
+    auto ssm = ServiceStateMachine::create(_svcCtx, session, executor->transportMode());
+    ssm->setServiceExecutor(executor);
     auto usingMaxConnOverride = false;
     {
         stdx::lock_guard<decltype(_sessionsMutex)> lk(_sessionsMutex);
@@ -183,6 +193,7 @@ void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
         return;
     } else if (auto exec = transport::ServiceExecutorReserved::get(_svcCtx);
                usingMaxConnOverride && exec) {
+        executor = exec;
         ssm->setServiceExecutor(exec);
     }
 
@@ -215,7 +226,7 @@ void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
     });
 
     auto ownership = ServiceStateMachine::Ownership::kOwned;
-    if (transportMode == transport::Mode::kSynchronous) {
+    if (executor->transportMode() == transport::Mode::kSynchronous) {
         ownership = ServiceStateMachine::Ownership::kStatic;
     }
     ssm->start(ownership);
@@ -296,6 +307,14 @@ bool ServiceEntryPointImpl::shutdown(Milliseconds timeout) {
         }
     }
 
+    timeSpent = _svcCtx->getPreciseClockSource()->now() - start;
+    timeout = std::max(Milliseconds{0}, timeout - timeSpent);
+    if (auto exec = transport::ServiceExecutorWorkStealing::get(_svcCtx)) {
+        if (auto status = exec->shutdown(timeout); !status.isOK()) {
+            LOGV2(5035008, "Failed to shutdown ServiceExecutorWorkStealing", "error"_attr = status);
+        }
+    }
+
     timeSpent = _svcCtx->getPreciseClockSource()->now() - start;
     timeout = std::max(Milliseconds{0}, timeout - timeSpent);
     if (auto status =
@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/transport/service_executor_fixed.h"
+#include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_work_stealing.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Every connection sends this many requests, one after the other, in each benchmark iteration.
+constexpr int kRequestsPerConnection = 32;
+
+/**
+ * Counts down the connections which are still sending requests.
+ */
+class ConnectionsLeft {
+public:
+    explicit ConnectionsLeft(int count) : _count(count) {}
+
+    void onDone() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (--_count == 0) {
+            _cv.notify_all();
+        }
+    }
+
+    void wait() {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cv.wait(lk, [&] { return _count == 0; });
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("ConnectionsLeft::_mutex");
+    stdx::condition_variable _cv;
+    int _count;
+};
+
+/**
+ * A client connection, which sends its next request as soon as it got the reply to the previous
+ * one. The time from scheduling a request until it starts running is its latency.
+ */
+struct Connection {
+    ServiceExecutor* executor;
+    ConnectionsLeft* connectionsLeft;
+    int requestsLeft = kRequestsPerConnection;
+    Clock::time_point scheduledAt;
+    std::vector<int64_t> latencyNanos;
+};
+
+void scheduleRequest(Connection* conn);
+
+void runRequest(Connection* conn) {
+    conn->latencyNanos.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - conn->scheduledAt)
+            .count());
+
+    // Parsing the request and running the command.
+    for (int i = 0; i < 1000; i++) {
+        benchmark::DoNotOptimize(i);
+    }
+
+    if (--conn->requestsLeft > 0) {
+        scheduleRequest(conn);
+    } else {
+        conn->connectionsLeft->onDone();
+    }
+}
+
+void scheduleRequest(Connection* conn) {
+    conn->scheduledAt = Clock::now();
+    invariant(conn->executor->scheduleTask([conn] { runRequest(conn); },
+                                           ServiceExecutor::kEmptyFlags));
+}
+
+/**
+ * Runs requests from 'state.range(0)' concurrent connections, and reports the throughput and the
+ * 99th percentile of the scheduling latency of the requests.
+ */
+void runConnections(benchmark::State& state, ServiceExecutor* executor) {
+    const int numConnections = state.range(0);
+    std::vector<int64_t> latencyNanos;
+
+    for (auto keepRunning : state) {
+        ConnectionsLeft connectionsLeft(numConnections);
+        std::vector<Connection> connections(numConnections);
+        for (auto& conn : connections) {
+            conn.executor = executor;
+            conn.connectionsLeft = &connectionsLeft;
+            conn.latencyNanos.reserve(kRequestsPerConnection);
+            scheduleRequest(&conn);
+        }
+        connectionsLeft.wait();
+
+        for (auto& conn : connections) {
+            latencyNanos.insert(
+                latencyNanos.end(), conn.latencyNanos.begin(), conn.latencyNanos.end());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numConnections * kRequestsPerConnection);
+    if (!latencyNanos.empty()) {
+        auto p99 = latencyNanos.begin() + latencyNanos.size() * 99 / 100;
+        std::nth_element(latencyNanos.begin(), p99, latencyNanos.end());
+        state.counters["p99Micros"] = *p99 / 1000.0;
+    }
+}
+
+void BM_Synchronous(benchmark::State& state) {
+    auto svcCtx = ServiceContext::make();
+    ServiceExecutorSynchronous executor(svcCtx.get());
+    invariant(executor.start());
+
+    runConnections(state, &executor);
+
+    invariant(executor.shutdown(Seconds(10)));
+}
+
+void BM_Fixed(benchmark::State& state) {
+    ThreadPool::Options options;
+    options.minThreads = options.maxThreads = ProcessInfo::getNumAvailableCores();
+    options.poolName = "ServiceExecutorBM";
+    auto executor = std::make_shared<ServiceExecutorFixed>(std::move(options));
+    invariant(executor->start());
+
+    runConnections(state, executor.get());
+
+    invariant(executor->shutdown(Seconds(10)));
+}
+
+void BM_WorkStealing(benchmark::State& state) {
+    auto svcCtx = ServiceContext::make();
+    auto executor = std::make_shared<ServiceExecutorWorkStealing>(
+        svcCtx.get(), ProcessInfo::getNumAvailableCores());
+    invariant(executor->start());
+
+    runConnections(state, executor.get());
+
+    invariant(executor->shutdown(Seconds(10)));
+}
+
+BENCHMARK(BM_Synchronous)->Arg(16)->Arg(256)->Arg(4096)->UseRealTime();
+BENCHMARK(BM_Fixed)->Arg(16)->Arg(256)->Arg(4096)->UseRealTime();
+BENCHMARK(BM_WorkStealing)->Arg(16)->Arg(256)->Arg(4096)->UseRealTime();
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/transport/service_executor_fixed.h"
 #include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_work_stealing.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/barrier.h"
@@ -398,5 +399,181 @@ TEST_F(ServiceExecutorFixedFixture, StartAndShutdownAreDeterministic) {
     shutdownThread.join();
 }
 
+class ServiceExecutorWorkStealingFixture : public unittest::Test {
+protected:
+    static constexpr size_t kNumWorkers = 2;
+
+    void setUp() override {
+        setGlobalServiceContext(ServiceContext::make());
+        executor =
+            std::make_shared<ServiceExecutorWorkStealing>(getGlobalServiceContext(), kNumWorkers);
+    }
+
+    std::shared_ptr<ServiceExecutorWorkStealing> executor;
+};
+
+TEST_F(ServiceExecutorWorkStealingFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, ScheduleFailsAfterShutdown) {
+    ASSERT_OK(executor->start());
+    ASSERT_OK(executor->shutdown(kShutdownTime));
+
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, RecursiveTask) {
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    const auto limit = workStealingServiceExecutorRecursionLimit.load();
+    int depth = 0;
+    boost::optional<stdx::thread::id> threadId;
+
+    // Shut down before destroying the state used by the tasks, which keep running after the
+    // barrier while the recursion unwinds.
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    // Tasks allowed to recurse run inline on the same thread, until the recursion limit is hit.
+    std::function<void()> recursiveTask;
+    recursiveTask = [&, barrier] {
+        ++depth;
+        if (!threadId) {
+            threadId = stdx::this_thread::get_id();
+        }
+        ASSERT(*threadId == stdx::this_thread::get_id());
+
+        if (depth < limit) {
+            ASSERT_OK(executor->scheduleTask(recursiveTask, ServiceExecutor::kMayRecurse));
+            ASSERT_EQ(depth, limit);
+        } else {
+            barrier->countDownAndWait();
+        }
+    };
+
+    ASSERT_OK(executor->scheduleTask(recursiveTask, ServiceExecutor::kMayRecurse));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, IdleWorkerStealsQueuedTask) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    auto stolen = std::make_shared<SharedPromise<stdx::thread::id>>();
+    auto done = std::make_shared<unittest::Barrier>(2);
+
+    // The first task queues the second one on its own worker, and only returns once the second
+    // one ran, so it can only run on the other worker.
+    ASSERT_OK(executor->scheduleTask(
+        [this, stolen, done] {
+            ASSERT_OK(executor->scheduleTask(
+                [stolen] { stolen->emplaceValue(stdx::this_thread::get_id()); },
+                ServiceExecutor::kEmptyFlags));
+            ASSERT(stolen->getFuture().get() != stdx::this_thread::get_id());
+            done->countDownAndWait();
+        },
+        ServiceExecutor::kEmptyFlags));
+    done->countDownAndWait();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(stats.getStringField("executor"), "workStealing"_sd);
+    ASSERT_EQ(stats.getIntField("workers"), static_cast<int>(kNumWorkers));
+    ASSERT_EQ(stats.getIntField("threadsRunning"), static_cast<int>(kNumWorkers));
+    ASSERT_GTE(stats["tasksStolen"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, ManyTasksRunFromManyThreads) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    constexpr int kNumThreads = 8;
+    constexpr int kTasksPerThread = 1000;
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    AtomicWord<int> tasksLeft{kNumThreads * kTasksPerThread};
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+        threads.emplace_back([&, barrier] {
+            for (int j = 0; j < kTasksPerThread; j++) {
+                ASSERT_OK(executor->scheduleTask(
+                    [&, barrier] {
+                        if (tasksLeft.subtractAndFetch(1) == 0) {
+                            barrier->countDownAndWait();
+                        }
+                    },
+                    ServiceExecutor::kEmptyFlags));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, SpareThreadRunsTaskQueuedBehindBlockedWorkers) {
+    const auto stuckTimeout = workStealingServiceExecutorStuckThreadTimeoutMillis.load();
+    workStealingServiceExecutorStuckThreadTimeoutMillis.store(10);
+    ON_BLOCK_EXIT([&] { workStealingServiceExecutorStuckThreadTimeoutMillis.store(stuckTimeout); });
+
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    // Like fsyncLock, every worker blocks until a task which is queued after it runs.
+    auto unblock = std::make_shared<SharedPromise<void>>();
+    auto blocked = std::make_shared<unittest::Barrier>(kNumWorkers + 1);
+    for (size_t i = 0; i < kNumWorkers; i++) {
+        ASSERT_OK(executor->scheduleTask(
+            [unblock, blocked] {
+                blocked->countDownAndWait();
+                unblock->getFuture().get();
+            },
+            ServiceExecutor::kEmptyFlags));
+    }
+    blocked->countDownAndWait();
+
+    ASSERT_OK(executor->scheduleTask([unblock] { unblock->emplaceValue(); },
+                                     ServiceExecutor::kEmptyFlags));
+    unblock->getFuture().get();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(stats.getIntField("workers"), static_cast<int>(kNumWorkers));
+    ASSERT_GTE(stats["spareThreadsStarted"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, RunTaskAfterWaitingForData) {
+    auto tl = std::make_unique<TransportLayerMock>();
+    auto session = tl->createSession();
+
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    const auto mainThreadId = stdx::this_thread::get_id();
+    AtomicWord<bool> ranOnDataAvailable{false};
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    executor->runOnDataAvailable(
+        session.get(), [&ranOnDataAvailable, mainThreadId, barrier](Status) mutable -> void {
+            ranOnDataAvailable.store(true);
+            ASSERT(stdx::this_thread::get_id() != mainThreadId);
+            barrier->countDownAndWait();
+        });
+
+    ASSERT(!ranOnDataAvailable.load());
+    reinterpret_cast<MockSession*>(session.get())->signalAvailableData();
+    barrier->countDownAndWait();
+    ASSERT(ranOnDataAvailable.load());
+}
+
 }  // namespace
 }  // namespace mongo
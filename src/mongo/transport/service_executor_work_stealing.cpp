@@ -0,0 +1,482 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_work_stealing.h"
+
+#include "mongo/logv2/log.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/transport/service_executor_utils.h"
+#include "mongo/transport/session.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "workStealing"_sd;
+constexpr auto kWorkers = "workers"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
+constexpr auto kTasksRunInline = "tasksRunInline"_sd;
+constexpr auto kSpareThreads = "spareThreads"_sd;
+constexpr auto kSpareThreadsStarted = "spareThreadsStarted"_sd;
+
+constexpr auto kSynchronousServiceExecutor = "synchronous"_sd;
+constexpr auto kWorkStealingServiceExecutor = "workStealing"_sd;
+
+const auto getServiceExecutorWorkStealing =
+    ServiceContext::declareDecoration<std::shared_ptr<ServiceExecutorWorkStealing>>();
+
+const auto serviceExecutorWorkStealingRegisterer = ServiceContext::ConstructorActionRegisterer{
+    "ServiceExecutorWorkStealing", [](ServiceContext* ctx) {
+        if (gServiceExecutor != kWorkStealingServiceExecutor) {
+            return;
+        }
+
+        size_t numWorkers = gWorkStealingServiceExecutorThreads;
+        if (!numWorkers) {
+            numWorkers = ProcessInfo::getNumAvailableCores();
+        }
+        getServiceExecutorWorkStealing(ctx) =
+            std::make_shared<ServiceExecutorWorkStealing>(ctx, numWorkers);
+    }};
+}  // namespace
+
+Status validateServiceExecutor(const std::string& name) {
+    if (name != kSynchronousServiceExecutor && name != kWorkStealingServiceExecutor) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "serviceExecutor must be either '" << kSynchronousServiceExecutor
+                              << "' or '" << kWorkStealingServiceExecutor << "'"};
+    }
+    return Status::OK();
+}
+
+ServiceExecutorWorkStealing::ServiceExecutorWorkStealing(ServiceContext* ctx, size_t numWorkers)
+    : _svcCtx(ctx) {
+    invariant(numWorkers > 0);
+    for (size_t i = 0; i < numWorkers; i++) {
+        _workers.push_back(std::make_unique<CacheAligned<Worker>>());
+    }
+}
+
+ServiceExecutorWorkStealing::~ServiceExecutorWorkStealing() {
+    invariant(!_stillRunning.load());
+    invariant(!_reactorThread.joinable());
+    invariant(!_controllerThread.joinable());
+}
+
+ServiceExecutorWorkStealing* ServiceExecutorWorkStealing::get(ServiceContext* ctx) {
+    return getServiceExecutorWorkStealing(ctx).get();
+}
+
+Status ServiceExecutorWorkStealing::start() {
+    _stillRunning.store(true);
+
+    // Nothing else runs the ingress reactor, which completes the asynchronous network operations
+    // of the sessions.
+    if (auto tl = _svcCtx->getTransportLayer()) {
+        _reactor = tl->getReactor(TransportLayer::kIngress);
+        _reactorThread = stdx::thread([this] { _runReactor(); });
+    }
+
+    for (size_t i = 0; i < _workers.size(); i++) {
+        // Count the worker right away, so that shutdown() waits for it even if it has not started
+        // running yet.
+        _numRunningWorkerThreads.addAndFetch(1);
+        auto status = launchServiceWorkerThread([self = shared_from_this(), i] {
+            self->_runWorker(i);
+        });
+        if (!status.isOK()) {
+            _numRunningWorkerThreads.subtractAndFetch(1);
+            return status;
+        }
+    }
+
+    _controllerThread = stdx::thread([this] { _runController(); });
+
+    LOGV2_DEBUG(
+        5035006, 3, "Started work-stealing service executor", "workers"_attr = _workers.size());
+    return Status::OK();
+}
+
+Status ServiceExecutorWorkStealing::shutdown(Milliseconds timeout) {
+    LOGV2_DEBUG(5035007, 3, "Shutting down work-stealing service executor");
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stillRunning.store(false);
+        _controllerCondition.notify_all();
+    }
+    if (_controllerThread.joinable()) {
+        _controllerThread.join();
+    }
+
+    for (auto& worker : _workers) {
+        _wake(*worker);
+    }
+    {
+        stdx::lock_guard<Latch> lk(_spareMutex);
+        _spareCondition.notify_all();
+    }
+
+    if (_reactorThread.joinable()) {
+        // The reactor thread checks '_stillRunning' before every call to run(), and stopping the
+        // reactor makes run() return even if it is called afterwards.
+        _reactor->stop();
+        _reactorThread.join();
+    }
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    bool result = _shutdownCondition.wait_for(lk, timeout.toSystemDuration(), [this]() {
+        return _numRunningWorkerThreads.load() == 0;
+    });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "work-stealing executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorWorkStealing::scheduleTask(Task task, ScheduleFlags flags) {
+    if (!_stillRunning.load()) {
+        return Status{ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    if (_localExecutor != this) {
+        // Scheduled by the reactor, or another thread outside of the executor.
+        const size_t index = _nextWorker.fetchAndAdd(1) % _workers.size();
+        if (!_push(*_workers[index], std::move(task))) {
+            _wakeIdleWorker(index);
+        }
+        return Status::OK();
+    }
+
+    if ((flags & ScheduleFlags::kMayRecurse) &&
+        (_localRecursionDepth < workStealingServiceExecutorRecursionLimit.loadRelaxed())) {
+        ++_localRecursionDepth;
+        ON_BLOCK_EXIT([] { --_localRecursionDepth; });
+        _tasksRunInline.fetchAndAddRelaxed(1);
+        task();
+        return Status::OK();
+    }
+
+    // This thread is busy until the current task returns, so let an idle one take the new task.
+    // Spare threads have no queue of their own.
+    const size_t index = _localWorkerIndex != kSpareWorkerIndex
+        ? _localWorkerIndex
+        : _nextWorker.fetchAndAdd(1) % _workers.size();
+    _push(*_workers[index], std::move(task));
+    _wakeIdleWorker(index);
+    return Status::OK();
+}
+
+void ServiceExecutorWorkStealing::runOnDataAvailable(Session* session,
+                                                     OutOfLineExecutor::Task onCompletionCallback) {
+    invariant(session);
+    session->waitForData().thenRunOn(shared_from_this()).getAsync(std::move(onCompletionCallback));
+}
+
+void ServiceExecutorWorkStealing::appendStats(BSONObjBuilder* bob) const {
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning
+         << static_cast<int>(_numRunningWorkerThreads.loadRelaxed()) << kWorkers
+         << static_cast<int>(_workers.size()) << kSpareThreads
+         << static_cast<int>(_numSpareThreads.loadRelaxed()) << kSpareThreadsStarted
+         << _spareThreadsStarted.loadRelaxed() << kTasksQueued
+         << static_cast<long long>(_numQueued()) << kTasksStolen << _tasksStolen.loadRelaxed()
+         << kTasksRunInline << _tasksRunInline.loadRelaxed();
+}
+
+void ServiceExecutorWorkStealing::_runWorker(size_t index) {
+    setThreadName(str::stream() << "WorkStealingWorker-" << index);
+    _localExecutor = this;
+    _localWorkerIndex = index;
+    ON_BLOCK_EXIT([this] {
+        _localExecutor = nullptr;
+        if (_numRunningWorkerThreads.subtractAndFetch(1) == 0) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _shutdownCondition.notify_all();
+        }
+    });
+
+    auto& worker = *_workers[index];
+    while (_stillRunning.load()) {
+        Task task = _pop(worker);
+        if (!task) {
+            task = _steal(index);
+        }
+
+        if (task) {
+            _localRecursionDepth = 1;
+            worker.tasksStarted.fetchAndAddRelaxed(1);
+            worker.running.store(true);
+            task();
+            worker.running.store(false);
+            continue;
+        }
+
+        // Once the worker is marked idle, workers queueing tasks will wake it up. Look for work
+        // once more before waiting, in case some was queued before they could see it.
+        stdx::unique_lock<Latch> lk(worker.mutex);
+        worker.idle.store(true);
+        _numIdleWorkers.addAndFetch(1);
+        ON_BLOCK_EXIT([&] {
+            worker.wakeRequested = false;
+            worker.idle.store(false);
+            _numIdleWorkers.subtractAndFetch(1);
+        });
+
+        if (_numQueued()) {
+            continue;
+        }
+
+        worker.cv.wait(lk, [&] {
+            return worker.wakeRequested || !worker.queue.empty() || !_stillRunning.load();
+        });
+    }
+}
+
+void ServiceExecutorWorkStealing::_runSpareWorker() {
+    setThreadName("WorkStealingSpareWorker");
+    _localExecutor = this;
+    _localWorkerIndex = kSpareWorkerIndex;
+    ON_BLOCK_EXIT([this] {
+        _localExecutor = nullptr;
+        _numSpareThreads.subtractAndFetch(1);
+        if (_numRunningWorkerThreads.subtractAndFetch(1) == 0) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _shutdownCondition.notify_all();
+        }
+    });
+
+    size_t nextVictim = _nextWorker.fetchAndAdd(1);
+    while (_stillRunning.load()) {
+        if (Task task = _stealAny(nextVictim++)) {
+            _localRecursionDepth = 1;
+            task();
+            continue;
+        }
+
+        // Like the workers, look for work once more after being counted as idle, since tasks
+        // queued before then did not try to wake this thread up.
+        stdx::unique_lock<Latch> lk(_spareMutex);
+        _numIdleSpares.addAndFetch(1);
+        ON_BLOCK_EXIT([&] { _numIdleSpares.subtractAndFetch(1); });
+        if (_numQueued()) {
+            continue;
+        }
+
+        const auto idleTimeout =
+            Milliseconds(workStealingServiceExecutorSpareThreadIdleTimeoutMillis.load());
+        if (!_spareCondition.wait_for(lk, idleTimeout.toSystemDuration(), [&] {
+                return _spareWakeupsRequested > 0 || !_stillRunning.load();
+            })) {
+            LOGV2_DEBUG(5035016, 3, "Stopping idle spare thread of work-stealing service executor");
+            return;
+        }
+
+        if (_spareWakeupsRequested > 0) {
+            --_spareWakeupsRequested;
+        }
+    }
+}
+
+void ServiceExecutorWorkStealing::_runReactor() {
+    setThreadName("WorkStealingReactor");
+    while (_stillRunning.load()) {
+        _reactor->run();
+    }
+}
+
+void ServiceExecutorWorkStealing::_runController() {
+    setThreadName("WorkStealingController");
+
+    // The number of tasks each worker had started the last time around. A worker which is still
+    // running and has not started another task since has been running the same one for at least a
+    // whole period.
+    std::vector<unsigned long long> lastTasksStarted(_workers.size(), 0);
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    while (_stillRunning.load()) {
+        const auto period =
+            Milliseconds(workStealingServiceExecutorStuckThreadTimeoutMillis.load());
+        _controllerCondition.wait_for(
+            lk, period.toSystemDuration(), [&] { return !_stillRunning.load(); });
+
+        size_t numStuck = 0;
+        for (size_t i = 0; i < _workers.size(); i++) {
+            auto& worker = *_workers[i];
+            const auto tasksStarted = worker.tasksStarted.load();
+            if (worker.running.load() && tasksStarted == lastTasksStarted[i]) {
+                ++numStuck;
+            }
+            lastTasksStarted[i] = tasksStarted;
+        }
+
+        // Tasks left queued while no thread is idle may be the ones which would unblock the stuck
+        // workers, as fsyncUnlock does for fsyncLock, so they must not wait for them.
+        const size_t numQueued = _numQueued();
+        if (!numStuck || !numQueued || _numIdleWorkers.load() || _numIdleSpares.load()) {
+            continue;
+        }
+
+        const size_t numToStart = std::min(numStuck, numQueued);
+        LOGV2_DEBUG(5035017,
+                    2,
+                    "Starting spare threads for work-stealing service executor",
+                    "stuckWorkers"_attr = numStuck,
+                    "tasksQueued"_attr = numQueued,
+                    "spareThreadsToStart"_attr = numToStart);
+        for (size_t i = 0; i < numToStart; i++) {
+            _startSpareWorker();
+        }
+    }
+}
+
+void ServiceExecutorWorkStealing::_startSpareWorker() {
+    if (!_stillRunning.load()) {
+        return;
+    }
+
+    _numRunningWorkerThreads.addAndFetch(1);
+    _numSpareThreads.addAndFetch(1);
+    auto status =
+        launchServiceWorkerThread([self = shared_from_this()] { self->_runSpareWorker(); });
+    if (!status.isOK()) {
+        LOGV2_WARNING(5035018,
+                      "Failed to start a spare thread for work-stealing service executor",
+                      "error"_attr = status);
+        _numSpareThreads.subtractAndFetch(1);
+        _numRunningWorkerThreads.subtractAndFetch(1);
+        return;
+    }
+    _spareThreadsStarted.fetchAndAddRelaxed(1);
+}
+
+bool ServiceExecutorWorkStealing::_push(Worker& worker, Task task) {
+    stdx::lock_guard<Latch> lk(worker.mutex);
+    worker.queue.push_back(std::move(task));
+    worker.queued.store(worker.queue.size());
+    if (!worker.idle.load()) {
+        return false;
+    }
+
+    worker.wakeRequested = true;
+    worker.cv.notify_one();
+    return true;
+}
+
+ServiceExecutor::Task ServiceExecutorWorkStealing::_pop(Worker& worker) {
+    if (!worker.queued.load()) {
+        return {};
+    }
+
+    stdx::lock_guard<Latch> lk(worker.mutex);
+    if (worker.queue.empty()) {
+        return {};
+    }
+    Task task = std::move(worker.queue.front());
+    worker.queue.pop_front();
+    worker.queued.store(worker.queue.size());
+    return task;
+}
+
+ServiceExecutor::Task ServiceExecutorWorkStealing::_stealAny(size_t startIndex) {
+    for (size_t i = 0; i < _workers.size(); i++) {
+        auto& victim = *_workers[(startIndex + i) % _workers.size()];
+        if (auto task = _pop(victim)) {
+            _tasksStolen.fetchAndAddRelaxed(1);
+            return task;
+        }
+    }
+    return {};
+}
+
+size_t ServiceExecutorWorkStealing::_numQueued() const {
+    size_t numQueued = 0;
+    for (const auto& worker : _workers) {
+        numQueued += worker->queued.load();
+    }
+    return numQueued;
+}
+
+ServiceExecutor::Task ServiceExecutorWorkStealing::_steal(size_t thiefIndex) {
+    for (size_t i = 1; i < _workers.size(); i++) {
+        auto& victim = *_workers[(thiefIndex + i) % _workers.size()];
+        if (auto task = _pop(victim)) {
+            _tasksStolen.fetchAndAddRelaxed(1);
+            return task;
+        }
+    }
+    return {};
+}
+
+void ServiceExecutorWorkStealing::_wakeIdleWorker(size_t exceptIndex) {
+    if (_numIdleWorkers.load()) {
+        for (size_t i = 1; i < _workers.size(); i++) {
+            auto& worker = *_workers[(exceptIndex + i) % _workers.size()];
+            if (!worker.idle.load()) {
+                continue;
+            }
+
+            stdx::lock_guard<Latch> lk(worker.mutex);
+            if (worker.idle.load() && !worker.wakeRequested) {
+                worker.wakeRequested = true;
+                worker.cv.notify_one();
+                return;
+            }
+        }
+    }
+
+    if (!_numIdleSpares.load()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_spareMutex);
+    if (_spareWakeupsRequested < _numIdleSpares.load()) {
+        ++_spareWakeupsRequested;
+        _spareCondition.notify_one();
+    }
+}
+
+void ServiceExecutorWorkStealing::_wake(Worker& worker) {
+    stdx::lock_guard<Latch> lk(worker.mutex);
+    worker.wakeRequested = true;
+    worker.cv.notify_one();
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * Validates the "serviceExecutor" server parameter.
+ */
+Status validateServiceExecutor(const std::string& name);
+
+/**
+ * Runs all connections asynchronously on one worker thread per core, instead of a thread per
+ * connection. Every worker has its own run queue. Tasks scheduled by a worker go to its own queue,
+ * others are spread over the workers round-robin, and idle workers steal tasks from the queues of
+ * busy ones.
+ *
+ * Sessions are only scheduled once they have data available: the executor runs the transport
+ * layer's ingress reactor on a thread of its own, which completes the asynchronous network
+ * operations of the sessions and hands their continuations to the workers.
+ *
+ * Commands run synchronously on the workers, and some of them block, e.g. while waiting for a lock,
+ * for new data or for a topology change, or until a later command releases them as fsyncUnlock
+ * does for fsyncLock. So that they can't stall every session, a controller thread checks whether
+ * workers have been running the same task for longer than
+ * workStealingServiceExecutorStuckThreadTimeoutMillis while tasks are queued and no thread is idle.
+ * It then starts a spare thread for each stuck worker, up to the number of queued tasks. Spare
+ * threads steal tasks from the workers' queues, and exit once they have been idle for
+ * workStealingServiceExecutorSpareThreadIdleTimeoutMillis.
+ *
+ * Only used if the "serviceExecutor" server parameter is set to "workStealing".
+ */
+class ServiceExecutorWorkStealing final
+    : public ServiceExecutor,
+      public std::enable_shared_from_this<ServiceExecutorWorkStealing> {
+public:
+    ServiceExecutorWorkStealing(ServiceContext* ctx, size_t numWorkers);
+    ~ServiceExecutorWorkStealing();
+
+    /**
+     * Returns the executor of the ServiceContext, or nullptr if it is not enabled.
+     */
+    static ServiceExecutorWorkStealing* get(ServiceContext* ctx);
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status scheduleTask(Task task, ScheduleFlags flags) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void runOnDataAvailable(Session* session,
+                            OutOfLineExecutor::Task onCompletionCallback) override;
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    size_t numWorkers() const {
+        return _workers.size();
+    }
+
+private:
+    struct Worker {
+        Mutex mutex = MONGO_MAKE_LATCH("ServiceExecutorWorkStealing::Worker::mutex");
+        stdx::condition_variable cv;
+        std::deque<Task> queue;
+
+        // The size of 'queue', for other workers looking for tasks to steal without locking.
+        AtomicWord<size_t> queued{0};
+
+        // Set while the worker waits for tasks, with 'mutex' held until it waits on 'cv'.
+        AtomicWord<bool> idle{false};
+        bool wakeRequested = false;
+
+        // Set while the worker runs a task, and counts the tasks it started, for the controller to
+        // tell when the worker is stuck running the same task.
+        AtomicWord<bool> running{false};
+        AtomicWord<unsigned long long> tasksStarted{0};
+    };
+
+    void _runWorker(size_t index);
+    void _runSpareWorker();
+    void _runReactor();
+    void _runController();
+
+    /**
+     * Launches a spare thread, unless the executor is shutting down.
+     */
+    void _startSpareWorker();
+
+    /**
+     * Queues the task on the worker, and returns whether the worker was idle and woken up for it.
+     */
+    bool _push(Worker& worker, Task task);
+    Task _pop(Worker& worker);
+    Task _steal(size_t thiefIndex);
+
+    /**
+     * Returns a task from the queue of any worker, starting with the worker at 'startIndex'.
+     */
+    Task _stealAny(size_t startIndex);
+
+    size_t _numQueued() const;
+
+    /**
+     * Wakes up one idle worker, other than 'exceptIndex', or else an idle spare thread, to steal
+     * the work which was just queued.
+     */
+    void _wakeIdleWorker(size_t exceptIndex);
+    void _wake(Worker& worker);
+
+    ServiceContext* const _svcCtx;
+
+    AtomicWord<bool> _stillRunning{false};
+    AtomicWord<size_t> _nextWorker{0};
+    AtomicWord<size_t> _numIdleWorkers{0};
+
+    AtomicWord<size_t> _numRunningWorkerThreads{0};
+    AtomicWord<long long> _tasksStolen{0};
+    AtomicWord<long long> _tasksRunInline{0};
+
+    AtomicWord<size_t> _numSpareThreads{0};
+    AtomicWord<long long> _spareThreadsStarted{0};
+
+    // Idle spare threads all wait on '_spareCondition'. '_numIdleSpares' is only modified with
+    // '_spareMutex' held, but can be read without it.
+    Mutex _spareMutex = MONGO_MAKE_LATCH("ServiceExecutorWorkStealing::_spareMutex");
+    stdx::condition_variable _spareCondition;
+    AtomicWord<size_t> _numIdleSpares{0};
+    size_t _spareWakeupsRequested = 0;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ServiceExecutorWorkStealing::_mutex");
+    stdx::condition_variable _shutdownCondition;
+    stdx::condition_variable _controllerCondition;
+
+    std::vector<std::unique_ptr<CacheAligned<Worker>>> _workers;
+
+    ReactorHandle _reactor;
+    stdx::thread _reactorThread;
+    stdx::thread _controllerThread;
+
+    static inline thread_local ServiceExecutorWorkStealing* _localExecutor = nullptr;
+    // The index of the worker running on this thread, or kSpareWorkerIndex on spare threads.
+    static constexpr size_t kSpareWorkerIndex = std::numeric_limits<size_t>::max();
+    static inline thread_local size_t _localWorkerIndex = 0;
+    static inline thread_local int _localRecursionDepth = 0;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -43,9 +43,11 @@
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
+#include "mongo/transport/message_buffer_pool.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_state_machine_gen.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
@@ -318,6 +320,12 @@ void ServiceStateMachine::_sourceMessage(ThreadGuard guard) {
     guard.release();
 
     auto sourceMsgImpl = [&] {
+        if (_readAhead) {
+            // The message was already requested while the previous request was processed.
+            auto readAhead = std::move(*_readAhead);
+            _readAhead.reset();
+            return readAhead;
+        }
         if (_transportMode == transport::Mode::kSynchronous) {
             MONGO_IDLE_THREAD_BLOCK;
             return Future<Message>::makeReady(_session()->sourceMessage());
@@ -339,6 +347,7 @@ void ServiceStateMachine::_sourceMessage(ThreadGuard guard) {
 void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
     // Sink our response to the client
     invariant(_state.load() == State::Process);
+    invariant(!_readAhead);
     _state.store(State::SinkWait);
     guard.release();
 
@@ -441,6 +450,11 @@ void ServiceStateMachine::_sinkCallback(Status status) {
     }
 }
 
+void ServiceStateMachine::_recycleInMessage() {
+    // The buffer is only reused if nothing from the request outlived its processing.
+    transport::MessageBufferPool::get(_session()).recycle(_inMessage.releaseBuffer());
+}
+
 void ServiceStateMachine::_processMessage(ThreadGuard guard) {
     invariant(!_inMessage.empty());
 
@@ -460,6 +474,15 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
     networkCounter.hitLogicalIn(_inMessage.size());
 
+    // A fire-and-forget request gets no reply, so a client streaming them has likely sent the next
+    // message already. Start reading it now, so it is ready by the time this request completes.
+    if (_transportMode == transport::Mode::kAsynchronous &&
+        OpMsg::isFlagSet(_inMessage, OpMsg::kMoreToCome) &&
+        gPipelineFireAndForgetRequests.load()) {
+        invariant(!_readAhead);
+        _readAhead = _session()->asyncSourceMessage();
+    }
+
     // Pass sourced Message to handler to generate response.
     auto opCtx = Client::getCurrent()->makeOperationContext();
     if (_inExhaust) {
@@ -505,8 +528,10 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
                 // request, as if we sourced a new message from the network. This new request is
                 // sent to the database once again to be processed. This cycle repeats as long as
                 // the command indicates the exhaust stream should continue.
-                _inMessage = makeExhaustMessage(_inMessage, &dbresponse);
-                _inExhaust = !_inMessage.empty();
+                auto exhaustMessage = makeExhaustMessage(_inMessage, &dbresponse);
+                _inExhaust = !exhaustMessage.empty();
+                _recycleInMessage();
+                _inMessage = std::move(exhaustMessage);
 
                 networkCounter.hitLogicalOut(toSink.size());
 
@@ -524,7 +549,7 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
             } else {
                 _state.store(State::Source);
-                _inMessage.reset();
+                _recycleInMessage();
                 _inExhaust = false;
                 return _scheduleNextWithGuard(std::move(guard), ServiceExecutor::kDeferredTask);
             }
@@ -593,6 +618,7 @@ void ServiceStateMachine::start(Ownership ownershipModel) {
 
 void ServiceStateMachine::setServiceExecutor(ServiceExecutor* executor) {
     _serviceExecutor = executor;
+    _transportMode = executor->transportMode();
 }
 
 void ServiceStateMachine::_scheduleNextWithGuard(ThreadGuard guard,
@@ -694,6 +720,14 @@ void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
 
     _cleanupExhaustResources();
 
+    if (_readAhead) {
+        // The session must outlive the read started on it, so end the session to fail the read
+        // promptly and wait for it before letting go of the session below.
+        _session()->end();
+        std::move(*_readAhead).getNoThrow().getStatus().ignore();
+        _readAhead.reset();
+    }
+
     _state.store(State::Ended);
 
     _inMessage.reset();
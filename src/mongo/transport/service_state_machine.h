@@ -128,7 +128,8 @@ public:
 
     /*
      * Set the executor to be used for the next call to runNext(). This allows switching between
-     * thread models after the SSM has started.
+     * thread models after the SSM has started. Networking switches to the transport mode of the
+     * executor.
      */
     void setServiceExecutor(transport::ServiceExecutor* executor);
 
@@ -201,6 +202,12 @@ private:
      */
     inline void _processMessage(ThreadGuard guard);
 
+    /*
+     * Hands the buffer of the request just processed back to the session's MessageBufferPool and
+     * leaves _inMessage empty.
+     */
+    void _recycleInMessage();
+
     /*
      * These get called by the TransportLayer when requested network I/O has completed.
      */
@@ -242,6 +249,9 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // The next message, requested while a fire-and-forget request is being processed.
+    boost::optional<Future<Message>> _readAhead;
+
     // Allows delegating destruction of opCtx to another function to potentially remove its cost
     // from the critical path. This is currently only used in `_processMessage()`.
     ServiceContext::UniqueOperationContext _killedOpCtx;
@@ -36,6 +36,8 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/message_buffer_pool.h"
 #include "mongo/transport/ssl_connection_context.h"
 #include "mongo/transport/transport_layer_asio.h"
 #include "mongo/util/fail_point.h"
@@ -112,6 +114,11 @@ public:
 
         _local = HostAndPort(_localAddr.toString(true));
         _remote = HostAndPort(_remoteAddr.toString(true));
+#ifdef MONGO_HAS_IO_URING
+        if (_isIngressSession && tl->_ioUring) {
+            _ioUringSocket = tl->_ioUring->makeSocket(_socket.native_handle());
+        }
+#endif
 #ifdef MONGO_CONFIG_SSL
         _sslContext = transientSSLContext ? transientSSLContext : *tl->_sslContext;
         if (transientSSLContext) {
@@ -181,6 +188,10 @@ public:
     }
 
     Future<void> waitForData() override {
+#ifdef MONGO_HAS_IO_URING
+        if (_ioUringSocket)
+            return _ioUringSocket->waitForData();
+#endif
 #ifdef MONGO_CONFIG_SSL
         if (_sslSocket)
             return asio::async_read(*_sslSocket, asio::null_buffers(), UseFuture{}).ignoreValue();
@@ -196,6 +207,7 @@ public:
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
                 }
+                MessageBufferPool::get(this).recycle(message.releaseBuffer());
             })
             .getNoThrow();
     }
@@ -203,10 +215,11 @@ public:
     Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
         ensureAsync();
         return write(asio::buffer(message.buf(), message.size()), baton)
-            .then([this, message /*keep the buffer alive*/]() {
+            .then([this, message /*keep the buffer alive*/]() mutable {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
                 }
+                MessageBufferPool::get(this).recycle(message.releaseBuffer());
             });
     }
 
@@ -216,6 +229,12 @@ public:
                     "Cancelling outstanding I/O operations on connection to {remote}",
                     "Cancelling outstanding I/O operations on connection to remote",
                     "remote"_attr = _remote);
+#ifdef MONGO_HAS_IO_URING
+        if (_ioUringSocket) {
+            _ioUringSocket->cancel();
+            return;
+        }
+#endif
         if (baton && baton->networking() && baton->networking()->cancelSession(*this)) {
             // If we have a baton, it was for networking, and it owned our session, then we're done.
             return;
@@ -329,6 +348,12 @@ protected:
 #endif
 
     void ensureSync() {
+#ifdef MONGO_HAS_IO_URING
+        if (_ioUringSocket) {
+            // Operations on the ring never block the socket, and don't honor socket timeouts.
+            return;
+        }
+#endif
         asio::error_code ec;
         if (_blockingMode != Sync) {
             getSocket().non_blocking(false, ec);
@@ -419,7 +444,9 @@ private:
     Future<Message> sourceMessageImpl(const BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
-        auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
+        // Read the header straight into a pooled buffer, so that the body of most messages can
+        // follow it without a second allocation or a copy.
+        auto headerBuffer = MessageBufferPool::get(this).allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
             .then([headerBuffer = std::move(headerBuffer), this, baton]() mutable {
@@ -451,8 +478,13 @@ private:
                     return Future<Message>::makeReady(Message(std::move(headerBuffer)));
                 }
 
-                auto buffer = SharedBuffer::allocate(msgLen);
-                memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
+                auto buffer = std::move(headerBuffer);
+                if (buffer.capacity() < msgLen) {
+                    auto& pool = MessageBufferPool::get(this);
+                    auto largerBuffer = pool.allocate(msgLen);
+                    memcpy(largerBuffer.get(), buffer.get(), kHeaderSize);
+                    pool.recycle(std::exchange(buffer, std::move(largerBuffer)));
+                }
 
                 MsgData::View msgView(buffer.get());
                 return read(asio::buffer(msgView.data(), msgView.dataLen()), baton)
@@ -468,6 +500,11 @@ private:
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
+#ifdef MONGO_HAS_IO_URING
+        if (_ioUringSocket) {
+            return _ioUringSocket->read(buffers.data(), buffers.size());
+        }
+#endif
 #ifdef MONGO_CONFIG_SSL
         if (_sslSocket) {
             return opportunisticRead(*_sslSocket, buffers, baton);
@@ -494,6 +531,11 @@ private:
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
+#ifdef MONGO_HAS_IO_URING
+        if (_ioUringSocket) {
+            return _ioUringSocket->write(buffers.data(), buffers.size());
+        }
+#endif
 #ifdef MONGO_CONFIG_SSL
         _ranHandshake = true;
         if (_sslSocket) {
@@ -825,6 +867,9 @@ private:
     boost::optional<Milliseconds> _socketTimeout;
 
     GenericSocket _socket;
+    // Set for unencrypted ingress sessions when the transport layer uses io_uring, which then
+    // performs all the reads and writes.
+    std::shared_ptr<IoUringSocket> _ioUringSocket;
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
     bool _ranHandshake = false;
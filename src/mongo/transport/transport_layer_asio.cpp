@@ -1091,6 +1091,10 @@ Status TransportLayerASIO::start() {
     invariant(!_isShutdown);
 
     if (_listenerOptions.isIngress()) {
+        if (gIoUringIngress) {
+            _startIoUring();
+        }
+
         _listener.thread = stdx::thread([this] { _runListener(); });
         _listener.cv.wait(lk, [&] { return _isShutdown || _listener.active; });
         return Status::OK();
@@ -1129,6 +1133,46 @@ void TransportLayerASIO::shutdown() {
     // Release the lock and wait for the thread to die
     lk.unlock();
     thread.join();
+
+#ifdef MONGO_HAS_IO_URING
+    // Fails the I/O of the sessions which are still open.
+    if (_ioUring) {
+        _ioUring->shutdown();
+    }
+#endif
+}
+
+void TransportLayerASIO::_startIoUring() {
+#ifdef MONGO_HAS_IO_URING
+#ifdef MONGO_CONFIG_SSL
+    // TLS handshakes and encryption run through ASIO.
+    if (_sslMode() != SSLParams::SSLMode_disabled) {
+        LOGV2_WARNING(5035011, "Not using io_uring for inbound connections, as TLS is enabled");
+        return;
+    }
+#endif
+
+    IoUring::Options options;
+    options.queueDepth = gIoUringQueueDepth;
+    options.numBuffers = gIoUringBufferCount;
+    auto swRing = IoUring::make(options);
+    if (!swRing.isOK()) {
+        LOGV2_WARNING(5035012,
+                      "Not using io_uring for inbound connections, as it is unavailable",
+                      "error"_attr = swRing.getStatus());
+        return;
+    }
+
+    _ioUring = std::move(swRing.getValue());
+    _ioUring->start();
+    LOGV2(5035013,
+          "Using io_uring for inbound connections",
+          "queueDepth"_attr = options.queueDepth,
+          "buffers"_attr = options.numBuffers);
+#else
+    LOGV2_WARNING(5035014,
+                  "Not using io_uring for inbound connections, as this build doesn't support it");
+#endif
 }
 
 ReactorHandle TransportLayerASIO::getReactor(WhichReactor which) {
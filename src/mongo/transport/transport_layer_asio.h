@@ -69,6 +69,8 @@ class ServiceEntryPoint;
 
 namespace transport {
 
+class IoUring;
+
 // This fail point simulates reads and writes that always return 1 byte and fail with EAGAIN
 extern FailPoint transportLayerASIOshortOpportunisticReadWrite;
 
@@ -194,6 +196,12 @@ private:
 
     void _runListener() noexcept;
 
+    /**
+     * Sets up the io_uring instance which ingress sessions use for their network I/O, unless
+     * io_uring is unavailable or TLS is enabled.
+     */
+    void _startIoUring();
+
 #ifdef MONGO_CONFIG_SSL
     SSLParams::SSLModes _sslMode() const;
 #endif
@@ -230,6 +238,9 @@ private:
     synchronized_value<std::shared_ptr<const SSLConnectionContext>> _sslContext;
 #endif
 
+    // Only set when ingress sessions use io_uring rather than ASIO for their network I/O.
+    std::shared_ptr<IoUring> _ioUring;
+
     std::vector<std::pair<SockAddr, GenericAcceptor>> _acceptors;
 
     // Only used if _listenerOptions.async is false.
@@ -43,6 +43,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_work_stealing.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
 #include "mongo/util/net/ssl_types.h"
@@ -136,7 +137,9 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     auto sep = ctx->getServiceEntryPoint();
 
     transport::TransportLayerASIO::Options opts(config);
-    opts.transportMode = transport::Mode::kSynchronous;
+    opts.transportMode = transport::ServiceExecutorWorkStealing::get(ctx)
+        ? transport::Mode::kAsynchronous
+        : transport::Mode::kSynchronous;
 
     std::vector<std::unique_ptr<TransportLayer>> retVector;
     retVector.emplace_back(std::make_unique<transport::TransportLayerASIO>(opts, sep));
@@ -27,236 +27,273 @@
  *    it in the license file.
  */
 
-#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
-
 #include "mongo/platform/basic.h"
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
 
-#include "mongo/logv2/log.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
-
-#if defined(__linux__)
 namespace {
 
-/**
- * Accepts an errno code, prints its error message, and exits.
- */
-void failWithErrno(int err) {
-    LOGV2_FATAL(28604,
-                "error in Ticketholder: {errnoWithDescription_err}",
-                "errnoWithDescription_err"_attr = errnoWithDescription(err));
-}
+const auto getTicketAdmission = OperationContext::declareDecoration<TicketAdmission>();
 
-/*
- * Checks the return value from a Linux semaphore function call, and fails with the set errno if the
- * call was unsucessful.
- */
-void check(int ret) {
-    if (ret == 0)
-        return;
-    failWithErrno(errno);
-}
+// The number of tickets that may go to higher priority waiters before the oldest waiter of a
+// lower priority queue is served anyway.
+constexpr int kMaxBypasses = 16;
 
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
+const char* priorityName(int priority) {
+    switch (static_cast<TicketAdmission::Priority>(priority)) {
+        case TicketAdmission::Priority::kLow:
+            return "low";
+        case TicketAdmission::Priority::kNormal:
+            return "normal";
+        case TicketAdmission::Priority::kHigh:
+            return "high";
+    }
+    MONGO_UNREACHABLE;
 }
+
 }  // namespace
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
-    check(sem_init(&_sem, 0, num));
+TicketAdmission& TicketAdmission::get(OperationContext* opCtx) {
+    return getTicketAdmission(opCtx);
 }
 
+TicketHolder::TicketHolder(int num) : _outof(num) {}
+
 TicketHolder::~TicketHolder() {
-    check(sem_destroy(&_sem));
+    invariant(_numWaiters == 0);
 }
 
 bool TicketHolder::tryAcquire() {
-    while (0 != sem_trywait(&_sem)) {
-        if (errno == EAGAIN)
-            return false;
-        if (errno != EINTR)
-            failWithErrno(errno);
-    }
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    // Do not jump ahead of operations which are already queued.
+    if (_numWaiters > 0 || _used >= _outof)
+        return false;
+    _used++;
+    _numAdmitted++;
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::waitForTicket(OperationContext* opCtx, const TicketAdmission& admission) {
+    waitForTicketUntil(opCtx, Date_t::max(), admission);
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      const TicketAdmission& admission) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    Queue& queue = _queueFor(_queues, admission.priority);
+
+    if (_numWaiters == 0 && _used < _outof) {
+        _used++;
+        _numAdmitted++;
+        queue.admittedImmediately++;
         return true;
     }
 
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
+    Timer timer;
+    Waiter waiter(admission);
+    _enqueue(lk, &waiter);
+
+    // If the wait ends without a ticket, leave the queue. A ticket which was granted after the
+    // deadline passed or the operation was interrupted is passed on to the next waiter.
+    auto leaveQueue = makeGuard([&] {
+        if (!waiter.granted) {
+            _remove(lk, &waiter);
+            return;
         }
+        _used--;
+        _grantAvailable(lk);
+    });
+
+    bool granted;
+    try {
+        auto isGranted = [&] { return waiter.granted; };
+        if (opCtx) {
+            granted = opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, isGranted);
+        } else {
+            granted = waiter.cv.wait_until(lk, until.toSystemTimePoint(), isGranted);
+        }
+    } catch (const DBException&) {
+        queue.interrupted++;
+        throw;
+    }
 
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
+    if (!granted) {
+        queue.timedOut++;
+        return false;
     }
+
+    leaveQueue.dismiss();
+    _numAdmitted++;
+    queue.admittedAfterWait++;
+    _recordWait(lk, queue, Microseconds(timer.micros()));
     return true;
 }
 
 void TicketHolder::release() {
-    check(sem_post(&_sem));
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(_used > 0);
+    _used--;
+    _grantAvailable(lk);
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_resizeMutex);
+    stdx::lock_guard<Latch> lk(_mutex);
 
     if (newSize < 5)
         return Status(ErrorCodes::BadValue,
                       str::stream() << "Minimum value for semaphore is 5; given " << newSize);
 
-    if (newSize > SEM_VALUE_MAX)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Maximum value for semaphore is " << SEM_VALUE_MAX
-                                    << "; given " << newSize);
-
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
-    }
-
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
-    }
-
-    invariant(_outof.load() == newSize);
+    _outof = newSize;
+    _grantAvailable(lk);
     return Status::OK();
 }
 
 int TicketHolder::available() const {
-    int val = 0;
-    check(sem_getvalue(&_sem, &val));
-    return val;
+    stdx::lock_guard<Latch> lk(_mutex);
+    return std::max(_outof - _used, 0);
 }
 
 int TicketHolder::used() const {
-    return outof() - available();
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _used;
 }
 
 int TicketHolder::outof() const {
-    return _outof.load();
-}
-
-#else
-
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
-
-TicketHolder::~TicketHolder() = default;
-
-bool TicketHolder::tryAcquire() {
     stdx::lock_guard<Latch> lk(_mutex);
-    return _tryAcquire();
+    return _outof;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<Latch> lk(_mutex);
+void TicketHolder::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
 
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    for (int priority = TicketAdmission::kNumPriorities - 1; priority >= 0; priority--) {
+        const Queue& queue = _queues[priority];
+        BSONObjBuilder queueBuilder(builder->subobjStart(priorityName(priority)));
+        queueBuilder.append("waiting", queue.numWaiters);
+        queueBuilder.append("tenantsWaiting", static_cast<int>(queue.tenants.size()));
+        queueBuilder.append("admittedImmediately", queue.admittedImmediately);
+        queueBuilder.append("admittedAfterWait", queue.admittedAfterWait);
+        queueBuilder.append("timedOut", queue.timedOut);
+        queueBuilder.append("interrupted", queue.interrupted);
+        queueBuilder.append("totalWaitMicros", queue.totalWaitMicros);
+
+        BSONObjBuilder histogramBuilder(queueBuilder.subobjStart("waitTimeHistogram"));
+        for (size_t i = 0; i < kWaitBucketMicros.size(); i++) {
+            histogramBuilder.append(str::stream() << "lt" << kWaitBucketMicros[i] << "us",
+                                    queue.waitHistogram[i]);
+        }
+        histogramBuilder.append(str::stream() << "ge" << kWaitBucketMicros.back() << "us",
+                                queue.waitHistogram.back());
     }
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<Latch> lk(_mutex);
+TicketHolder::Totals TicketHolder::getTotals() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    Totals totals;
+    totals.admitted = _numAdmitted;
+    totals.totalWaitMicros = _totalWaitMicros;
+    totals.waiting = _numWaiters;
+    return totals;
+}
 
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+void TicketHolder::_enqueue(WithLock, Waiter* waiter) {
+    Queue& queue = _queueFor(_queues, waiter->admission.priority);
+    auto [it, inserted] = queue.tenants.try_emplace(waiter->admission.tenant);
+    if (inserted) {
+        it->second.pass = queue.virtualTime;
     }
+    it->second.waiters.push_back(waiter);
+    queue.numWaiters++;
+    _numWaiters++;
 }
 
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<Latch> lk(_mutex);
-        _num++;
+void TicketHolder::_remove(WithLock, Waiter* waiter) {
+    Queue& queue = _queueFor(_queues, waiter->admission.priority);
+    auto it = queue.tenants.find(waiter->admission.tenant);
+    invariant(it != queue.tenants.end());
+
+    auto& waiters = it->second.waiters;
+    auto pos = std::find(waiters.begin(), waiters.end(), waiter);
+    invariant(pos != waiters.end());
+    waiters.erase(pos);
+    if (waiters.empty()) {
+        queue.tenants.erase(it);
     }
-    _newTicket.notify_one();
+    queue.numWaiters--;
+    _numWaiters--;
 }
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<Latch> lk(_mutex);
+TicketHolder::Waiter* TicketHolder::_popNext(WithLock lk) {
+    invariant(_numWaiters > 0);
 
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
+    // Serve the lowest priority queue which has been passed over too many times, and otherwise
+    // the highest priority queue with waiters.
+    int chosen = -1;
+    for (int priority = 0; priority < TicketAdmission::kNumPriorities; priority++) {
+        if (_queues[priority].numWaiters > 0 && _queues[priority].timesBypassed >= kMaxBypasses) {
+            chosen = priority;
+            break;
+        }
+    }
+    if (chosen < 0) {
+        for (int priority = TicketAdmission::kNumPriorities - 1; priority >= 0; priority--) {
+            if (_queues[priority].numWaiters > 0) {
+                chosen = priority;
+                break;
+            }
+        }
+    }
 
-        std::string errmsg = ss.str();
-        LOGV2(23120, "{errmsg}", "errmsg"_attr = errmsg);
-        return Status(ErrorCodes::BadValue, errmsg);
+    for (int priority = 0; priority < TicketAdmission::kNumPriorities; priority++) {
+        if (priority == chosen) {
+            _queues[priority].timesBypassed = 0;
+        } else if (priority < chosen && _queues[priority].numWaiters > 0) {
+            _queues[priority].timesBypassed++;
+        }
     }
 
-    _outof.store(newSize);
-    _num = _outof.load() - used;
+    Queue& queue = _queues[chosen];
+    auto next = std::min_element(
+        queue.tenants.begin(), queue.tenants.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.pass < rhs.second.pass;
+        });
+    invariant(next != queue.tenants.end());
 
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
-    return Status::OK();
-}
+    Tenant& tenant = next->second;
+    Waiter* waiter = tenant.waiters.front();
+    queue.virtualTime = tenant.pass;
+    tenant.pass += 1.0 / std::max(waiter->admission.weight, 1);
 
-int TicketHolder::available() const {
-    return _num;
+    _remove(lk, waiter);
+    return waiter;
 }
 
-int TicketHolder::used() const {
-    return outof() - _num;
+void TicketHolder::_grantAvailable(WithLock lk) {
+    while (_numWaiters > 0 && _used < _outof) {
+        Waiter* waiter = _popNext(lk);
+        waiter->granted = true;
+        _used++;
+        waiter->cv.notify_one();
+    }
 }
 
-int TicketHolder::outof() const {
-    return _outof.load();
-}
+void TicketHolder::_recordWait(WithLock, Queue& queue, Microseconds waited) {
+    const auto micros = durationCount<Microseconds>(waited);
+    queue.totalWaitMicros += micros;
+    _totalWaitMicros += micros;
 
-bool TicketHolder::_tryAcquire() {
-    if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
-        return false;
-    }
-    _num--;
-    return true;
+    auto bucket = std::upper_bound(kWaitBucketMicros.begin(), kWaitBucketMicros.end(), micros);
+    queue.waitHistogram[bucket - kWaitBucketMicros.begin()]++;
 }
-#endif
+
 }  // namespace mongo
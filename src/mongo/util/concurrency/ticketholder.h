@@ -28,19 +28,50 @@
  */
 #pragma once
 
-#if defined(__linux__)
-#include <semaphore.h>
-#endif
+#include <array>
+#include <deque>
+#include <map>
+#include <string>
 
 #include "mongo/db/operation_context.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * Describes how an operation competes with others for tickets when none are available.
+ */
+struct TicketAdmission {
+    enum class Priority { kLow = 0, kNormal = 1, kHigh = 2 };
+    static constexpr int kNumPriorities = 3;
+
+    static TicketAdmission& get(OperationContext* opCtx);
+
+    Priority priority = Priority::kNormal;
+
+    // Waiters with the same priority are served round-robin across tenants, with each tenant
+    // getting tickets in proportion to the weight of its waiters.
+    std::string tenant;
+    int weight = 1;
+};
+
+/**
+ * A counting semaphore which hands tickets to its waiters in order of priority rather than in
+ * the order they happen to wake up.
+ *
+ * Each priority has its own queue. A ticket which becomes available goes to the highest priority
+ * waiter, except that a waiter in a lower priority queue is served after that queue has been
+ * passed over a fixed number of times, so that low priority work is slowed rather than starved.
+ * Within a queue, tenants take turns by stride scheduling, and each tenant's waiters are served
+ * in FIFO order.
+ */
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
@@ -56,7 +87,7 @@ public:
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx, const TicketAdmission& admission = {});
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -68,12 +99,18 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            const TicketAdmission& admission = {});
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
     void release();
 
+    /**
+     * Changes the number of tickets. When shrinking, tickets already handed out are not taken
+     * back, so used() can exceed outof() until enough of them are released.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -82,22 +119,90 @@ public:
 
     int outof() const;
 
+    /**
+     * Appends, for each priority, how many operations are waiting and how long the operations
+     * admitted so far had to wait.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Counters summed over every priority. 'admitted' and 'totalWaitMicros' only ever grow.
+     */
+    struct Totals {
+        long long admitted = 0;
+        long long totalWaitMicros = 0;
+        int waiting = 0;
+    };
+    Totals getTotals() const;
+
 private:
-#if defined(__linux__)
-    mutable sem_t _sem;
-
-    // You can read _outof without a lock, but have to hold _resizeMutex to change.
-    AtomicWord<int> _outof;
-    Mutex _resizeMutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_resizeMutex");
-#else
-    bool _tryAcquire();
-
-    AtomicWord<int> _outof;
-    int _num;
-    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
-    stdx::condition_variable _newTicket;
-#endif
+    // Upper bounds of the wait time histogram buckets. The last bucket holds every longer wait.
+    static constexpr std::array<int64_t, 5> kWaitBucketMicros = {
+        100, 1000, 10000, 100000, 1000000};
+
+    struct Waiter {
+        explicit Waiter(const TicketAdmission& admission) : admission(admission) {}
+
+        const TicketAdmission& admission;
+        bool granted = false;
+        stdx::condition_variable cv;
+    };
+
+    struct Tenant {
+        std::deque<Waiter*> waiters;
+        // The tenant's position in the stride schedule. The tenant with the lowest pass is next.
+        double pass = 0;
+    };
+
+    struct Queue {
+        // Tenants with at least one waiter.
+        std::map<std::string, Tenant> tenants;
+        int numWaiters = 0;
+
+        // The pass of the last tenant served. Tenants which start waiting begin from here, so
+        // that time spent idle does not build up credit.
+        double virtualTime = 0;
+
+        // The number of tickets handed to higher priority waiters while this queue had waiters.
+        int timesBypassed = 0;
+
+        long long admittedImmediately = 0;
+        long long admittedAfterWait = 0;
+        long long timedOut = 0;
+        long long interrupted = 0;
+        long long totalWaitMicros = 0;
+        std::array<long long, kWaitBucketMicros.size() + 1> waitHistogram{};
+    };
+
+    static Queue& _queueFor(std::array<Queue, TicketAdmission::kNumPriorities>& queues,
+                            TicketAdmission::Priority priority) {
+        return queues[static_cast<int>(priority)];
+    }
+
+    void _enqueue(WithLock, Waiter* waiter);
+    void _remove(WithLock, Waiter* waiter);
+
+    /**
+     * Removes and returns the waiter that should get the next ticket. There must be one.
+     */
+    Waiter* _popNext(WithLock);
+
+    /**
+     * Hands out tickets to waiters while there are both.
+     */
+    void _grantAvailable(WithLock);
+
+    void _recordWait(WithLock, Queue& queue, Microseconds waited);
+
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
+
+    int _outof;
+    int _used = 0;
+    int _numWaiters = 0;
+    long long _numAdmitted = 0;
+    long long _totalWaitMicros = 0;
+    std::array<Queue, TicketAdmission::kNumPriorities> _queues;
 };
 
 class ScopedTicket {
@@ -32,12 +32,78 @@
 
 #include "mongo/platform/basic.h"
 
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
 
+BSONObj queueStats(const TicketHolder& holder, StringData priority) {
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    return builder.obj()[priority].Obj().getOwned();
+}
+
+void waitUntilWaiting(const TicketHolder& holder, StringData priority, int numWaiting) {
+    while (queueStats(holder, priority)["waiting"].numberInt() < numWaiting) {
+        sleepmillis(1);
+    }
+}
+
+/**
+ * Starts threads which each wait for a ticket with the given admission, record their name once
+ * they have it and give it back.
+ */
+class TicketOrderRecorder {
+public:
+    explicit TicketOrderRecorder(TicketHolder* holder) : _holder(holder) {}
+
+    ~TicketOrderRecorder() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void startWaiter(std::string name, TicketAdmission admission) {
+        _threads.emplace_back([this, name = std::move(name), admission = std::move(admission)] {
+            _holder->waitForTicket(nullptr, admission);
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                _order.push_back(name);
+            }
+            _holder->release();
+        });
+    }
+
+    std::vector<std::string> joinAndGetOrder() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+        _threads.clear();
+        return _order;
+    }
+
+private:
+    TicketHolder* _holder;
+    std::vector<stdx::thread> _threads;
+    Mutex _mutex = MONGO_MAKE_LATCH("TicketOrderRecorder::_mutex");
+    std::vector<std::string> _order;
+};
+
+TicketAdmission makeAdmission(TicketAdmission::Priority priority, std::string tenant = "") {
+    TicketAdmission admission;
+    admission.priority = priority;
+    admission.tenant = std::move(tenant);
+    return admission;
+}
+
 TEST(TicketholderTest, BasicTimeout) {
     TicketHolder holder(1);
     ASSERT_EQ(holder.used(), 0);
@@ -72,4 +138,106 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, HigherPriorityWaitersGoFirst) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    TicketOrderRecorder recorder(&holder);
+    recorder.startWaiter("low", makeAdmission(TicketAdmission::Priority::kLow));
+    waitUntilWaiting(holder, "low", 1);
+    recorder.startWaiter("normal", makeAdmission(TicketAdmission::Priority::kNormal));
+    waitUntilWaiting(holder, "normal", 1);
+    recorder.startWaiter("high", makeAdmission(TicketAdmission::Priority::kHigh));
+    waitUntilWaiting(holder, "high", 1);
+
+    holder.release();
+
+    std::vector<std::string> expected{"high", "normal", "low"};
+    ASSERT(recorder.joinAndGetOrder() == expected);
+    ASSERT_EQ(holder.used(), 0);
+
+    ASSERT_EQ(queueStats(holder, "high")["admittedAfterWait"].numberLong(), 1);
+    ASSERT_EQ(queueStats(holder, "low")["admittedAfterWait"].numberLong(), 1);
+}
+
+TEST(TicketholderTest, TenantsTakeTurns) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    const auto normal = TicketAdmission::Priority::kNormal;
+    TicketOrderRecorder recorder(&holder);
+    recorder.startWaiter("a1", makeAdmission(normal, "a"));
+    waitUntilWaiting(holder, "normal", 1);
+    recorder.startWaiter("a2", makeAdmission(normal, "a"));
+    waitUntilWaiting(holder, "normal", 2);
+    recorder.startWaiter("a3", makeAdmission(normal, "a"));
+    waitUntilWaiting(holder, "normal", 3);
+    recorder.startWaiter("b1", makeAdmission(normal, "b"));
+    waitUntilWaiting(holder, "normal", 4);
+    recorder.startWaiter("b2", makeAdmission(normal, "b"));
+    waitUntilWaiting(holder, "normal", 5);
+
+    holder.release();
+
+    std::vector<std::string> expected{"a1", "b1", "a2", "b2", "a3"};
+    ASSERT(recorder.joinAndGetOrder() == expected);
+    ASSERT_EQ(holder.used(), 0);
+}
+
+TEST(TicketholderTest, ShrinkingTakesEffectAsTicketsAreReleased) {
+    TicketHolder holder(6);
+    for (int i = 0; i < 6; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    TicketOrderRecorder recorder(&holder);
+    recorder.startWaiter("waiter", {});
+    waitUntilWaiting(holder, "normal", 1);
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(holder.used(), 6);
+    ASSERT_EQ(holder.available(), 0);
+
+    holder.release();
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_EQ(queueStats(holder, "normal")["waiting"].numberInt(), 1);
+
+    holder.release();
+    recorder.joinAndGetOrder();
+    ASSERT_EQ(holder.used(), 4);
+    ASSERT_EQ(holder.available(), 1);
+}
+
+TEST(TicketholderTest, WaitStats) {
+    TicketHolder holder(1);
+    ASSERT(holder.waitForTicketUntil(Date_t::now()));
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+    holder.release();
+
+    auto stats = queueStats(holder, "normal");
+    ASSERT_EQ(stats["waiting"].numberInt(), 0);
+    ASSERT_EQ(stats["admittedImmediately"].numberLong(), 1);
+    ASSERT_EQ(stats["admittedAfterWait"].numberLong(), 0);
+    ASSERT_EQ(stats["timedOut"].numberLong(), 1);
+
+    TicketOrderRecorder recorder(&holder);
+    ASSERT(holder.tryAcquire());
+    recorder.startWaiter("waiter", {});
+    waitUntilWaiting(holder, "normal", 1);
+    sleepmillis(2);
+    holder.release();
+    recorder.joinAndGetOrder();
+
+    stats = queueStats(holder, "normal");
+    ASSERT_EQ(stats["admittedAfterWait"].numberLong(), 1);
+    ASSERT_GTE(stats["totalWaitMicros"].numberLong(), 2000);
+
+    long long waits = 0;
+    for (auto&& bucket : stats["waitTimeHistogram"].Obj()) {
+        waits += bucket.numberLong();
+    }
+    ASSERT_EQ(waits, 1);
+    ASSERT_EQ(stats["waitTimeHistogram"]["lt100us"].numberLong(), 0);
+}
 }  // namespace